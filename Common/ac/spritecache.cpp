@@ -14,6 +14,7 @@
 #include "ac/spritecache.h"
 #include "ac/gamestructdefines.h"
 #include "debug/out.h"
+#include "debug/profiler.h"
 #include "gfx/bitmap.h"
 #include "platform/platform.h"
 #include "util/memory_compat.h"
@@ -304,6 +305,7 @@ void SpriteCache::PrecacheSprite(sprkey_t index)
 
 std::unique_ptr<Bitmap> SpriteCache::LoadSpriteNoCache(sprkey_t index)
 {
+    AGS_PROFILE_ZONE("SpriteCache::LoadSpriteNoCache");
     // invalid sprite slot
     assert(index >= 0); // out of positive range indexes are valid to fail
     if (!DoesSpriteExist(index) || _spriteData[index].IsError())
@@ -367,6 +369,7 @@ size_t SpriteCache::CalcSize(const std::unique_ptr<Bitmap> &item)
 
 Bitmap *SpriteCache::LoadSprite(sprkey_t index, bool lock)
 {
+    AGS_PROFILE_ZONE("SpriteCache::LoadSprite");
     assert((index >= 0) && ((size_t)index < _spriteData.size()));
     if (index < 0 || (size_t)index >= _spriteData.size())
         return nullptr;
@@ -488,10 +491,19 @@ HError SpriteCache::InitFile(std::unique_ptr<Stream> &&sprite_file,
 {
     Reset();
 
+    SpriteFile file;
     std::vector<Size> metrics;
-    HError err = _file.OpenFile(std::move(sprite_file), std::move(index_file), metrics);
+    HError err = file.OpenFile(std::move(sprite_file), std::move(index_file), metrics);
     if (!err)
         return err;
+    InitFile(std::move(file), metrics);
+    return HError::None();
+}
+
+void SpriteCache::InitFile(SpriteFile &&file, const std::vector<Size> &metrics)
+{
+    Reset();
+    _file = std::move(file);
 
     // Initialize sprite infos
     size_t newsize = metrics.size();
@@ -517,7 +529,6 @@ HError SpriteCache::InitFile(std::unique_ptr<Stream> &&sprite_file,
     }
 
     _topmostSprite = TraceTopmostSpriteBack();
-    return HError::None();
 }
 
 void SpriteCache::DetachFile()
@@ -93,6 +93,9 @@ public:
     // Loads sprite reference information and inits sprite stream
     HError      InitFile(std::unique_ptr<Stream> &&sprite_file,
                          std::unique_ptr<Stream> &&index_file);
+    // Inits sprite stream from the sprite file which was opened beforehand,
+    // using the sprite metrics reported by SpriteFile::OpenFile
+    void        InitFile(SpriteFile &&file, const std::vector<Size> &metrics);
     // Saves current cache contents to the file
     HError      SaveToFile(const String &filename, int store_flags, SpriteCompression compress, SpriteFileIndex &index);
     // Saves current cache contents to the provided stream
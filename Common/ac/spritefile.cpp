@@ -28,6 +28,13 @@ namespace Common
 
 const char *spriteFileSig = " Sprite File ";
 const char *spindexid = "SPRINDEX";
+const char *spindexcacheid = "SPRCACHE";
+// Index cache header: id, version, sprite file's size and time
+const size_t SpriteIndexCacheHeaderSize = 8 + sizeof(int32_t) + 2 * sizeof(int64_t);
+// Sprite index header: id, version, sprite file ID, last slot, number of slots
+const size_t SpriteIndexHeaderSize = 8 + 4 * sizeof(int32_t);
+// Sprite index entry of the current version: width, height, offset
+const size_t SpriteIndexEntrySize = 2 * sizeof(int16_t) + sizeof(int64_t);
 
 // TODO: should not be part of SpriteFile, but rather some asset management class?
 const String SpriteFile::DefaultSpriteFileName = "acsprset.spr";
@@ -177,6 +184,11 @@ SpriteFile::SpriteFile()
     _curPos = -2;
 }
 
+void SpriteFile::SetIndexCacheFile(const String &filename)
+{
+    _indexCacheFile = filename;
+}
+
 HError SpriteFile::OpenFile(std::unique_ptr<Stream> &&sprite_file,
     std::unique_ptr<Stream> &&index_file)
 {
@@ -252,6 +264,12 @@ HError SpriteFile::OpenFileImpl(std::unique_ptr<Stream> &&sprite_file,
     if (_version < kSprfVersion_Uncompressed)
         topmost = 200;
 
+    // The sprite metrics are required for writing index cache
+    std::vector<Size> cache_metrics;
+    const bool use_cache = !_indexCacheFile.IsEmpty() && !metrics2;
+    if (use_cache && !metrics)
+        metrics = &cache_metrics;
+
     _spriteData.resize(topmost + 1);
     if (metrics)
         metrics->resize(topmost + 1);
@@ -277,8 +295,25 @@ HError SpriteFile::OpenFileImpl(std::unique_ptr<Stream> &&sprite_file,
         return HError::None();
     }
 
+    // Otherwise try the index cache, which is keyed by the sprite file's size and time
+    soff_t sprfile_size = 0;
+    int64_t sprfile_time = 0;
+    if (use_cache)
+    {
+        sprfile_size = _stream->GetLength();
+        sprfile_time = File::GetFileTime(_stream->GetPath());
+        if (LoadSpriteIndexCache(spriteFileID, topmost, sprfile_size, sprfile_time, metrics))
+            return HError::None();
+    }
+
     // Failed, index file is invalid; index sprites manually
-    return RebuildSpriteIndex(_stream.get(), topmost, metrics, metrics2);
+    HError err = RebuildSpriteIndex(_stream.get(), topmost, metrics, metrics2);
+    if (!err)
+        return err;
+    // Write the rebuilt index into cache; failing to do so is not critical
+    if (use_cache)
+        SaveSpriteIndexCache(spriteFileID, sprfile_size, sprfile_time, *metrics);
+    return HError::None();
 }
 
 void SpriteFile::Close()
@@ -390,6 +425,80 @@ bool SpriteFile::LoadSpriteIndexFile(std::unique_ptr<Stream> &&fidx,
     return true;
 }
 
+bool SpriteFile::LoadSpriteIndexCache(int expectedFileID, sprkey_t topmost,
+    soff_t sprfile_size, int64_t sprfile_time, std::vector<Size> *metrics)
+{
+    auto in = File::OpenFileRead(_indexCacheFile);
+    if (!in)
+        return false;
+    // A cache interrupted while writing may have a valid header,
+    // so test that it has all the sprite entries
+    const soff_t expect_len = SpriteIndexCacheHeaderSize + SpriteIndexHeaderSize
+        + static_cast<soff_t>(topmost + 1) * SpriteIndexEntrySize;
+    if (in->GetLength() != expect_len)
+        return false;
+
+    char buffer[9];
+    // check "SPRCACHE" id
+    in->ReadArray(&buffer[0], strlen(spindexcacheid), 1);
+    buffer[8] = 0;
+    if (strcmp(buffer, spindexcacheid))
+        return false;
+    SpriteIndexCacheVersion vers = (SpriteIndexCacheVersion)in->ReadInt32();
+    if (vers < kSpridxCacheVersion_Initial || vers > kSpridxCacheVersion_Current)
+        return false;
+    // check that the cache was made for this exact sprite file
+    if (in->ReadInt64() != sprfile_size)
+        return false;
+    if (in->ReadInt64() != sprfile_time)
+        return false;
+    // the rest is same as the sprite index file
+    return LoadSpriteIndexFile(std::move(in), expectedFileID, topmost, metrics);
+}
+
+static void WriteSpriteIndex(Stream *out, const SpriteFileIndex &index);
+
+HError SpriteFile::SaveSpriteIndexCache(int spriteFileID, soff_t sprfile_size, int64_t sprfile_time,
+    const std::vector<Size> &metrics)
+{
+    SpriteFileIndex index;
+    index.SpriteFileIDCheck = spriteFileID;
+    index.Widths.resize(_spriteData.size());
+    index.Heights.resize(_spriteData.size());
+    index.Offsets.resize(_spriteData.size());
+    for (size_t i = 0; i < _spriteData.size(); ++i)
+    {
+        // NOTE: empty slots are written with zero offset, same as by SpriteFileWriter
+        if (!_spriteData[i].HasImage)
+            continue;
+        index.Widths[i] = static_cast<int16_t>(metrics[i].Width);
+        index.Heights[i] = static_cast<int16_t>(metrics[i].Height);
+        index.Offsets[i] = _spriteData[i].Offset;
+    }
+
+    // Write into a temporary file first, so that the cache is never left
+    // incomplete, if the program is terminated while writing
+    const String tmp_file = String::FromFormat("%s.tmp", _indexCacheFile.GetCStr());
+    auto out = File::CreateFile(tmp_file);
+    if (!out)
+        return new Error("Failed to open a output file for writing");
+    out->WriteArray(spindexcacheid, strlen(spindexcacheid), 1);
+    out->WriteInt32(kSpridxCacheVersion_Current);
+    out->WriteInt64(sprfile_size);
+    out->WriteInt64(sprfile_time);
+    WriteSpriteIndex(out.get(), index);
+    const soff_t expect_len = SpriteIndexCacheHeaderSize + SpriteIndexHeaderSize
+        + static_cast<soff_t>(index.GetCount()) * SpriteIndexEntrySize;
+    const bool write_ok = out->Flush() && (out->GetLength() == expect_len);
+    out.reset();
+    if (!write_ok || !File::ReplaceFile(tmp_file, _indexCacheFile))
+    {
+        File::DeleteFile(tmp_file);
+        return new Error("Failed to write the sprite index cache");
+    }
+    return HError::None();
+}
+
 static inline void ReadSprHeader(SpriteDatHeader &hdr, Stream *in,
     const SpriteFileVersion ver, SpriteCompression gl_compress)
 {
@@ -706,12 +815,8 @@ HError SaveSpriteFile(std::unique_ptr<Stream>&& out,
     return HError::None();
 }
 
-HError SaveSpriteIndex(const String &filename, const SpriteFileIndex &index)
+static void WriteSpriteIndex(Stream *out, const SpriteFileIndex &index)
 {
-    // write the sprite index file
-    auto out = File::CreateFile(filename);
-    if (!out)
-        return new Error("Failed to open a output file for writing");
     // write "SPRINDEX" id
     out->WriteArray(spindexid, strlen(spindexid), 1);
     // write version
@@ -727,6 +832,15 @@ HError SaveSpriteIndex(const String &filename, const SpriteFileIndex &index)
         out->WriteArrayOfInt16(index.Heights.data(), index.Heights.size());
         out->WriteArrayOfInt64(index.Offsets.data(), index.Offsets.size());
     }
+}
+
+HError SaveSpriteIndex(const String &filename, const SpriteFileIndex &index)
+{
+    // write the sprite index file
+    auto out = File::CreateFile(filename);
+    if (!out)
+        return new Error("Failed to open a output file for writing");
+    WriteSpriteIndex(out.get(), index);
     return HError::None();
 }
 
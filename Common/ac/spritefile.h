@@ -48,6 +48,12 @@ enum SpriteFileVersion
     kSprfVersion_Current = kSprfVersion_StorageFormats
 };
 
+enum SpriteIndexCacheVersion
+{
+    kSpridxCacheVersion_Initial = 1,
+    kSpridxCacheVersion_Current = kSpridxCacheVersion_Initial
+};
+
 enum SpriteIndexFileVersion
 {
     kSpridxfVersion_Initial = 1,
@@ -132,6 +138,13 @@ public:
     static const String DefaultSpriteIndexName;
 
     SpriteFile();
+    // Assigns the sprite index cache file. If the sprite index file is
+    // missing or does not match the sprite file, then the index is read
+    // from the cache instead; if the cache is not valid either, then the
+    // rebuilt index is written to the cache for the next time.
+    // The cache is matched with the sprite file by its size, modification
+    // time and the sprite file ID.
+    void        SetIndexCacheFile(const String &filename);
     // Loads sprite reference information and inits sprite stream
     HError      OpenFile(std::unique_ptr<Stream> &&sprite_file,
                          std::unique_ptr<Stream> &&index_file);
@@ -173,6 +186,12 @@ private:
     // Loads sprite index file
     bool        LoadSpriteIndexFile(std::unique_ptr<Stream> &&index_file,
                         int expectedFileID, sprkey_t topmost, std::vector<Size> *metrics);
+    // Loads sprite index from the cache file, if the cache matches the sprite file
+    bool        LoadSpriteIndexCache(int expectedFileID, sprkey_t topmost,
+                        soff_t sprfile_size, int64_t sprfile_time, std::vector<Size> *metrics);
+    // Writes current sprite index into the cache file
+    HError      SaveSpriteIndexCache(int spriteFileID, soff_t sprfile_size, int64_t sprfile_time,
+                        const std::vector<Size> &metrics);
     // Rebuilds sprite index from the main sprite file
     HError      RebuildSpriteIndex(Stream *in, sprkey_t topmost,
                         std::vector<Size> *metrics, std::vector<SpriteDatHeader> *metrics2);
@@ -196,6 +215,7 @@ private:
     int _storeFlags = 0; // storage flags, specify how sprites may be stored
     SpriteCompression _compress = kSprCompress_None; // sprite compression type
     sprkey_t _curPos; // current stream position (sprite slot)
+    String _indexCacheFile; // sprite index cache location
 };
 
 
@@ -45,6 +45,8 @@ String GetTraFileErrorText(TraFileErrorType err)
         return "Unknown block type.";
     case kTraFileErr_BlockDataOverlapping:
         return "Block data overlapping.";
+    case kTraFileErr_InvalidDictIndex:
+        return "Invalid dictionary index.";
     default: return "Unknown error.";
     }
 }
@@ -60,6 +62,159 @@ String GetTraBlockName(TraFileBlock id)
     }
 }
 
+uint32_t TraDictIndex::HashKey(const char *key, size_t &len)
+{
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    const char *p = key;
+    for (; *p; ++p)
+    {
+        hash ^= static_cast<uint8_t>(*p);
+        hash *= 16777619u;
+    }
+    len = p - key;
+    return hash;
+}
+
+const char *TraDictIndex::Find(const char *key, size_t &key_len) const
+{
+    size_t len;
+    const uint32_t hash = HashKey(key, len);
+    key_len = len;
+    if (_entries.empty())
+        return nullptr;
+    const uint32_t mask = static_cast<uint32_t>(_slots.size() - 1);
+    for (uint32_t slot = hash & mask; _slots[slot] != 0; slot = (slot + 1) & mask)
+    {
+        const Entry &e = _entries[_slots[slot] - 1];
+        if ((e.Hash == hash) && (e.KeyLen == len) && (memcmp(&_pool[e.KeyOff], key, len) == 0))
+            return &_pool[e.ValueOff];
+    }
+    return nullptr;
+}
+
+void TraDictIndex::Build(const std::vector<std::pair<String, String>> &pairs)
+{
+    _entries.clear();
+    _pool.clear();
+    // Keep the table at most half full, so that probe sequences remain short
+    size_t slot_count = 16;
+    while (slot_count < pairs.size() * 2)
+        slot_count <<= 1;
+    _slots.assign(slot_count, 0);
+    const uint32_t mask = static_cast<uint32_t>(slot_count - 1);
+
+    for (const auto &kv : pairs)
+    {
+        const String &key = kv.first;
+        const String &value = kv.second;
+        if (key.IsEmpty())
+            continue;
+        size_t len;
+        const uint32_t hash = HashKey(key.GetCStr(), len);
+        uint32_t slot = hash & mask;
+        for (; _slots[slot] != 0; slot = (slot + 1) & mask)
+        {
+            const Entry &e = _entries[_slots[slot] - 1];
+            if ((e.Hash == hash) && (e.KeyLen == len) && (memcmp(&_pool[e.KeyOff], key.GetCStr(), len) == 0))
+                break;
+        }
+        if (_slots[slot] != 0)
+            continue; // skip key repeats
+
+        Entry e;
+        e.Hash = hash;
+        e.KeyOff = static_cast<uint32_t>(_pool.size());
+        e.KeyLen = static_cast<uint32_t>(len);
+        e.ValueOff = static_cast<uint32_t>(_pool.size() + len + 1);
+        _pool.insert(_pool.end(), key.GetCStr(), key.GetCStr() + key.GetLength() + 1);
+        _pool.insert(_pool.end(), value.GetCStr(), value.GetCStr() + value.GetLength() + 1);
+        _entries.push_back(e);
+        _slots[slot] = static_cast<uint32_t>(_entries.size());
+    }
+}
+
+HError TraDictIndex::Read(Stream *in, soff_t data_len)
+{
+    _slots.clear();
+    _entries.clear();
+    _pool.clear();
+    const uint32_t entry_count = static_cast<uint32_t>(in->ReadInt32());
+    const uint32_t slot_count = static_cast<uint32_t>(in->ReadInt32());
+    const uint32_t pool_size = static_cast<uint32_t>(in->ReadInt32());
+    // The table must be a power of 2, and have at least one free slot
+    if ((slot_count == 0) || ((slot_count & (slot_count - 1)) != 0) || (entry_count >= slot_count))
+        return new TraFileError(kTraFileErr_InvalidDictIndex,
+            String::FromFormat("Entries: %u, slots: %u.", entry_count, slot_count));
+    // Don't allocate anything before making sure that the tables fit in the block,
+    // and that the pool can hold the keys and values (at least 3 bytes per entry)
+    const uint64_t index_len = 3 * sizeof(int32_t) + static_cast<uint64_t>(slot_count) * sizeof(uint32_t)
+        + static_cast<uint64_t>(entry_count) * sizeof(Entry) + pool_size;
+    if ((data_len < 0) || (index_len > static_cast<uint64_t>(data_len))
+        || (pool_size < static_cast<uint64_t>(entry_count) * 3))
+        return new TraFileError(kTraFileErr_InvalidDictIndex,
+            String::FromFormat("Entries: %u, slots: %u, pool: %u bytes, block: %lld bytes.",
+                entry_count, slot_count, pool_size, static_cast<int64_t>(data_len)));
+
+    std::vector<uint32_t> slots(slot_count);
+    std::vector<Entry> entries(entry_count);
+    std::vector<char> pool(pool_size);
+    in->ReadArrayOfInt32(reinterpret_cast<int32_t*>(slots.data()), slot_count);
+    in->ReadArrayOfInt32(reinterpret_cast<int32_t*>(entries.data()), entry_count * 4);
+    if (in->Read(pool.data(), pool_size) != pool_size)
+        return new TraFileError(kTraFileErr_UnexpectedEOF);
+
+    // Lookup stops at the first free slot, so there must be one,
+    // even if the entry ids are repeated in slots
+    uint32_t free_slots = 0;
+    for (const auto slot : slots)
+    {
+        if (slot > entry_count)
+            return new TraFileError(kTraFileErr_InvalidDictIndex,
+                String::FromFormat("Slot refers to entry %u, number of entries: %u.", slot, entry_count));
+        if (slot == 0)
+            free_slots++;
+    }
+    if (free_slots == 0)
+        return new TraFileError(kTraFileErr_InvalidDictIndex, "No free slots in the table.");
+    // Strings are encrypted one by one, same as in the regular dictionary,
+    // decrypt them in place
+    for (const auto &e : entries)
+    {
+        if ((e.KeyOff >= pool_size) || (e.KeyLen >= pool_size - e.KeyOff) || (e.ValueOff >= pool_size))
+            return new TraFileError(kTraFileErr_InvalidDictIndex,
+                String::FromFormat("Entry is outside of the string pool (%u bytes).", pool_size));
+        DecryptText(&pool[e.KeyOff], e.KeyLen + 1);
+        DecryptText(&pool[e.ValueOff], pool_size - e.ValueOff);
+        if (pool[e.KeyOff + e.KeyLen] != 0)
+            return new TraFileError(kTraFileErr_InvalidDictIndex, "Key length mismatch.");
+    }
+    if (pool_size > 0 && pool.back() != 0)
+        return new TraFileError(kTraFileErr_InvalidDictIndex, "String pool is not terminated.");
+
+    _slots = std::move(slots);
+    _entries = std::move(entries);
+    _pool = std::move(pool);
+    return HError::None();
+}
+
+void TraDictIndex::Write(Stream *out) const
+{
+    out->WriteInt32(static_cast<int32_t>(_entries.size()));
+    out->WriteInt32(static_cast<int32_t>(_slots.size()));
+    out->WriteInt32(static_cast<int32_t>(_pool.size()));
+    out->WriteArrayOfInt32(reinterpret_cast<const int32_t*>(_slots.data()), _slots.size());
+    out->WriteArrayOfInt32(reinterpret_cast<const int32_t*>(_entries.data()), _entries.size() * 4);
+    std::vector<char> pool(_pool);
+    for (const auto &e : _entries)
+    {
+        EncryptText(&pool[e.KeyOff], e.KeyLen + 1);
+        EncryptText(&pool[e.ValueOff], pool.size() - e.ValueOff);
+    }
+    out->Write(pool.data(), pool.size());
+}
+
+
 HError OpenTraFile(Stream *in)
 {
     // Test the file signature
@@ -114,6 +269,12 @@ HError ReadTraBlock(Translation &tra, Stream *in, TraFileBlock block, const Stri
     {
     case kTraFblk_Dict:
         {
+            // If the precomputed index was read, then it is used instead
+            if (!tra.DictIndex.IsEmpty())
+            {
+                in->Seek(block_len);
+                return HError::None();
+            }
             std::vector<char> buf;
             // Read lines until we find zero-length key & value
             while (true)
@@ -170,6 +331,10 @@ HError ReadTraBlock(Translation &tra, Stream *in, TraFileBlock block, const Stri
         tra.ParserDict.ReadFromFile(in);
         return HError::None();
     }
+    else if (ext_id.CompareNoCase("ext_dictindex") == 0)
+    {
+        return tra.DictIndex.Read(in, block_len);
+    }
     
     return new TraFileError(kTraFileErr_UnknownBlockType,
         String::FromFormat("Type: %s", ext_id.GetCStr()));
@@ -249,21 +414,32 @@ void WriteGameID(const Translation &tra, Stream *out)
     StrUtil::WriteString(EncryptText(en_buf, tra.GameName), tra.GameName.GetLength() + 1, out);
 }
 
-void WriteDict(const Translation &tra, Stream *out)
+// Makes a list of source/dest pairs in the form they are written to file
+static std::vector<std::pair<String, String>> MakeDictPairs(const Translation &tra)
 {
-    std::vector<char> en_buf;
+    std::vector<std::pair<String, String>> pairs;
+    pairs.reserve(tra.Dict.size());
     for (const auto &kv : tra.Dict)
     {
         const String &src = kv.first;
         const String &dst = kv.second;
         if (!dst.IsNullOrSpace())
         {
-            String unsrc = StrUtil::Unescape(PreprocessLineForOldStyleLinebreaks(src));
-            String undst = StrUtil::Unescape(PreprocessLineForOldStyleLinebreaks(dst));
-            StrUtil::WriteString(EncryptText(en_buf, unsrc), unsrc.GetLength() + 1, out);
-            StrUtil::WriteString(EncryptText(en_buf, undst), undst.GetLength() + 1, out);
+            pairs.emplace_back(StrUtil::Unescape(PreprocessLineForOldStyleLinebreaks(src)),
+                StrUtil::Unescape(PreprocessLineForOldStyleLinebreaks(dst)));
         }
     }
+    return pairs;
+}
+
+void WriteDict(const Translation &tra, Stream *out)
+{
+    std::vector<char> en_buf;
+    for (const auto &kv : MakeDictPairs(tra))
+    {
+        StrUtil::WriteString(EncryptText(en_buf, kv.first), kv.first.GetLength() + 1, out);
+        StrUtil::WriteString(EncryptText(en_buf, kv.second), kv.second.GetLength() + 1, out);
+    }
     // Write a pair of empty key/values
     StrUtil::WriteString(EncryptEmptyString(en_buf), 1, out);
     StrUtil::WriteString(EncryptEmptyString(en_buf), 1, out);
@@ -339,13 +515,21 @@ inline void WriteTraBlock(const Translation &tra, const String &ext_id,
         kDataExt_NumID32 | kDataExt_File32, out);
 }
 
-void WriteTraData(const Translation &tra, std::unique_ptr<Stream> &&out)
+void WriteTraData(const Translation &tra, std::unique_ptr<Stream> &&out, bool write_dict_index)
 {
     // Write header
     out->Write(TRASignature, strlen(TRASignature) + 1);
 
     // Write all blocks
     WriteTraBlock(tra, kTraFblk_GameID, WriteGameID, out.get());
+    // The dictionary index must precede the dictionary, which lets the reader skip latter
+    if (write_dict_index)
+    {
+        TraDictIndex dict_index;
+        dict_index.Build(MakeDictPairs(tra));
+        WriteExtBlock("ext_dictindex", [&dict_index](Stream *out) { dict_index.Write(out); },
+            kDataExt_NumID32 | kDataExt_File32, out.get());
+    }
     WriteTraBlock(tra, kTraFblk_Dict, WriteDict, out.get());
     if (tra.ParserDict.GetWords().size() > 0)
     {
@@ -39,6 +39,7 @@ enum TraFileErrorType
     kTraFileErr_UnexpectedEOF,
     kTraFileErr_UnknownBlockType,
     kTraFileErr_BlockDataOverlapping,
+    kTraFileErr_InvalidDictIndex,
 };
 
 enum TraFileBlock
@@ -70,6 +71,56 @@ enum TraOptionFlags
     kTraOpt_AutoTranslateSaid = 0x0001
 };
 
+// TraDictIndex is a precomputed hash index over the translation dictionary.
+// All the keys and values are stored in a single string pool, and looked up
+// through an open addressing hash table, so that loading the index does not
+// require any per-entry allocations.
+class TraDictIndex
+{
+public:
+    // Calculates a hash of a null-terminated key, also returns its length
+    static uint32_t HashKey(const char *key, size_t &len);
+
+    // Tells if the index is empty
+    bool IsEmpty() const { return _entries.empty(); }
+    // Returns number of entries in the index
+    size_t GetCount() const { return _entries.size(); }
+    // Returns the key of the entry at the given position
+    const char *GetKey(size_t index) const { return &_pool[_entries[index].KeyOff]; }
+    // Returns the value of the entry at the given position
+    const char *GetValue(size_t index) const { return &_pool[_entries[index].ValueOff]; }
+    // Finds the translated line for the given key; returns nullptr if none found
+    const char *Find(const char *key) const { size_t len; return Find(key, len); }
+    // Finds the translated line for the given key, also returns the key's length
+    // (calculated along with its hash); returns nullptr if none found
+    const char *Find(const char *key, size_t &key_len) const;
+
+    // Builds the index from the list of source/dest pairs;
+    // repeating keys are skipped, first one of them is used
+    void Build(const std::vector<std::pair<String, String>> &pairs);
+    // Reads the index from the stream; data_len is the size of the index
+    // data in the stream, used to validate the stored table sizes
+    HError Read(Stream *in, soff_t data_len);
+    // Writes the index to the stream
+    void Write(Stream *out) const;
+
+private:
+    struct Entry
+    {
+        uint32_t Hash;
+        uint32_t KeyOff;
+        uint32_t KeyLen;
+        uint32_t ValueOff;
+    };
+
+    // Hash table slots, each refers to an entry index + 1, or 0 if empty;
+    // the number of slots is always a power of 2
+    std::vector<uint32_t> _slots;
+    std::vector<Entry> _entries;
+    // Null-terminated keys and values
+    std::vector<char> _pool;
+};
+
 struct Translation
 {
     // Game identifiers, for matching the translation file with the game
@@ -77,6 +128,9 @@ struct Translation
     String GameName;
     // Translation dictionary in source/dest pairs
     StringMap Dict;
+    // Precomputed dictionary index; if it is present in the file,
+    // then the Dict is not loaded, and this index should be used instead
+    TraDictIndex DictIndex;
     // Optional text parser's words dictionary (translation for text parser)
     WordsDictionary ParserDict;
     // Localization parameters
@@ -96,8 +150,10 @@ struct Translation
 HError TestTraGameID(int game_uid, const String &game_name, std::unique_ptr<Stream> &&in);
 // Reads full translation data from the provided stream
 HError ReadTraData(Translation &tra, std::unique_ptr<Stream> &&in);
-// Writes all translation data to the stream
-void WriteTraData(const Translation &tra, std::unique_ptr<Stream> &&out);
+// Writes all translation data to the stream;
+// optionally writes the precomputed dictionary index, which lets engine
+// look up lines faster, but makes the file unreadable by older engines
+void WriteTraData(const Translation &tra, std::unique_ptr<Stream> &&out, bool write_dict_index = false);
 
 } // namespace Common
 } // namespace AGS
@@ -0,0 +1,228 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2026 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+#include "debug/profiler.h"
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include "util/file.h"
+
+namespace AGS
+{
+namespace Common
+{
+
+namespace Profiler
+{
+
+struct ZoneEvent
+{
+    const char *Name = nullptr;
+    int64_t Start = 0; // in nanoseconds since the profiler's epoch
+    int64_t Duration = 0; // in nanoseconds
+};
+
+// Ring buffer of events recorded by a single thread
+struct ThreadBuffer
+{
+    std::mutex Mutex;
+    std::vector<ZoneEvent> Events;
+    size_t Next = 0u; // position of the next event to write
+    size_t Count = 0u; // number of valid events
+    uint32_t ThreadID = 0u;
+    // NOTE: using std::string, as AGS String's buffer must not be shared among threads
+    std::string Name;
+};
+
+struct Registry
+{
+    std::mutex Mutex;
+    std::vector<std::shared_ptr<ThreadBuffer>> Threads;
+    size_t BufferSize = DefaultThreadBufferSize;
+};
+
+// Trace timestamps are relative to the program start
+static const Clock::time_point Epoch = Clock::now();
+
+static Registry &GetRegistry()
+{
+    static Registry registry;
+    return registry;
+}
+
+static thread_local std::shared_ptr<ThreadBuffer> CurrentThreadBuffer;
+
+static ThreadBuffer &GetThreadBuffer()
+{
+    if (!CurrentThreadBuffer)
+    {
+        auto &reg = GetRegistry();
+        std::lock_guard<std::mutex> lk(reg.Mutex);
+        auto buf = std::make_shared<ThreadBuffer>();
+        buf->Events.resize(std::max<size_t>(1u, reg.BufferSize));
+        buf->ThreadID = static_cast<uint32_t>(reg.Threads.size() + 1);
+        reg.Threads.push_back(buf);
+        CurrentThreadBuffer = std::move(buf);
+    }
+    return *CurrentThreadBuffer;
+}
+
+void SetThreadBufferSize(size_t event_count)
+{
+    auto &reg = GetRegistry();
+    std::lock_guard<std::mutex> lk(reg.Mutex);
+    reg.BufferSize = event_count;
+}
+
+void SetThreadName(const char *name)
+{
+    auto &buf = GetThreadBuffer();
+    std::lock_guard<std::mutex> lk(buf.Mutex);
+    buf.Name = name ? name : "";
+}
+
+void RecordZone(const char *name, Clock::time_point start, Clock::time_point end)
+{
+    auto &buf = GetThreadBuffer();
+    std::lock_guard<std::mutex> lk(buf.Mutex);
+    ZoneEvent &evt = buf.Events[buf.Next];
+    evt.Name = name;
+    evt.Start = std::chrono::duration_cast<std::chrono::nanoseconds>(start - Epoch).count();
+    evt.Duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+    buf.Next = (buf.Next + 1) % buf.Events.size();
+    buf.Count = std::min(buf.Count + 1, buf.Events.size());
+}
+
+size_t GetEventCount()
+{
+    auto &reg = GetRegistry();
+    std::lock_guard<std::mutex> lk(reg.Mutex);
+    size_t count = 0u;
+    for (auto &buf : reg.Threads)
+    {
+        std::lock_guard<std::mutex> buf_lk(buf->Mutex);
+        count += buf->Count;
+    }
+    return count;
+}
+
+void Clear()
+{
+    auto &reg = GetRegistry();
+    std::lock_guard<std::mutex> lk(reg.Mutex);
+    for (auto &buf : reg.Threads)
+    {
+        std::lock_guard<std::mutex> buf_lk(buf->Mutex);
+        buf->Next = 0u;
+        buf->Count = 0u;
+    }
+}
+
+// Appends a string to JSON, escaping the special characters
+static void AppendJSONString(std::string &json, const char *str)
+{
+    json.push_back('"');
+    for (const char *p = str; p && *p; ++p)
+    {
+        const unsigned char c = static_cast<unsigned char>(*p);
+        if (c == '"' || c == '\\')
+        {
+            json.push_back('\\');
+            json.push_back(*p);
+        }
+        else if (c < 0x20)
+        {
+            char esc[8];
+            snprintf(esc, sizeof(esc), "\\u%04x", c);
+            json.append(esc);
+        }
+        else
+        {
+            json.push_back(*p);
+        }
+    }
+    json.push_back('"');
+}
+
+bool WriteChromeTrace(Stream *out)
+{
+    if (!out)
+        return false;
+
+    std::vector<std::shared_ptr<ThreadBuffer>> threads;
+    {
+        auto &reg = GetRegistry();
+        std::lock_guard<std::mutex> lk(reg.Mutex);
+        threads = reg.Threads;
+    }
+
+    std::string json = "{\"traceEvents\":[\n";
+    bool first = true;
+    std::vector<ZoneEvent> events;
+    for (auto &buf : threads)
+    {
+        // Copy the events in chronological order, and release the thread
+        std::string thread_name;
+        {
+            std::lock_guard<std::mutex> lk(buf->Mutex);
+            const size_t size = buf->Events.size();
+            const size_t oldest = (buf->Next + size - buf->Count) % size;
+            events.resize(buf->Count);
+            for (size_t i = 0; i < buf->Count; ++i)
+                events[i] = buf->Events[(oldest + i) % size];
+            thread_name = buf->Name;
+        }
+
+        char line[256];
+        if (!thread_name.empty())
+        {
+            snprintf(line, sizeof(line), "%s{\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"name\":\"thread_name\",\"args\":{\"name\":",
+                first ? "" : ",\n", buf->ThreadID);
+            json.append(line);
+            AppendJSONString(json, thread_name.c_str());
+            json.append("}}");
+            first = false;
+        }
+        for (const auto &evt : events)
+        {
+            // Chrome trace timestamps are in microseconds
+            snprintf(line, sizeof(line), "%s{\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,\"name\":",
+                first ? "" : ",\n", buf->ThreadID, evt.Start * 0.001, evt.Duration * 0.001);
+            json.append(line);
+            AppendJSONString(json, evt.Name);
+            json.push_back('}');
+            first = false;
+        }
+
+        // Don't keep the whole trace in memory
+        if (out->Write(json.data(), json.size()) != json.size())
+            return false;
+        json.clear();
+    }
+    json.append("\n],\"displayTimeUnit\":\"ms\"}\n");
+    return out->Write(json.data(), json.size()) == json.size();
+}
+
+bool WriteChromeTrace(const String &filename)
+{
+    auto out = File::CreateFile(filename);
+    return WriteChromeTrace(out.get());
+}
+
+} // namespace Profiler
+
+} // namespace Common
+} // namespace AGS
@@ -0,0 +1,107 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2026 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+//
+// Profiler records the time spent in the marked code zones, and writes the
+// recorded timeline in the Chrome's trace event format, which may be viewed
+// in chrome://tracing, Perfetto (ui.perfetto.dev) and similar tools.
+//
+// The zones are marked with the AGS_PROFILE_ZONE("name") macro, which measures
+// the time from the macro until the end of the enclosing scope. The zones may
+// be nested, the viewer shows them as a hierarchy. Each thread records the
+// zones into its own ring buffer, which keeps only the latest events.
+//
+// The profiling macros are compiled in only when AGS_PROFILER is defined to
+// a non-zero value (see AGS_PROFILER CMake option), otherwise they expand to
+// nothing. The Profiler functions themselves are always available.
+//
+// Thread-safety: zones may be recorded on any thread. Each thread buffer has
+// its own lock, which is only contended while the trace is being written.
+//
+//=============================================================================
+#ifndef __AGS_CN_DEBUG__PROFILER_H
+#define __AGS_CN_DEBUG__PROFILER_H
+
+#include <chrono>
+#include "util/stream.h"
+#include "util/string.h"
+
+#if !defined(AGS_PROFILER)
+    #define AGS_PROFILER (0)
+#endif
+
+namespace AGS
+{
+namespace Common
+{
+
+namespace Profiler
+{
+    using Clock = std::chrono::steady_clock;
+
+    // Default number of events kept per thread
+    const size_t DefaultThreadBufferSize = 64 * 1024;
+
+    // Sets the ring buffer size for the threads which begin recording
+    // after this call; already recording threads keep their buffers
+    void SetThreadBufferSize(size_t event_count);
+    // Sets the name of the calling thread, displayed by the trace viewer
+    void SetThreadName(const char *name);
+    // Records a zone on the calling thread; the name must be a string
+    // which lives until the end of the program (e.g. a string literal)
+    void RecordZone(const char *name, Clock::time_point start, Clock::time_point end);
+    // Gets the number of events currently kept in all the thread buffers
+    size_t GetEventCount();
+    // Discards all the recorded events
+    void Clear();
+    // Writes all the recorded events as a Chrome trace JSON
+    bool WriteChromeTrace(Stream *out);
+    bool WriteChromeTrace(const String &filename);
+} // namespace Profiler
+
+// ProfileZone records a zone from its construction until destruction
+class ProfileZone
+{
+public:
+    explicit ProfileZone(const char *name)
+        : _name(name), _start(Profiler::Clock::now()) {}
+    ~ProfileZone()
+    {
+        Profiler::RecordZone(_name, _start, Profiler::Clock::now());
+    }
+
+private:
+    ProfileZone(const ProfileZone&) = delete;
+    ProfileZone &operator=(const ProfileZone&) = delete;
+
+    const char *_name;
+    Profiler::Clock::time_point _start;
+};
+
+} // namespace Common
+} // namespace AGS
+
+#if AGS_PROFILER
+#define AGS_PROFILE_CONCAT_IMPL(a, b) a##b
+#define AGS_PROFILE_CONCAT(a, b) AGS_PROFILE_CONCAT_IMPL(a, b)
+// Records the time spent until the end of the current scope
+#define AGS_PROFILE_ZONE(name) \
+    AGS::Common::ProfileZone AGS_PROFILE_CONCAT(ags_profile_zone_, __LINE__)(name)
+// Names the current thread in the recorded trace
+#define AGS_PROFILE_THREAD(name) AGS::Common::Profiler::SetThreadName(name)
+#else
+#define AGS_PROFILE_ZONE(name)
+#define AGS_PROFILE_THREAD(name)
+#endif
+
+#endif // __AGS_CN_DEBUG__PROFILER_H
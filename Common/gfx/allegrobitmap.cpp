@@ -17,6 +17,7 @@
 #include <string.h> // memcpy
 #include <aastr.h>
 #include "gfx/allegrobitmap.h"
+#include "gfx/blitkernels.h"
 #include "util/filestream.h"
 #include "debug/assert.h"
 
@@ -149,6 +150,7 @@ bool Bitmap::CreateSubBitmap(Bitmap *src, const Rect &rc)
     Destroy();
     _alBitmap = create_sub_bitmap(src->_alBitmap, rc.Left, rc.Top, rc.GetWidth(), rc.GetHeight());
     _isBmOwner = true;
+    _alphaInColors = src->_alphaInColors; // shares pixels, so keep the same color format
     return _alBitmap != nullptr;
 }
 
@@ -298,6 +300,9 @@ void Bitmap::MaskedBlit(const Bitmap *src, int dst_x, int dst_y)
 void Bitmap::StretchBlt(const Bitmap *src, const Rect &dst_rc, BitmapMaskOption mask)
 {
 	BITMAP *al_src_bmp = src->_alBitmap;
+	if (BlitKernels::StretchBlit(al_src_bmp, _alBitmap, 0, 0, al_src_bmp->w, al_src_bmp->h,
+			dst_rc.Left, dst_rc.Top, dst_rc.GetWidth(), dst_rc.GetHeight(), mask == kBitmap_Transparency))
+		return;
 	// WARNING: For some evil reason Allegro expects dest and src bitmaps in different order for blit and draw_sprite
 	if (mask == kBitmap_Transparency)
 	{
@@ -315,6 +320,9 @@ void Bitmap::StretchBlt(const Bitmap *src, const Rect &dst_rc, BitmapMaskOption
 void Bitmap::StretchBlt(const Bitmap *src, const Rect &src_rc, const Rect &dst_rc, BitmapMaskOption mask)
 {
 	BITMAP *al_src_bmp = src->_alBitmap;
+	if (BlitKernels::StretchBlit(al_src_bmp, _alBitmap, src_rc.Left, src_rc.Top, src_rc.GetWidth(), src_rc.GetHeight(),
+			dst_rc.Left, dst_rc.Top, dst_rc.GetWidth(), dst_rc.GetHeight(), mask == kBitmap_Transparency))
+		return;
 	if (mask == kBitmap_Transparency)
 	{
 		masked_stretch_blit(al_src_bmp, _alBitmap,
@@ -332,6 +340,9 @@ void Bitmap::StretchBlt(const Bitmap *src, const Rect &src_rc, const Rect &dst_r
 void Bitmap::AAStretchBlt(const Bitmap *src, const Rect &dst_rc, BitmapMaskOption mask)
 {
 	BITMAP *al_src_bmp = src->_alBitmap;
+	if (BlitKernels::AAStretchBlit(al_src_bmp, _alBitmap, 0, 0, al_src_bmp->w, al_src_bmp->h,
+			dst_rc.Left, dst_rc.Top, dst_rc.GetWidth(), dst_rc.GetHeight(), mask == kBitmap_Transparency))
+		return;
 	// WARNING: For some evil reason Allegro expects dest and src bitmaps in different order for blit and draw_sprite
 	if (mask == kBitmap_Transparency)
 	{
@@ -358,6 +369,9 @@ void Bitmap::AAStretchBlt(const Bitmap *src, const Rect &src_rc, const Rect &dst
 	}
 	else
 	{
+		if (BlitKernels::AAStretchBlit(al_src_bmp, _alBitmap, src_rc.Left, src_rc.Top, src_rc.GetWidth(), src_rc.GetHeight(),
+				dst_rc.Left, dst_rc.Top, dst_rc.GetWidth(), dst_rc.GetHeight(), false))
+			return;
 		aa_stretch_blit(al_src_bmp, _alBitmap,
 			src_rc.Left, src_rc.Top, src_rc.GetWidth(), src_rc.GetHeight(),
 			dst_rc.Left, dst_rc.Top, dst_rc.GetWidth(), dst_rc.GetHeight());
@@ -401,7 +415,11 @@ void Bitmap::RotateBlt(const Bitmap *src, int dst_x, int dst_y, fixed_t angle)
     // convert to allegro angle
     fixed_t al_angle = itofix((angle * 256) / 360);
     BITMAP *al_src_bmp = src->_alBitmap;
-    rotate_sprite(_alBitmap, al_src_bmp, dst_x, dst_y, al_angle);
+    // Large sprites are rotated in parallel, each thread drawing its own band of rows
+    if (!BlitKernels::DrawInBands(al_src_bmp, _alBitmap,
+            [al_src_bmp, dst_x, dst_y, al_angle](BITMAP *band)
+            { rotate_sprite(band, al_src_bmp, dst_x, dst_y, al_angle); }))
+        rotate_sprite(_alBitmap, al_src_bmp, dst_x, dst_y, al_angle);
 }
 
 void Bitmap::RotateBlt(const Bitmap *src, int dst_x, int dst_y, int pivot_x, int pivot_y, fixed_t angle)
@@ -409,7 +427,10 @@ void Bitmap::RotateBlt(const Bitmap *src, int dst_x, int dst_y, int pivot_x, int
     // convert to allegro angle
     fixed_t al_angle = itofix((angle * 256) / 360);
     BITMAP *al_src_bmp = src->_alBitmap;
-    pivot_sprite(_alBitmap, al_src_bmp, dst_x, dst_y, pivot_x, pivot_y, al_angle);
+    if (!BlitKernels::DrawInBands(al_src_bmp, _alBitmap,
+            [al_src_bmp, dst_x, dst_y, pivot_x, pivot_y, al_angle](BITMAP *band)
+            { pivot_sprite(band, al_src_bmp, dst_x, dst_y, pivot_x, pivot_y, al_angle); }))
+        pivot_sprite(_alBitmap, al_src_bmp, dst_x, dst_y, pivot_x, pivot_y, al_angle);
 }
 
 //=============================================================================
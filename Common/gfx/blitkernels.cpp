@@ -0,0 +1,638 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2026 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+#include <algorithm>
+#include <vector>
+#include <string.h> // memcpy
+#if !defined(AGS_DISABLE_THREADS)
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+#include "gfx/blitkernels.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define AGS_BLITKERNELS_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace AGS
+{
+namespace Common
+{
+
+namespace BlitKernels
+{
+
+// Maximal number of threads to split the work among
+const int MaxThreads = 8;
+// Minimal number of destination rows per thread
+const int MinRowsPerThread = 16;
+
+// Tells how many threads should be used for the work of the given size
+static int GetThreadCount(int work_pixels, int rows)
+{
+#if !defined(AGS_DISABLE_THREADS)
+    if (work_pixels < MinParallelPixels)
+        return 1;
+    const int hw_threads = static_cast<int>(std::thread::hardware_concurrency());
+    return std::max(1, std::min(std::min(MaxThreads, hw_threads), rows / MinRowsPerThread));
+#else
+    (void)work_pixels; (void)rows;
+    return 1;
+#endif
+}
+
+#if !defined(AGS_DISABLE_THREADS)
+// WorkerPool is a persistent set of threads, which run the parts of a job
+// together with the calling thread. Workers are started on the first use,
+// and then wait for the next job, so that frequent small jobs do not pay
+// for creating threads.
+class WorkerPool
+{
+public:
+    ~WorkerPool()
+    {
+        {
+            std::lock_guard<std::mutex> lk(_mutex);
+            _quit = true;
+        }
+        _cvWork.notify_all();
+        for (auto &t : _workers)
+            t.join();
+    }
+
+    // Runs fn(part) for each part in [0, num_parts), the part 0 on the calling
+    // thread, and waits until all are done. Returns false without running
+    // anything if the pool is already busy (e.g. if called from another
+    // thread, or from within a job), in which case the caller should do
+    // the work by itself.
+    bool Run(int num_parts, const std::function<void(int)> &fn)
+    {
+        if (_busy.exchange(true))
+            return false;
+        while (static_cast<int>(_workers.size()) < num_parts - 1)
+            _workers.emplace_back(&WorkerPool::WorkerProc, this, static_cast<int>(_workers.size() + 1), _jobID);
+
+        {
+            std::lock_guard<std::mutex> lk(_mutex);
+            _job = &fn;
+            _jobParts = num_parts;
+            _busyWorkers = static_cast<int>(_workers.size());
+            ++_jobID;
+        }
+        _cvWork.notify_all();
+        fn(0);
+        {
+            std::unique_lock<std::mutex> lk(_mutex);
+            _cvDone.wait(lk, [this]() { return _busyWorkers == 0; });
+            _job = nullptr;
+        }
+        _busy = false;
+        return true;
+    }
+
+private:
+    void WorkerProc(int part, uint32_t last_job)
+    {
+        for (;;)
+        {
+            const std::function<void(int)> *job;
+            int job_parts;
+            {
+                std::unique_lock<std::mutex> lk(_mutex);
+                _cvWork.wait(lk, [this, last_job]() { return _quit || (_jobID != last_job); });
+                if (_quit)
+                    return;
+                last_job = _jobID;
+                job = _job;
+                job_parts = _jobParts;
+            }
+            if (part < job_parts)
+                (*job)(part);
+            {
+                std::lock_guard<std::mutex> lk(_mutex);
+                if (--_busyWorkers == 0)
+                    _cvDone.notify_one();
+            }
+        }
+    }
+
+    std::vector<std::thread> _workers;
+    std::atomic<bool> _busy{false}; // set for the whole job
+    std::mutex _mutex; // guards the job state
+    std::condition_variable _cvWork;
+    std::condition_variable _cvDone;
+    const std::function<void(int)> *_job = nullptr;
+    int _jobParts = 0;
+    uint32_t _jobID = 0;
+    int _busyWorkers = 0;
+    bool _quit = false;
+};
+
+static WorkerPool &GetWorkerPool()
+{
+    static WorkerPool pool;
+    return pool;
+}
+#endif
+
+// Splits the range of rows into contiguous parts, and runs the function
+// for each of them, on worker threads if the work is large enough
+template <typename TFunc>
+static void ParallelRows(int rows, int row_pixels, TFunc fn)
+{
+    const int num_threads = GetThreadCount(rows * row_pixels, rows);
+#if !defined(AGS_DISABLE_THREADS)
+    if ((num_threads > 1) &&
+        GetWorkerPool().Run(num_threads, [&fn, rows, num_threads](int part)
+            { fn(rows * part / num_threads, rows * (part + 1) / num_threads); }))
+        return;
+#endif
+    (void)num_threads;
+    fn(0, rows);
+}
+
+//-----------------------------------------------------------------------------
+// Pixel formats
+//-----------------------------------------------------------------------------
+
+struct Pixel15
+{
+    typedef uint16_t Type;
+    static const Type Mask = MASK_COLOR_15;
+    static int R(int c) { return getr15(c); }
+    static int G(int c) { return getg15(c); }
+    static int B(int c) { return getb15(c); }
+    static Type Make(int r, int g, int b) { return static_cast<Type>(makecol15(r, g, b)); }
+};
+
+struct Pixel16
+{
+    typedef uint16_t Type;
+    static const Type Mask = MASK_COLOR_16;
+    static int R(int c) { return getr16(c); }
+    static int G(int c) { return getg16(c); }
+    static int B(int c) { return getb16(c); }
+    static Type Make(int r, int g, int b) { return static_cast<Type>(makecol16(r, g, b)); }
+};
+
+struct Pixel32
+{
+    typedef uint32_t Type;
+    static const Type Mask = MASK_COLOR_32;
+    static int R(int c) { return getr32(c); }
+    static int G(int c) { return getg32(c); }
+    static int B(int c) { return getb32(c); }
+    static Type Make(int r, int g, int b) { return static_cast<Type>(makecol32(r, g, b)); }
+};
+
+// Copies a row of pixels, skipping those which match the mask color
+static void MaskedCopyRow(uint16_t *dst, const uint16_t *src, int count, uint16_t mask)
+{
+    int x = 0;
+#if defined(AGS_BLITKERNELS_SSE2)
+    const __m128i mask8 = _mm_set1_epi16(static_cast<short>(mask));
+    for (; x + 8 <= count; x += 8)
+    {
+        const __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x));
+        const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + x));
+        const __m128i skip = _mm_cmpeq_epi16(s, mask8);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x),
+            _mm_or_si128(_mm_and_si128(skip, d), _mm_andnot_si128(skip, s)));
+    }
+#endif
+    for (; x < count; ++x)
+    {
+        if (src[x] != mask)
+            dst[x] = src[x];
+    }
+}
+
+static void MaskedCopyRow(uint32_t *dst, const uint32_t *src, int count, uint32_t mask)
+{
+    int x = 0;
+#if defined(AGS_BLITKERNELS_SSE2)
+    const __m128i mask4 = _mm_set1_epi32(static_cast<int>(mask));
+    for (; x + 4 <= count; x += 4)
+    {
+        const __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x));
+        const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + x));
+        const __m128i skip = _mm_cmpeq_epi32(s, mask4);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x),
+            _mm_or_si128(_mm_and_si128(skip, d), _mm_andnot_si128(skip, s)));
+    }
+#endif
+    for (; x < count; ++x)
+    {
+        if (src[x] != mask)
+            dst[x] = src[x];
+    }
+}
+
+// Calculates the clipped destination range, returns false if nothing is visible
+static bool ClipDestination(BITMAP *dst, int dx, int dy, int dw, int dh,
+    int &dxbeg, int &dxend, int &dybeg, int &dyend)
+{
+    if (dst->clip)
+    {
+        dybeg = std::max(dy, dst->ct);
+        dyend = std::min(dy + dh, dst->cb);
+        dxbeg = std::max(dx, dst->cl);
+        dxend = std::min(dx + dw, dst->cr);
+        return (dybeg < dyend) && (dxbeg < dxend);
+    }
+    dxbeg = dx;
+    dxend = dx + dw;
+    dybeg = dy;
+    dyend = dy + dh;
+    return true;
+}
+
+// Tells if the given bitmaps may be handled by the kernels
+static bool IsSupported(BITMAP *src, BITMAP *dst)
+{
+    const int depth = bitmap_color_depth(dst);
+    return (bitmap_color_depth(src) == depth) &&
+        ((depth == 15) || (depth == 16) || (depth == 32)) &&
+        !is_same_bitmap(src, dst);
+}
+
+//-----------------------------------------------------------------------------
+// Nearest-neighbour stretching
+//-----------------------------------------------------------------------------
+
+// Fills the source coordinates for each of the visible destination pixels
+// along one axis, following the same stepping as Allegro's stretch_blit
+static void MakeNearestMap(std::vector<int> &map, int s, int sw, int d, int dw, int dbeg, int dend)
+{
+    const int sinc = sw / dw;
+    const int cdec = sw - sinc * dw;
+    const int cinc = dw - cdec;
+    int c = cinc;
+    map.resize(dend - dbeg);
+    for (int i = d; i < dend; ++i)
+    {
+        if (i >= dbeg)
+            map[i - dbeg] = s;
+        s += sinc;
+        if (c <= 0)
+        {
+            s++;
+            c += cinc;
+        }
+        else
+        {
+            c -= cdec;
+        }
+    }
+}
+
+template <typename TPx>
+static void StretchNearest(BITMAP *src, BITMAP *dst, const std::vector<int> &xmap, const std::vector<int> &ymap,
+    int dx, int dy, bool masked)
+{
+    typedef typename TPx::Type T;
+    const int width = static_cast<int>(xmap.size());
+    ParallelRows(static_cast<int>(ymap.size()), width, [&](int row_beg, int row_end)
+    {
+        // The stretched source row is only gathered once for all the
+        // destination rows that it maps to
+        std::vector<T> line(width);
+        int last_sy = -1;
+        for (int y = row_beg; y < row_end; ++y)
+        {
+            const int sy = ymap[y];
+            if (sy != last_sy)
+            {
+                const T *src_line = reinterpret_cast<const T*>(src->line[sy]);
+                for (int x = 0; x < width; ++x)
+                    line[x] = src_line[xmap[x]];
+                last_sy = sy;
+            }
+            T *dst_line = reinterpret_cast<T*>(dst->line[dy + y]) + dx;
+            if (masked)
+                MaskedCopyRow(dst_line, line.data(), width, TPx::Mask);
+            else
+                memcpy(dst_line, line.data(), width * sizeof(T));
+        }
+    });
+}
+
+bool StretchBlit(BITMAP *src, BITMAP *dst, int sx, int sy, int sw, int sh,
+    int dx, int dy, int dw, int dh, bool masked)
+{
+    if (!IsSupported(src, dst))
+        return false;
+    if ((sw <= 0) || (sh <= 0) || (dw <= 0) || (dh <= 0))
+        return true;
+    int dxbeg, dxend, dybeg, dyend;
+    if (!ClipDestination(dst, dx, dy, dw, dh, dxbeg, dxend, dybeg, dyend))
+        return true;
+
+    std::vector<int> xmap, ymap;
+    MakeNearestMap(xmap, sx, sw, dx, dw, dxbeg, dxend);
+    MakeNearestMap(ymap, sy, sh, dy, dh, dybeg, dyend);
+    switch (bitmap_color_depth(dst))
+    {
+    case 15: StretchNearest<Pixel15>(src, dst, xmap, ymap, dxbeg, dybeg, masked); break;
+    case 16: StretchNearest<Pixel16>(src, dst, xmap, ymap, dxbeg, dybeg, masked); break;
+    case 32: StretchNearest<Pixel32>(src, dst, xmap, ymap, dxbeg, dybeg, masked); break;
+    default: return false;
+    }
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+// Anti-aliased stretching
+//-----------------------------------------------------------------------------
+
+// Fixed-point precision, and limits, as used by aastr
+const int AA_Bits = 8;
+const int AA_Size = 1 << AA_Bits;
+const int AA_Mask = AA_Size - 1;
+const int AA_MaxSize = 1 << 12;
+const uint32_t AA_MaxNum = static_cast<uint32_t>(AA_MaxSize) * AA_MaxSize;
+
+// Fills the source coordinates (in fixed point) for each of the visible
+// destination pixels along one axis; this follows the aastr's Bresenham
+// stepping (aa_PREPARE and aa_ADVANCE macros)
+static void MakeAAMap(std::vector<int> &map, int s, int sw, int d, int dw, int dbeg, int dend)
+{
+    int inc, yw = sw;
+    const int xw = dw;
+    if ((xw == 0) || ((yw < xw) && (yw > -xw)))
+    {
+        inc = 0;
+    }
+    else
+    {
+        inc = yw / xw;
+        yw %= xw;
+    }
+    if (yw < 0)
+    {
+        inc -= 1;
+        yw += xw;
+    }
+    const int i1 = 2 * yw;
+    int dd = i1 - xw;
+    const int i2 = dd - xw;
+
+    map.resize(dend - dbeg);
+    for (int i = d; i < dend; ++i)
+    {
+        if (i >= dbeg)
+            map[i - dbeg] = s;
+        if (dd >= 0)
+        {
+            s += inc + 1;
+            dd += i2;
+        }
+        else
+        {
+            s += inc;
+            dd += i1;
+        }
+    }
+}
+
+// Accumulated color of a destination pixel: r, g, b and the transparent amount
+struct AASum
+{
+    uint32_t R = 0u, G = 0u, B = 0u, T = 0u;
+};
+
+// Sums the weighted colors of the source row for each destination pixel
+template <typename TPx>
+static void AASumRow(const typename TPx::Type *src_line, const std::vector<int> &xmap, int dsx,
+    bool masked, std::vector<AASum> &sums)
+{
+    const int width = static_cast<int>(xmap.size());
+    for (int x = 0; x < width; ++x)
+    {
+        const int sx1 = xmap[x];
+        const int sx2 = sx1 + dsx;
+        const int sx1i = sx1 >> AA_Bits;
+        const int sx2i = sx2 >> AA_Bits;
+        const uint32_t sx1f = AA_Size - (sx1 & AA_Mask);
+        const uint32_t sx2f = sx2 & AA_Mask;
+        AASum sum;
+        int c = src_line[sx1i];
+        if (masked && (c == TPx::Mask))
+        {
+            sum.T = sx1f;
+        }
+        else
+        {
+            sum.R = TPx::R(c) * sx1f;
+            sum.G = TPx::G(c) * sx1f;
+            sum.B = TPx::B(c) * sx1f;
+        }
+        for (int sx = sx1i + 1; sx < sx2i; ++sx)
+        {
+            c = src_line[sx];
+            if (masked && (c == TPx::Mask))
+            {
+                sum.T += AA_Size;
+            }
+            else
+            {
+                sum.R += TPx::R(c) << AA_Bits;
+                sum.G += TPx::G(c) << AA_Bits;
+                sum.B += TPx::B(c) << AA_Bits;
+            }
+        }
+        if (sx2f != 0)
+        {
+            c = src_line[sx2i];
+            if (masked && (c == TPx::Mask))
+            {
+                sum.T += sx2f;
+            }
+            else
+            {
+                sum.R += TPx::R(c) * sx2f;
+                sum.G += TPx::G(c) * sx2f;
+                sum.B += TPx::B(c) * sx2f;
+            }
+        }
+        sums[x] = sum;
+    }
+}
+
+template <typename TPx>
+static void StretchAA(BITMAP *src, BITMAP *dst, const std::vector<int> &xmap, const std::vector<int> &ymap,
+    int dsx, int dsy, uint32_t num, int dx, int dy, bool masked)
+{
+    typedef typename TPx::Type T;
+    const int width = static_cast<int>(xmap.size());
+    ParallelRows(static_cast<int>(ymap.size()), width, [&](int row_beg, int row_end)
+    {
+        // Source row sums are kept for the two last used rows, because
+        // neighbouring destination rows often share them
+        std::vector<AASum> row_sums[2] = { std::vector<AASum>(width), std::vector<AASum>(width) };
+        int row_index[2] = { -1, -1 };
+        int next_slot = 0;
+        std::vector<AASum> acc(width);
+
+        auto add_row = [&](int sy, uint32_t weight)
+        {
+            int slot = (row_index[0] == sy) ? 0 : ((row_index[1] == sy) ? 1 : -1);
+            if (slot < 0)
+            {
+                slot = next_slot;
+                next_slot ^= 1;
+                AASumRow<TPx>(reinterpret_cast<const T*>(src->line[sy]), xmap, dsx, masked, row_sums[slot]);
+                row_index[slot] = sy;
+            }
+            const AASum *sums = row_sums[slot].data();
+            AASum *acc_ptr = acc.data();
+            for (int x = 0; x < width; ++x)
+            {
+                acc_ptr[x].R += sums[x].R * weight;
+                acc_ptr[x].G += sums[x].G * weight;
+                acc_ptr[x].B += sums[x].B * weight;
+                acc_ptr[x].T += sums[x].T * weight;
+            }
+        };
+
+        for (int y = row_beg; y < row_end; ++y)
+        {
+            const int sy1 = ymap[y];
+            const int sy2 = sy1 + dsy;
+            const int sy1i = sy1 >> AA_Bits;
+            const int sy2i = sy2 >> AA_Bits;
+            const uint32_t sy2f = sy2 & AA_Mask;
+            std::fill(acc.begin(), acc.end(), AASum());
+            add_row(sy1i, AA_Size - (sy1 & AA_Mask));
+            for (int sy = sy1i + 1; sy < sy2i; ++sy)
+                add_row(sy, AA_Size);
+            if (sy2f != 0)
+                add_row(sy2i, sy2f);
+
+            T *dst_line = reinterpret_cast<T*>(dst->line[dy + y]) + dx;
+            for (int x = 0; x < width; ++x)
+            {
+                const AASum &sum = acc[x];
+                if (masked && (num < 2 * sum.T))
+                    continue; // mostly transparent
+                if (num == AA_Size * AA_Size)
+                    dst_line[x] = TPx::Make(sum.R >> (2 * AA_Bits), sum.G >> (2 * AA_Bits), sum.B >> (2 * AA_Bits));
+                else
+                    dst_line[x] = TPx::Make(sum.R / num, sum.G / num, sum.B / num);
+            }
+        }
+    });
+}
+
+bool AAStretchBlit(BITMAP *src, BITMAP *dst, int sx, int sy, int sw, int sh,
+    int dx, int dy, int dw, int dh, bool masked)
+{
+    if (!IsSupported(src, dst))
+        return false;
+    if ((dw <= 0) || (dh <= 0) || (sw <= 0) || (sh <= 0))
+        return true;
+    int dxbeg, dxend, dybeg, dyend;
+    if (!ClipDestination(dst, dx, dy, dw, dh, dxbeg, dxend, dybeg, dyend))
+        return true;
+
+    // Convert to the fixed point; when magnifying, the last destination
+    // pixel is aligned to the last source pixel
+    sx <<= AA_Bits;
+    sw <<= AA_Bits;
+    int dsx = sw / dw;
+    if (dsx < AA_Size)
+    {
+        dw--;
+        sw -= AA_Size;
+        dsx = AA_Size;
+    }
+    sy <<= AA_Bits;
+    sh <<= AA_Bits;
+    int dsy = sh / dh;
+    if (dsy < AA_Size)
+    {
+        dh--;
+        sh -= AA_Size;
+        dsy = AA_Size;
+    }
+    uint32_t num = static_cast<uint32_t>(dsx) * static_cast<uint32_t>(dsy);
+    if (num > AA_MaxNum)
+    {
+        dsx = std::min(dsx, AA_MaxSize);
+        dsy = std::min(dsy, AA_MaxSize);
+        num = static_cast<uint32_t>(dsx) * static_cast<uint32_t>(dsy);
+    }
+
+    std::vector<int> xmap, ymap;
+    MakeAAMap(xmap, sx, sw, dx, dw, dxbeg, dxend);
+    MakeAAMap(ymap, sy, sh, dy, dh, dybeg, dyend);
+    switch (bitmap_color_depth(dst))
+    {
+    case 15: StretchAA<Pixel15>(src, dst, xmap, ymap, dsx, dsy, num, dxbeg, dybeg, masked); break;
+    case 16: StretchAA<Pixel16>(src, dst, xmap, ymap, dsx, dsy, num, dxbeg, dybeg, masked); break;
+    case 32: StretchAA<Pixel32>(src, dst, xmap, ymap, dsx, dsy, num, dxbeg, dybeg, masked); break;
+    default: return false;
+    }
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+// Banded drawing
+//-----------------------------------------------------------------------------
+
+bool DrawInBands(BITMAP *src, BITMAP *dst, const std::function<void(BITMAP *band)> &draw)
+{
+#if !defined(AGS_DISABLE_THREADS)
+    // Allegro's drawing with color conversion temporarily changes
+    // the global drawing mode, so it must not run concurrently
+    if (bitmap_color_depth(src) != bitmap_color_depth(dst))
+        return false;
+    const int cl = dst->clip ? dst->cl : 0;
+    const int cr = dst->clip ? dst->cr : dst->w;
+    const int ct = dst->clip ? dst->ct : 0;
+    const int cb = dst->clip ? dst->cb : dst->h;
+    const int rows = cb - ct;
+    const int num_bands = GetThreadCount(src->w * src->h, rows);
+    if ((num_bands <= 1) || (cl >= cr))
+        return false;
+
+    std::vector<BITMAP*> bands;
+    for (int i = 0; i < num_bands; ++i)
+    {
+        BITMAP *band = create_sub_bitmap(dst, 0, 0, dst->w, dst->h);
+        if (!band)
+            break;
+        set_clip_rect(band, cl, ct + rows * i / num_bands, cr - 1, ct + rows * (i + 1) / num_bands - 1);
+        bands.push_back(band);
+    }
+
+    bool done = false;
+    if (bands.size() == static_cast<size_t>(num_bands))
+        done = GetWorkerPool().Run(num_bands, [&draw, &bands](int part) { draw(bands[part]); });
+
+    for (auto *band : bands)
+        destroy_bitmap(band);
+    return done;
+#else
+    (void)src; (void)dst; (void)draw;
+    return false;
+#endif
+}
+
+} // namespace BlitKernels
+
+} // namespace Common
+} // namespace AGS
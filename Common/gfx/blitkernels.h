@@ -0,0 +1,62 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2026 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+//
+// Optimized implementations of the Allegro's scaling and transforming blits
+// for 15, 16 and 32-bit bitmaps. These produce exactly same results as the
+// original Allegro's and aastr's functions, but split the work among
+// multiple threads for large targets and avoid redundant per-pixel work.
+//
+// Each function returns false if it cannot handle the given bitmaps
+// (e.g. the color depth is not supported), in which case the caller should
+// fallback to the generic implementation.
+//
+//=============================================================================
+#ifndef __AGS_CN_GFX__BLITKERNELS_H
+#define __AGS_CN_GFX__BLITKERNELS_H
+
+#include <functional>
+#include <allegro.h> // BITMAP
+
+namespace AGS
+{
+namespace Common
+{
+
+namespace BlitKernels
+{
+    // Minimal number of destination pixels to split the work among threads
+    const int MinParallelPixels = 128 * 128;
+
+    // Nearest-neighbour stretching, matches stretch_blit and masked_stretch_blit
+    bool StretchBlit(BITMAP *src, BITMAP *dst, int sx, int sy, int sw, int sh,
+        int dx, int dy, int dw, int dh, bool masked);
+    // Anti-aliased stretching, matches aa_stretch_blit and aa_stretch_sprite:
+    // this is a bilinear interpolation when magnifying, and area averaging
+    // when minifying the image
+    bool AAStretchBlit(BITMAP *src, BITMAP *dst, int sx, int sy, int sw, int sh,
+        int dx, int dy, int dw, int dh, bool masked);
+    // Splits the destination bitmap into horizontal bands and runs the
+    // drawing function for each of them in parallel; every band is passed
+    // as a sub-bitmap with the full size of destination, but clipped to the
+    // band's rows. The drawing function must be safe to call concurrently,
+    // and only write within the clipping rectangle. Bands are only used if
+    // the source and destination have the same color depth. Returns false
+    // if the drawing should be done without splitting.
+    bool DrawInBands(BITMAP *src, BITMAP *dst, const std::function<void(BITMAP *band)> &draw);
+} // namespace BlitKernels
+
+} // namespace Common
+} // namespace AGS
+
+#endif // __AGS_CN_GFX__BLITKERNELS_H
@@ -159,21 +159,14 @@ Rect GUIListBox::CalcGraphicRect(bool clipped)
     if (clipped)
         return RectWH(0, 0, _width, _height);
 
-    // TODO: need to find a way to text position, or there'll be some repetition
-    // have to precache text and size on some events:
-    // - translation change
-    // - macro value change (score, overhotspot etc)
     Rect rc = RectWH(0, 0, _width, _height);
     UpdateMetrics();
     Line max_line;
     for (uint32_t item = 0; (item < _visibleItemCount) && (item + _topItem < _items.size()); ++item)
     {
-        int at_y = _itemsRect.Top + item * _rowHeight;
-        uint32_t item_index = item + _topItem;
-        PrepareTextToDraw(_items[item_index]);
-        Line lpos = GUI::CalcTextPositionHor(_textToDraw, _font, _itemsRect.Left, _itemsRect.Right, at_y + _itemTextPaddingY,
-            _textAlignment);
-        max_line.X2 = std::max(max_line.X2, lpos.X2);
+        const ItemLayout &layout = GetItemLayout(item + _topItem, true);
+        int at_x = AlignInHRange(_itemsRect.Left, _itemsRect.Right, 0, layout.Width, _textAlignment);
+        max_line.X2 = std::max(max_line.X2, at_x + layout.Width - 1);
     }
     int last_line_y = _itemsRect.Top + _itemTextPaddingY + (_visibleItemCount - 1) * _rowHeight;
     // Include font fixes for the first and last text line,
@@ -192,9 +185,11 @@ int GUIListBox::AddItem(const String &text)
 
 int GUIListBox::AddItem(const String &text, int save)
 {
+    const bool arrows_shown = AreArrowsShown();
     _items.push_back(text);
     _savedGameIndex.push_back(save);
-    MarkChanged();
+    _itemLayouts.emplace_back();
+    MarkItemsChanged(_items.size() - 1, arrows_shown);
     return _items.size() - 1;
 }
 
@@ -204,6 +199,7 @@ void GUIListBox::Clear()
         return;
     _items.clear();
     _savedGameIndex.clear();
+    _itemLayouts.clear();
     _topItem = 0;
     // NOTE: backwards compatible behavior is to keep selection at index 0,
     // so that the first item appears selected when added
@@ -269,12 +265,11 @@ void GUIListBox::Draw(Bitmap *ds, int x, int y)
         }
         const color_t outline_color = ds->GetCompatibleColor(_textOutlineColor);
 
-        int item_index = item + _topItem;
-        PrepareTextToDraw(_items[item_index]);
-
-        GUI::DrawTextAlignedHor(ds, _textToDraw, _font, text_color, outline_color,
-            at_x + _itemTextPaddingX, right_x - _itemTextPaddingX,
-            at_y + _itemTextPaddingY, _textAlignment);
+        const ItemLayout &layout = GetItemLayout(item + _topItem, true);
+        const int text_x = AlignInHRange(at_x + _itemTextPaddingX, right_x - _itemTextPaddingX,
+            0, layout.Width, _textAlignment);
+        wouttext_outline(ds, text_x, at_y + _itemTextPaddingY, _font, text_color, outline_color,
+            layout.DrawText.GetCStr());
     }
     ds->SetClip(old_clip);
 }
@@ -284,12 +279,17 @@ int GUIListBox::InsertItem(int index, const String &text)
     if (index < 0 || static_cast<uint32_t>(index) > _items.size())
         return -1;
 
+    const bool arrows_shown = AreArrowsShown();
     _items.insert(_items.begin() + index, text);
     _savedGameIndex.insert(_savedGameIndex.begin() + index, -1);
+    _itemLayouts.emplace(_itemLayouts.begin() + index);
     if (_selectedItem >= index)
+    {
         _selectedItem++;
+        MarkChanged();
+    }
 
-    MarkChanged();
+    MarkItemsChanged(index, arrows_shown);
     return _items.size() - 1;
 }
 
@@ -298,14 +298,19 @@ void GUIListBox::RemoveItem(int index)
     if (index < 0 || static_cast<uint32_t>(index) >= _items.size())
         return;
 
+    const bool arrows_shown = AreArrowsShown();
     _items.erase(_items.begin() + index);
     _savedGameIndex.erase(_savedGameIndex.begin() + index);
+    _itemLayouts.erase(_itemLayouts.begin() + index);
 
+    const int old_selected = _selectedItem;
     if (_selectedItem > index)
         _selectedItem--;
-    if (_selectedItem >= _items.size())
+    if (_selectedItem >= static_cast<int>(_items.size()))
         _selectedItem = -1;
-    MarkChanged();
+    if (_selectedItem != old_selected)
+        MarkChanged();
+    MarkItemsChanged(index, arrows_shown);
 }
 
 void GUIListBox::SortItems(bool nocase, bool locale_aware, bool ascending)
@@ -315,6 +320,8 @@ void GUIListBox::SortItems(bool nocase, bool locale_aware, bool ascending)
         std::sort(_items.begin(), _items.end(), str_less);
     else
         std::sort(_items.rbegin(), _items.rend(), str_less);
+    InvalidateItemLayouts();
+    MarkChanged();
 }
 
 void GUIListBox::UpdateVisualState()
@@ -322,6 +329,45 @@ void GUIListBox::UpdateVisualState()
     MarkPositionChanged(true);
 }
 
+void GUIListBox::InvalidateItemLayouts()
+{
+    for (auto &layout : _itemLayouts)
+        layout = ItemLayout();
+}
+
+const GUIListBox::ItemLayout &GUIListBox::GetItemLayout(uint32_t index, bool measure)
+{
+    // Drop all the cached layouts if the font or translation mode had changed
+    const int layout_flags = _flags & kGUICtrl_Translated;
+    if ((_layoutFont != _font) || (_layoutFlags != layout_flags))
+    {
+        InvalidateItemLayouts();
+        _layoutFont = _font;
+        _layoutFlags = layout_flags;
+    }
+
+    ItemLayout &layout = _itemLayouts[index];
+    if (!layout.Prepared)
+    {
+        PrepareTextToDraw(_items[index]);
+        layout.DrawText = _textToDraw;
+        layout.Width = -1;
+        layout.Prepared = true;
+    }
+    if (measure && (layout.Width < 0))
+        layout.Width = get_text_width_outlined(layout.DrawText.GetCStr(), _font);
+    return layout;
+}
+
+void GUIListBox::MarkItemsChanged(uint32_t index, bool arrows_were_shown)
+{
+    // Items below the visible range do not require a redraw,
+    // unless this changes the scrollbar's visibility
+    if ((_visibleItemCount == 0) || (index < _topItem + _visibleItemCount) ||
+        (arrows_were_shown != AreArrowsShown()))
+        MarkChanged();
+}
+
 void GUIListBox::SetShowArrows(bool on)
 {
     if (on != ((_listBoxFlags & kListBox_ShowArrows) != 0))
@@ -345,7 +391,8 @@ void GUIListBox::SetItemText(int index, const String &text)
     if ((index >= 0) && (static_cast<uint32_t>(index) < _items.size()) && (text != _items[index]))
     {
         _items[index] = text;
-        MarkChanged();
+        _itemLayouts[index] = ItemLayout();
+        MarkItemsChanged(index, AreArrowsShown());
     }
 }
 
@@ -399,6 +446,7 @@ void GUIListBox::OnContentRectChanged()
 
 void GUIListBox::OnTextFontChanged()
 {
+    InvalidateItemLayouts();
     UpdateMetrics();
 }
 
@@ -510,6 +558,7 @@ void GUIListBox::ReadFromFile(Stream *in, GuiVersion gui_version)
     // ListBox contents at design-time, although Editor does not support it as of 3.5.0.
     _items.resize(item_count);
     _savedGameIndex.resize(item_count, -1);
+    _itemLayouts.assign(item_count, ItemLayout());
     for (uint32_t i = 0; i < item_count; ++i)
     {
         _items[i].Read(in);
@@ -569,6 +618,7 @@ void GUIListBox::ReadFromSavegame(Stream *in, GuiSvgVersion svg_ver)
     const uint32_t item_count = in->ReadInt32();
     _items.resize(item_count);
     _savedGameIndex.resize(item_count);
+    _itemLayouts.assign(item_count, ItemLayout());
     for (uint32_t i = 0; i < item_count; ++i)
         _items[i] = StrUtil::ReadString(in);
     // TODO: investigate this, it might be unreasonable to save and read
@@ -73,6 +73,10 @@ public:
     void RemoveItem(int index);
     void SortItems(bool nocase, bool locale_aware, bool ascending);
     void UpdateVisualState() override;
+    // Drops cached item layouts (prepared text and sizes), making them
+    // recalculate when the items are drawn next time; this should be
+    // called whenever the translation or font metrics change
+    void InvalidateItemLayouts();
 
     // Events
     bool OnMouseDown() override;
@@ -100,6 +104,21 @@ private:
     // Applies translation
     void PrepareTextToDraw(const String &text);
 
+    // Cached layout of a single item
+    struct ItemLayout
+    {
+        String DrawText; // prepared (translated) text
+        int    Width = -1; // text width, -1 if not measured yet
+        bool   Prepared = false; // whether DrawText is valid
+    };
+
+    // Returns item's layout, preparing its text if it's not cached yet;
+    // optionally measures the text width
+    const ItemLayout &GetItemLayout(uint32_t index, bool measure);
+    // Marks the control for redraw after the item at the given index was
+    // added, removed or changed, but only if it may affect the visible region
+    void MarkItemsChanged(uint32_t index, bool arrows_were_shown);
+
     static const color_t DefaultTextColor = 0;
     static const color_t DefaultSelectFgColor = 7;
     static const color_t DefaultSelectBgColor = 7;
@@ -115,6 +134,11 @@ private:
     std::vector<String>     _items;
     // CHECKME: why int16?
     std::vector<int16_t>    _savedGameIndex;
+    // Per-item layout cache, parallel to _items
+    std::vector<ItemLayout> _itemLayouts;
+    // Font and flags which the cached layouts were made for
+    int                     _layoutFont = -1;
+    int                     _layoutFlags = 0;
     int                     _selectedItem = -1;
     int                     _topItem = 0;
     Point                   _mousePos;
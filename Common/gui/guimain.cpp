@@ -249,6 +249,20 @@ void GUIMain::MarkChanged()
 void GUIMain::MarkControlChanged()
 {
     _hasControlsChanged = true;
+    _allControlsChanged = true;
+}
+
+void GUIMain::MarkControlChanged(int objid)
+{
+    if ((objid < 0) || (static_cast<size_t>(objid) >= _controls.size()))
+    {
+        MarkControlChanged();
+        return;
+    }
+    _hasControlsChanged = true;
+    if (_ctrlChanged.size() != _controls.size())
+        _ctrlChanged.resize(_controls.size());
+    _ctrlChanged[objid] = true;
 }
 
 void GUIMain::NotifyControlPosition()
@@ -256,14 +270,17 @@ void GUIMain::NotifyControlPosition()
     // Force it to re-check for which control is under the mouse
     _mouseWasAt.X = -1;
     _mouseWasAt.Y = -1;
-    _hasControlsChanged = true; // for software render, and in case of shape change
+    // for software render, and in case of shape change
+    _hasControlsChanged = true;
+    _allControlsChanged = true;
 }
 
 void GUIMain::NotifyControlState(int objid, bool mark_changed)
 {
     _mouseWasAt.X = -1;
     _mouseWasAt.Y = -1;
-    _hasControlsChanged |= mark_changed;
+    if (mark_changed)
+        MarkControlChanged(objid);
     // Update cursor-over-control state, if necessary
     const int overctrl = _mouseOverCtrl;
     if (!_polling &&
@@ -281,6 +298,8 @@ void GUIMain::ClearChanged()
 {
     _hasChanged = false;
     _hasControlsChanged = false;
+    _allControlsChanged = false;
+    _ctrlChanged.assign(_controls.size(), false);
 }
 
 void GUIMain::ResetOverControl()
@@ -311,6 +330,11 @@ bool GUIMain::BringControlToFront(int index)
 }
 
 void GUIMain::DrawSelf(Bitmap *ds)
+{
+    DrawSelf(ds, RectWH(0, 0, ds->GetWidth(), ds->GetHeight()));
+}
+
+void GUIMain::DrawSelf(Bitmap *ds, const Rect &frame)
 {
     set_our_eip(375);
 
@@ -326,7 +350,7 @@ void GUIMain::DrawSelf(Bitmap *ds)
         _fgColor = 16;
 
     if (_bgColor != 0)
-        ds->Fill(ds->GetCompatibleColor(_bgColor));
+        ds->FillRect(frame, ds->GetCompatibleColor(_bgColor));
 
     set_our_eip(377);
 
@@ -334,15 +358,15 @@ void GUIMain::DrawSelf(Bitmap *ds)
     if (_fgColor != _bgColor)
     {
         draw_color = ds->GetCompatibleColor(_fgColor);
-        ds->DrawRect(Rect(0, 0, ds->GetWidth() - 1, ds->GetHeight() - 1), draw_color);
+        ds->DrawRect(frame, draw_color);
         if (get_fixed_pixel_size(1) > 1)
-            ds->DrawRect(Rect(1, 1, ds->GetWidth() - 2, ds->GetHeight() - 2), draw_color);
+            ds->DrawRect(Rect(frame.Left + 1, frame.Top + 1, frame.Right - 1, frame.Bottom - 1), draw_color);
     }
 
     set_our_eip(378);
 
     if (_bgImage > 0 && spriteset.DoesSpriteExist(_bgImage))
-        draw_gui_sprite(ds, _bgImage, 0, 0, false);
+        draw_gui_sprite(ds, _bgImage, frame.Left, frame.Top, false);
 
     set_our_eip(379);
 }
@@ -356,8 +380,82 @@ void GUIMain::DrawWithControls(Bitmap *ds)
 
 void GUIMain::DrawControls(Bitmap *ds)
 {
+    DrawControls(ds, 0, 0, nullptr);
+}
+
+Rect GUIMain::CalcControlGraphicRect(GUIObject *obj) const
+{
+    const Rect rc = obj->CalcGraphicRect(GUI::Options.ClipControls && obj->IsContentClipped());
+    return Rect::MoveBy(rc, obj->GetX(), obj->GetY());
+}
+
+bool GUIMain::CalcDirtyRegions(std::vector<Rect> &rects)
+{
+    rects.clear();
+    if (_hasChanged || _allControlsChanged ||
+        (_ctrlDrawnRects.size() != _controls.size()) || (_ctrlChanged.size() != _controls.size()))
+        return false;
+
+    const Rect gui_rc = RectWH(0, 0, _width, _height);
+    const bool skip_controls = GUI::ShouldSkipControls(this);
+    for (size_t i = 0; i < _controls.size(); ++i)
+    {
+        if (!_ctrlChanged[i])
+            continue;
+        // Erase the control's old graphic, and draw the new one
+        Rect dirty[2];
+        dirty[0] = _ctrlDrawnRects[i];
+        GUIObject *obj = _controls[i];
+        if (!skip_controls && GUI::IsGUIVisible(obj) && !obj->GetSize().IsNull())
+            dirty[1] = CalcControlGraphicRect(obj);
+        for (auto rc : dirty)
+        {
+            rc = IntersectRects(rc, gui_rc);
+            if (rc.IsEmpty())
+                continue;
+            // Merge with any intersecting region, and repeat until there are no more
+            for (size_t r = 0; r < rects.size();)
+            {
+                if (AreRectsIntersecting(rects[r], rc))
+                {
+                    rc = SumRects(rects[r], rc);
+                    rects.erase(rects.begin() + r);
+                    r = 0;
+                }
+                else
+                {
+                    ++r;
+                }
+            }
+            rects.push_back(rc);
+        }
+    }
+
+    // If the damage covers most of the GUI, then it's simpler to redraw it whole
+    int dirty_area = 0;
+    for (const auto &rc : rects)
+        dirty_area += rc.GetWidth() * rc.GetHeight();
+    return dirty_area <= (_width * _height) / 2;
+}
+
+void GUIMain::DrawRegion(Bitmap *ds, const Rect &rc)
+{
+    // Draw on a sub-bitmap, which ensures that neither the GUI
+    // nor the controls can draw anything outside of this region
+    Bitmap sub_ds(ds, rc);
+    sub_ds.ClearTransparent();
+    DrawSelf(&sub_ds, RectWH(-rc.Left, -rc.Top, _width, _height));
+    DrawControls(&sub_ds, -rc.Left, -rc.Top, &rc);
+}
+
+void GUIMain::DrawControls(Bitmap *ds, int x, int y, const Rect *region)
+{
+    _ctrlDrawnRects.resize(_controls.size());
     if (GUI::ShouldSkipControls(this))
+    {
+        std::fill(_ctrlDrawnRects.begin(), _ctrlDrawnRects.end(), Rect());
         return; // don't draw GUI controls
+    }
 
     Bitmap tempbmp; // in case we need transforms
     for (size_t ctrl_index = 0; ctrl_index < _controls.size(); ++ctrl_index)
@@ -366,22 +464,30 @@ void GUIMain::DrawControls(Bitmap *ds)
 
         GUIObject *objToDraw = _controls[_ctrlDrawOrder[ctrl_index]];
         Size obj_size = objToDraw->GetSize();
+        Rect &drawn_rc = _ctrlDrawnRects[_ctrlDrawOrder[ctrl_index]];
 
         // Note that the control is invisible not only when Visible property is false,
         // but also according to a combination of being disabled and some disabled gui modes
-        if (!GUI::IsGUIVisible(objToDraw))
-            continue;
         // Control's size is empty, no sense in drawing it
-        if (obj_size.IsNull())
+        if (!GUI::IsGUIVisible(objToDraw) || obj_size.IsNull())
+        {
+            drawn_rc = Rect();
+            continue;
+        }
+
+        // Remember which part of GUI this control covers, and skip it
+        // if it's not in the redrawn region
+        drawn_rc = CalcControlGraphicRect(objToDraw);
+        if (region && !AreRectsIntersecting(*region, drawn_rc))
             continue;
 
         if (GUI::Options.ClipControls && objToDraw->IsContentClipped())
-            ds->SetClip(objToDraw->GetRect());
+            ds->SetClip(Rect::MoveBy(objToDraw->GetRect(), x, y));
         else
             ds->ResetClip();
 
-        const int objx = objToDraw->GetX();
-        const int objy = objToDraw->GetY();
+        const int objx = objToDraw->GetX() + x;
+        const int objy = objToDraw->GetY() + y;
 
         // Depending on draw properties - draw directly on the gui surface, or use a buffer
         if (objToDraw->GetTransparency() == 0)
@@ -392,7 +498,7 @@ void GUIMain::DrawControls(Bitmap *ds)
         }
         else
         {
-            const Rect rc = objToDraw->CalcGraphicRect(GUI::Options.ClipControls && objToDraw->IsContentClipped());
+            const Rect rc = Rect::MoveBy(drawn_rc, -objToDraw->GetX(), -objToDraw->GetY());
             tempbmp.CreateTransparent(rc.GetWidth(), rc.GetHeight());
             objToDraw->Draw(&tempbmp, -rc.Left, -rc.Top);
             draw_gui_sprite(ds, true, objx + rc.Left, objy + rc.Top,
@@ -172,6 +172,9 @@ public:
     void    MarkChanged();
     // Marks GUI as having any of its controls changed its looks.
     void    MarkControlChanged();
+    // Marks GUI as having a particular control changed its looks,
+    // identified by the control's child index.
+    void    MarkControlChanged(int objid);
     // Clears changed flag
     void    ClearChanged();
     // Notify GUI about any of its controls changing its location.
@@ -210,6 +213,13 @@ public:
     void    DrawSelf(Bitmap *ds);
     void    DrawWithControls(Bitmap *ds);
     void    DrawControls(Bitmap *ds);
+    // Calculates regions of the GUI surface which have to be redrawn after
+    // some of the controls changed their looks. Returns false if the whole
+    // surface must be redrawn instead.
+    bool    CalcDirtyRegions(std::vector<Rect> &rects);
+    // Redraws the given region of the GUI surface, along with the parts
+    // of the controls that intersect it
+    void    DrawRegion(Bitmap *ds, const Rect &rc);
     // Polls GUI state, providing current cursor (mouse) coordinates
     void    Poll(int mx, int my);
     // Reconnects this GUIMain with the child controls from the global guiobject collection
@@ -252,6 +262,13 @@ public:
 
 private:
     void    DrawBlob(Bitmap *ds, int x, int y, color_t draw_color);
+    // Draws GUI's own graphics, placing GUI's frame at the given position
+    void    DrawSelf(Bitmap *ds, const Rect &frame);
+    // Draws controls, offsetting them by the given x,y; optionally only
+    // draws the ones which graphically intersect the given region
+    void    DrawControls(Bitmap *ds, int x, int y, const Rect *region);
+    // Calculates the rectangle covered by the control's graphics, in GUI's coordinates
+    Rect    CalcControlGraphicRect(GUIObject *obj) const;
     // Same as FindControlAt but expects local space coordinates
     int     FindControlAtLocal(int atx, int aty, int leeway, bool must_be_clickable) const;
 
@@ -288,6 +305,7 @@ private:
     int     _flags = kGUIMain_DefFlags; // style and behavior flags
     bool    _hasChanged = false; // flag tells whether GUI has graphically changed recently
     bool    _hasControlsChanged = false; // flag tells that GUI controls have changed position or image
+    bool    _allControlsChanged = false; // flag tells that changes cannot be narrowed to particular controls
     bool    _polling = false;   // inside the polling process
 
     // Array of types and control indexes in global GUI object arrays;
@@ -297,6 +315,11 @@ private:
     std::vector<GUIObject*> _controls;
     // Sorted array of controls in z-order.
     std::vector<int>        _ctrlDrawOrder;
+    // Per-control flags telling which controls changed their looks since the last redraw
+    std::vector<bool>       _ctrlChanged;
+    // Per-control rectangles covered by their graphics when they were last drawn,
+    // in GUI's coordinates; used to know which part of GUI has to be redrawn
+    std::vector<Rect>       _ctrlDrawnRects;
 };
 
 
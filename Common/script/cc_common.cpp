@@ -19,12 +19,13 @@
 using namespace AGS::Common;
 
 // FIXME: refactor, get rid of these global vars!
+// They are thread-local in the standalone compiler (see AGS_CC_THREADLOCAL).
 //
-int ccCompOptions = SCOPT_LEFTTORIGHT;
+CC_THREAD_LOCAL int ccCompOptions = SCOPT_LEFTTORIGHT;
 // currently compiled or executed line
-int currentline;
+CC_THREAD_LOCAL int currentline;
 // name of currently compiling script or script section
-std::string ccCurScriptName;
+CC_THREAD_LOCAL std::string ccCurScriptName;
 
 void ccSetOption(int optbit, int onoroff)
 {
@@ -45,7 +46,7 @@ int ccGetOption(int optbit)
 // Returns current running script callstack as a human-readable text
 extern String cc_get_callstack(int max_lines = INT_MAX);
 
-static ScriptError ccError;
+static CC_THREAD_LOCAL ScriptError ccError;
 
 void cc_clear_error()
 {
@@ -61,9 +61,21 @@ void cc_error(const ScriptError &err);
 // Project-dependent script error formatting
 AGS::Common::String cc_format_error(const AGS::Common::String &message);
 
+// The standalone compiler may compile several scripts in parallel, and
+// builds with AGS_CC_THREADLOCAL to keep this state per thread;
+// the engine and the rest keep plain globals.
+#if !defined(AGS_CC_THREADLOCAL)
+#define AGS_CC_THREADLOCAL (0)
+#endif
+#if AGS_CC_THREADLOCAL
+#define CC_THREAD_LOCAL thread_local
+#else
+#define CC_THREAD_LOCAL
+#endif
+
 // currently compiled or executed line
-extern int currentline;
+extern CC_THREAD_LOCAL int currentline;
 // name of currently compiling script or script section
-extern std::string ccCurScriptName;
+extern CC_THREAD_LOCAL std::string ccCurScriptName;
 
 #endif // __CC_ERROR_H
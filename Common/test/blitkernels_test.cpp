@@ -0,0 +1,155 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2026 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <aastr.h>
+#include "gtest/gtest.h"
+#include "gfx/allegrobitmap.h"
+#include "gfx/blitkernels.h"
+#include "test/gfx_test_helper.h"
+
+using namespace AGS::Common;
+
+struct StretchTestCase
+{
+    int SrcW, SrcH;
+    int DstX, DstY, DstW, DstH;
+    Rect Clip;
+};
+
+const StretchTestCase StretchTestCases[] = {
+    { 37, 23, 0, 0, 100, 77, RectWH(0, 0, 120, 100) }, // magnify
+    { 120, 90, 5, 7, 41, 33, RectWH(0, 0, 120, 100) }, // minify
+    { 64, 64, 0, 0, 64, 64, RectWH(0, 0, 120, 100) }, // same size
+    { 50, 20, 10, -5, 13, 80, RectWH(0, 0, 120, 100) }, // mixed
+    { 3, 3, -30, -20, 250, 250, RectWH(11, 13, 80, 60) }, // large factor, clipped
+    { 90, 70, -10, 20, 140, 95, RectWH(20, 10, 70, 60) }, // partially outside, clipped
+    { 320, 200, 0, 0, 120, 100, RectWH(0, 0, 120, 100) }, // large minify
+};
+
+enum StretchKind { kStretch_Nearest, kStretch_AA };
+
+static void TestStretch(StretchKind kind, int depth)
+{
+    for (const auto &test : StretchTestCases)
+    {
+        for (int masked = 0; masked < 2; ++masked)
+        {
+            Bitmap src(test.SrcW, test.SrcH, depth);
+            FillRandom(src, test.SrcW * 31 + test.SrcH);
+            Bitmap expect(120, 100, depth), actual(120, 100, depth);
+            FillRandom(expect, 7);
+            FillRandom(actual, 7);
+            expect.SetClip(test.Clip);
+            actual.SetClip(test.Clip);
+
+            BITMAP *al_src = src.GetAllegroBitmap();
+            BITMAP *al_expect = expect.GetAllegroBitmap();
+            BITMAP *al_actual = actual.GetAllegroBitmap();
+            bool handled;
+            if (kind == kStretch_Nearest)
+            {
+                if (masked)
+                    masked_stretch_blit(al_src, al_expect, 0, 0, test.SrcW, test.SrcH, test.DstX, test.DstY, test.DstW, test.DstH);
+                else
+                    stretch_blit(al_src, al_expect, 0, 0, test.SrcW, test.SrcH, test.DstX, test.DstY, test.DstW, test.DstH);
+                handled = BlitKernels::StretchBlit(al_src, al_actual, 0, 0, test.SrcW, test.SrcH,
+                    test.DstX, test.DstY, test.DstW, test.DstH, masked != 0);
+            }
+            else
+            {
+                if (masked)
+                    aa_stretch_sprite(al_expect, al_src, test.DstX, test.DstY, test.DstW, test.DstH);
+                else
+                    aa_stretch_blit(al_src, al_expect, 0, 0, test.SrcW, test.SrcH, test.DstX, test.DstY, test.DstW, test.DstH);
+                handled = BlitKernels::AAStretchBlit(al_src, al_actual, 0, 0, test.SrcW, test.SrcH,
+                    test.DstX, test.DstY, test.DstW, test.DstH, masked != 0);
+            }
+            ASSERT_TRUE(handled);
+            ASSERT_TRUE(AreEqual(expect, actual)) << "depth " << depth << ", masked " << masked
+                << ", " << test.SrcW << "x" << test.SrcH << " -> " << test.DstW << "x" << test.DstH;
+        }
+    }
+}
+
+TEST(BlitKernels, StretchBlit) {
+    TestStretch(kStretch_Nearest, 15);
+    TestStretch(kStretch_Nearest, 16);
+    TestStretch(kStretch_Nearest, 32);
+}
+
+TEST(BlitKernels, AAStretchBlit) {
+    TestStretch(kStretch_AA, 15);
+    TestStretch(kStretch_AA, 16);
+    TestStretch(kStretch_AA, 32);
+}
+
+TEST(BlitKernels, UnsupportedFormats) {
+    Bitmap src8(10, 10, 8), dst8(20, 20, 8), dst32(20, 20, 32);
+    ASSERT_FALSE(BlitKernels::StretchBlit(src8.GetAllegroBitmap(), dst8.GetAllegroBitmap(), 0, 0, 10, 10, 0, 0, 20, 20, false));
+    ASSERT_FALSE(BlitKernels::AAStretchBlit(src8.GetAllegroBitmap(), dst32.GetAllegroBitmap(), 0, 0, 10, 10, 0, 0, 20, 20, false));
+    ASSERT_FALSE(BlitKernels::StretchBlit(dst32.GetAllegroBitmap(), dst32.GetAllegroBitmap(), 0, 0, 10, 10, 0, 0, 20, 20, false));
+}
+
+TEST(BlitKernels, RotateBlit) {
+    // Allegro's fixed point math reports overflows through allegro_errno
+    install_allegro(SYSTEM_NONE, &errno, atexit);
+    const int angles[] = { 0, 17, 45, 90, 133, 200, 359 };
+    for (int depth : { 16, 32 })
+    {
+        Bitmap src(300, 200, depth);
+        FillRandom(src, 5);
+        for (int angle : angles)
+        {
+            Bitmap expect(400, 400, depth), actual(400, 400, depth);
+            FillRandom(expect, 9);
+            FillRandom(actual, 9);
+            expect.SetClip(RectWH(5, 3, 390, 380));
+            actual.SetClip(RectWH(5, 3, 390, 380));
+            rotate_sprite(expect.GetAllegroBitmap(), src.GetAllegroBitmap(), 50, 100, itofix((angle * 256) / 360));
+            actual.RotateBlt(&src, 50, 100, angle);
+            ASSERT_TRUE(AreEqual(expect, actual)) << "depth " << depth << ", angle " << angle;
+        }
+    }
+
+    // Sprite of a different color depth is converted, and drawn without splitting
+    Bitmap src(300, 200, 16), expect(400, 400, 32), actual(400, 400, 32);
+    FillRandom(src, 5);
+    FillRandom(expect, 9);
+    FillRandom(actual, 9);
+    rotate_sprite(expect.GetAllegroBitmap(), src.GetAllegroBitmap(), 50, 100, itofix(32));
+    actual.RotateBlt(&src, 50, 100, 45);
+    ASSERT_TRUE(AreEqual(expect, actual));
+}
+
+// Compares the results of the original and optimized implementations
+// on an image which is large enough to be processed in parallel
+TEST(BlitKernels, StretchParallel) {
+    for (int depth : { 16, 32 })
+    {
+        Bitmap src(320, 180, depth), expect(960, 540, depth), actual(960, 540, depth);
+        FillRandom(src, 3);
+        BITMAP *al_src = src.GetAllegroBitmap();
+        BITMAP *al_expect = expect.GetAllegroBitmap();
+        BITMAP *al_actual = actual.GetAllegroBitmap();
+
+        masked_stretch_blit(al_src, al_expect, 0, 0, 320, 180, 0, 0, 960, 540);
+        ASSERT_TRUE(BlitKernels::StretchBlit(al_src, al_actual, 0, 0, 320, 180, 0, 0, 960, 540, true));
+        ASSERT_TRUE(AreEqual(expect, actual)) << "depth " << depth;
+        aa_stretch_sprite(al_expect, al_src, 0, 0, 960, 540);
+        ASSERT_TRUE(BlitKernels::AAStretchBlit(al_src, al_actual, 0, 0, 320, 180, 0, 0, 960, 540, true));
+        ASSERT_TRUE(AreEqual(expect, actual)) << "depth " << depth;
+    }
+}
@@ -0,0 +1,64 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2026 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+//
+// Helper functions for testing graphic operations on bitmaps.
+//
+//=============================================================================
+#ifndef __AGS_CN_TEST__GFXTESTHELPER_H
+#define __AGS_CN_TEST__GFXTESTHELPER_H
+
+#include <string.h>
+#include "gfx/allegrobitmap.h"
+
+namespace AGS
+{
+namespace Common
+{
+
+// Fills 16-bit or 32-bit bitmap with pseudo-random pixels,
+// making some of them transparent
+inline void FillRandom(Bitmap &bmp, uint32_t seed)
+{
+    BITMAP *al_bmp = bmp.GetAllegroBitmap();
+    const int mask_color = bitmap_mask_color(al_bmp);
+    for (int y = 0; y < bmp.GetHeight(); ++y)
+    {
+        for (int x = 0; x < bmp.GetWidth(); ++x)
+        {
+            seed = seed * 1664525u + 1013904223u;
+            const int c = ((seed >> 24) % 4 == 0) ? mask_color : static_cast<int>(seed >> 8);
+            if (bmp.GetColorDepth() == 32)
+                reinterpret_cast<uint32_t*>(al_bmp->line[y])[x] = static_cast<uint32_t>(c);
+            else
+                reinterpret_cast<uint16_t*>(al_bmp->line[y])[x] = static_cast<uint16_t>(c);
+        }
+    }
+}
+
+// Tells if two bitmaps of the same size and format have equal pixels
+inline bool AreEqual(const Bitmap &a, const Bitmap &b)
+{
+    const size_t row_size = a.GetWidth() * a.GetBPP();
+    for (int y = 0; y < a.GetHeight(); ++y)
+    {
+        if (memcmp(a.GetScanLine(y), b.GetScanLine(y), row_size) != 0)
+            return false;
+    }
+    return true;
+}
+
+} // namespace Common
+} // namespace AGS
+
+#endif // __AGS_CN_TEST__GFXTESTHELPER_H
@@ -12,8 +12,16 @@
 //
 //=============================================================================
 #include <array>
+#include <chrono>
+#include <cstdio>
+#include <vector>
 #include "gtest/gtest.h"
+#include "ac/gamestructdefines.h"
+#include "ac/spritecache.h"
+#include "gfx/bitmap.h"
+#include "gui/guilistbox.h"
 #include "gui/guimain.h"
+#include "test/gfx_test_helper.h"
 
 using namespace AGS::Common;
 
@@ -73,3 +81,178 @@ TEST(GUI, LabelMacros) {
         ASSERT_TRUE(res2 == test.Output) << "input text: " << test.Input.GetCStr();
     }
 }
+
+TEST(GUI, ListBoxLargeContents) {
+    GUI::DataVersion = kGameVersion_Current;
+    GUI::GameGuiVersion = kGuiVersion_Current;
+
+    const int item_count = 10000;
+    GUIListBox list;
+    list.SetSize(200, 100);
+
+    // Appending items
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < item_count; ++i)
+        list.AddItem(String::FromFormat("Item %d", i));
+    auto end = std::chrono::steady_clock::now();
+    printf("ListBox: add %d items: %.3f ms\n", item_count,
+        std::chrono::duration<double, std::milli>(end - start).count());
+    ASSERT_EQ(list.GetItemCount(), static_cast<uint32_t>(item_count));
+    ASSERT_STREQ(list.GetItem(0).GetCStr(), "Item 0");
+    ASSERT_STREQ(list.GetItem(item_count - 1).GetCStr(), "Item 9999");
+
+    // Scrolling through the whole list
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < item_count; ++i)
+        list.SetTopItem(i);
+    end = std::chrono::steady_clock::now();
+    printf("ListBox: scroll %d items: %.3f ms\n", item_count,
+        std::chrono::duration<double, std::milli>(end - start).count());
+    ASSERT_EQ(list.GetTopItem(), item_count - 1);
+
+    // Inserting and removing items in front, keeping selection on the same item
+    list.SetSelectedItem(item_count / 2);
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 100; ++i)
+        list.InsertItem(0, String::FromFormat("New %d", i));
+    for (int i = 0; i < 50; ++i)
+        list.RemoveItem(0);
+    end = std::chrono::steady_clock::now();
+    printf("ListBox: insert 100 and remove 50 items in front: %.3f ms\n",
+        std::chrono::duration<double, std::milli>(end - start).count());
+    ASSERT_EQ(list.GetItemCount(), static_cast<uint32_t>(item_count + 50));
+    ASSERT_STREQ(list.GetItem(0).GetCStr(), "New 49");
+    ASSERT_STREQ(list.GetItem(50).GetCStr(), "Item 0");
+    ASSERT_EQ(list.GetSelectedItem(), item_count / 2 + 50);
+    ASSERT_STREQ(list.GetItem(list.GetSelectedItem()).GetCStr(), "Item 5000");
+
+    // Changing and removing the last items
+    list.SetItemText(list.GetItemCount() - 1, "Last");
+    ASSERT_STREQ(list.GetItem(list.GetItemCount() - 1).GetCStr(), "Last");
+    list.RemoveItem(list.GetItemCount() - 1);
+    ASSERT_STREQ(list.GetItem(list.GetItemCount() - 1).GetCStr(), "Item 9998");
+
+    list.Clear();
+    ASSERT_EQ(list.GetItemCount(), 0u);
+}
+
+// A simple control, which fills its whole rectangle with its background color
+class GUIFillControl : public GUIObject
+{
+public:
+    void Draw(Bitmap *ds, int x, int y) override
+    {
+        ds->FillRect(RectWH(x, y, _width, _height), _backgroundColor);
+    }
+};
+
+static bool IsRectWH(const Rect &rc, int x, int y, int width, int height)
+{
+    return (rc.Left == x) && (rc.Top == y) && (rc.GetWidth() == width) && (rc.GetHeight() == height);
+}
+
+TEST(GUI, DirtyRegions) {
+    GUI::DataVersion = kGameVersion_Current;
+    GUI::GameGuiVersion = kGuiVersion_Current;
+    std::vector<SpriteInfo> spr_infos;
+    SpriteCache spriteset(spr_infos, SpriteCache::Callbacks());
+    GUI::Context.Spriteset = &spriteset;
+
+    GUIMain gui;
+    gui.SetSize(100, 100);
+    gui.SetBgColor(1);
+    gui.SetFgColor(1);
+    GUIFillControl ctrl[2];
+    ctrl[0].SetPosition(10, 10);
+    ctrl[0].SetSize(20, 20);
+    ctrl[0].SetBackColor(2);
+    ctrl[1].SetPosition(60, 60);
+    ctrl[1].SetSize(20, 20);
+    ctrl[1].SetBackColor(3);
+    for (int i = 0; i < 2; ++i)
+    {
+        ctrl[i].SetID(i);
+        ctrl[i].SetVisible(true);
+        gui.AddControl(kGUIButton, i, &ctrl[i]);
+    }
+    gui.ResortZOrder();
+
+    Bitmap surface(100, 100, 8);
+    Bitmap reference(100, 100, 8);
+    gui.DrawWithControls(&surface);
+    gui.ClearChanged();
+    std::vector<Rect> rects;
+
+    // Nothing changed, nothing to redraw
+    ASSERT_TRUE(gui.CalcDirtyRegions(rects));
+    ASSERT_TRUE(rects.empty());
+
+    // Control changed its looks in place
+    ctrl[0].SetBackColor(4);
+    gui.MarkControlChanged(0);
+    ASSERT_TRUE(gui.CalcDirtyRegions(rects));
+    ASSERT_EQ(rects.size(), 1u);
+    ASSERT_TRUE(IsRectWH(rects[0], 10, 10, 20, 20));
+    for (const auto &rc : rects)
+        gui.DrawRegion(&surface, rc);
+    gui.ClearChanged();
+    gui.DrawWithControls(&reference);
+    ASSERT_TRUE(AreEqual(surface, reference));
+
+    // Control's old and new graphics do not intersect: two separate regions
+    ctrl[0].SetPosition(30, 30);
+    gui.MarkControlChanged(0);
+    ASSERT_TRUE(gui.CalcDirtyRegions(rects));
+    ASSERT_EQ(rects.size(), 2u);
+    ASSERT_TRUE(IsRectWH(rects[0], 10, 10, 20, 20));
+    ASSERT_TRUE(IsRectWH(rects[1], 30, 30, 20, 20));
+    for (const auto &rc : rects)
+        gui.DrawRegion(&surface, rc);
+    gui.ClearChanged();
+    gui.DrawWithControls(&reference);
+    ASSERT_TRUE(AreEqual(surface, reference));
+
+    // Intersecting regions are merged, including the other control's ones
+    ctrl[0].SetPosition(45, 45);
+    ctrl[1].SetBackColor(5);
+    gui.MarkControlChanged(0);
+    gui.MarkControlChanged(1);
+    ASSERT_TRUE(gui.CalcDirtyRegions(rects));
+    ASSERT_EQ(rects.size(), 1u);
+    ASSERT_TRUE(IsRectWH(rects[0], 30, 30, 50, 50));
+    for (const auto &rc : rects)
+        gui.DrawRegion(&surface, rc);
+    gui.ClearChanged();
+    gui.DrawWithControls(&reference);
+    ASSERT_TRUE(AreEqual(surface, reference));
+
+    // Hidden control only has to be erased
+    ctrl[1].SetVisible(false);
+    gui.MarkControlChanged(1);
+    ASSERT_TRUE(gui.CalcDirtyRegions(rects));
+    ASSERT_EQ(rects.size(), 1u);
+    ASSERT_TRUE(IsRectWH(rects[0], 60, 60, 20, 20));
+    for (const auto &rc : rects)
+        gui.DrawRegion(&surface, rc);
+    gui.ClearChanged();
+    gui.DrawWithControls(&reference);
+    ASSERT_TRUE(AreEqual(surface, reference));
+
+    // Damage covering most of the GUI requires a full redraw
+    ctrl[0].SetPosition(0, 0);
+    ctrl[0].SetSize(90, 90);
+    gui.MarkControlChanged(0);
+    ASSERT_FALSE(gui.CalcDirtyRegions(rects));
+    gui.DrawWithControls(&surface);
+    gui.ClearChanged();
+
+    // Changes which cannot be narrowed down require a full redraw
+    gui.MarkControlChanged();
+    ASSERT_FALSE(gui.CalcDirtyRegions(rects));
+    gui.ClearChanged();
+    gui.MarkChanged();
+    ASSERT_FALSE(gui.CalcDirtyRegions(rects));
+    gui.ClearChanged();
+
+    GUI::Context.Spriteset = nullptr;
+}
@@ -0,0 +1,101 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2026 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+#include <memory>
+#include <string>
+#if !defined(AGS_DISABLE_THREADS)
+#include <thread>
+#endif
+#include <vector>
+#include "gtest/gtest.h"
+#include "debug/profiler.h"
+#include "util/memory_compat.h"
+#include "util/memorystream.h"
+
+using namespace AGS::Common;
+
+static std::string WriteTrace()
+{
+    std::vector<uint8_t> membuf;
+    auto out = std::make_unique<Stream>(
+        std::make_unique<VectorStream>(membuf, kStream_Write));
+    EXPECT_TRUE(Profiler::WriteChromeTrace(out.get()));
+    out.reset();
+    return std::string(membuf.begin(), membuf.end());
+}
+
+static size_t CountSubstr(const std::string &str, const std::string &sub)
+{
+    size_t count = 0u;
+    for (size_t pos = str.find(sub); pos != std::string::npos; pos = str.find(sub, pos + 1))
+        ++count;
+    return count;
+}
+
+TEST(Profiler, ChromeTrace) {
+    Profiler::Clear();
+    Profiler::SetThreadName("Test \"main\"");
+    {
+        ProfileZone outer("Outer");
+        {
+            ProfileZone inner("Inner");
+        }
+    }
+    ASSERT_EQ(Profiler::GetEventCount(), 2u);
+
+    const std::string trace = WriteTrace();
+    ASSERT_EQ(trace.find("{\"traceEvents\":["), 0u);
+    ASSERT_NE(trace.find("\"displayTimeUnit\":\"ms\"}"), std::string::npos);
+    ASSERT_EQ(CountSubstr(trace, "\"ph\":\"X\""), 2u);
+    // Inner zone ends first, and is recorded first
+    const size_t inner_pos = trace.find("\"name\":\"Inner\"");
+    const size_t outer_pos = trace.find("\"name\":\"Outer\"");
+    ASSERT_NE(inner_pos, std::string::npos);
+    ASSERT_NE(outer_pos, std::string::npos);
+    ASSERT_LT(inner_pos, outer_pos);
+    // Thread name is escaped
+    ASSERT_NE(trace.find("\"args\":{\"name\":\"Test \\\"main\\\"\"}"), std::string::npos);
+
+    Profiler::Clear();
+    ASSERT_EQ(Profiler::GetEventCount(), 0u);
+    ASSERT_EQ(CountSubstr(WriteTrace(), "\"ph\":\"X\""), 0u);
+}
+
+#if !defined(AGS_DISABLE_THREADS)
+TEST(Profiler, RingBufferPerThread) {
+    Profiler::Clear();
+    // Only affects the threads which did not record anything yet
+    Profiler::SetThreadBufferSize(16);
+    std::thread worker([]()
+    {
+        Profiler::SetThreadName("Worker");
+        for (int i = 0; i < 100; ++i)
+        {
+            ProfileZone zone("Work");
+        }
+    });
+    worker.join();
+    Profiler::SetThreadBufferSize(Profiler::DefaultThreadBufferSize);
+    {
+        ProfileZone zone("Main");
+    }
+
+    // The worker keeps only the latest events
+    ASSERT_EQ(Profiler::GetEventCount(), 16u + 1u);
+    const std::string trace = WriteTrace();
+    ASSERT_EQ(CountSubstr(trace, "\"name\":\"Work\""), 16u);
+    ASSERT_EQ(CountSubstr(trace, "\"name\":\"Main\""), 1u);
+    ASSERT_NE(trace.find("\"args\":{\"name\":\"Worker\"}"), std::string::npos);
+    Profiler::Clear();
+}
+#endif
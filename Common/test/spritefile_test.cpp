@@ -14,6 +14,7 @@
 #include "gtest/gtest.h"
 #include "ac/gamestructdefines.h"
 #include "ac/spritefile.h"
+#include "util/file.h"
 #include "util/memory_compat.h"
 #include "util/memorystream.h"
 
@@ -108,3 +109,85 @@ TEST(SpriteFileWriter, WriteAndReadMetrics) {
 	ASSERT_EQ(metrics[4].Height, 0);
 	ASSERT_EQ(metrics[10].Height, 10);
 }
+
+TEST(SpriteFile, IndexCache) {
+	std::vector<uint8_t> storage;
+	{
+		auto sfw = std::make_unique<SpriteFileWriter>(
+			std::make_unique<Stream>(std::make_unique<VectorStream>(storage, kStream_Write)));
+		WriteSpriteFile(sfw.get());
+	}
+	const String cache_file = "SpriteIndexCache.dat";
+	File::DeleteFile(cache_file);
+
+	// No index file: index is rebuilt, and written to the cache
+	std::vector<Size> metrics;
+	auto sf = std::make_unique<SpriteFile>();
+	sf->SetIndexCacheFile(cache_file);
+	HError err = sf->OpenFile(std::make_unique<Stream>(std::make_unique<VectorStream>(storage)), nullptr, metrics);
+	ASSERT_TRUE(err);
+	ASSERT_TRUE(File::IsFile(cache_file));
+	ASSERT_EQ(metrics.size(), 11);
+	ASSERT_EQ(metrics[10].Width, 10);
+
+	// Modify the cached width of sprite 1, to tell when the cache is used
+	std::vector<uint8_t> cache_data;
+	{
+		auto in = File::OpenFileRead(cache_file);
+		cache_data.resize(in->GetLength());
+		in->Read(cache_data.data(), cache_data.size());
+	}
+	const size_t cache_header_sz = 28;
+	const size_t index_header_sz = 24;
+	const size_t width1_off = cache_header_sz + index_header_sz + sizeof(int16_t);
+	ASSERT_EQ(cache_data[width1_off], 1);
+	cache_data[width1_off] = 5;
+	{
+		auto out = File::CreateFile(cache_file);
+		out->Write(cache_data.data(), cache_data.size());
+	}
+
+	// Same sprite file: index is read from the cache
+	sf.reset(new SpriteFile());
+	sf->SetIndexCacheFile(cache_file);
+	err = sf->OpenFile(std::make_unique<Stream>(std::make_unique<VectorStream>(storage)), nullptr, metrics);
+	ASSERT_TRUE(err);
+	ASSERT_EQ(sf->GetTopmostSprite(), 10);
+	ASSERT_EQ(metrics[1].Width, 5);
+	ASSERT_EQ(metrics[10].Width, 10);
+	ASSERT_TRUE(sf->DoesSpriteExist(2));
+	ASSERT_FALSE(sf->DoesSpriteExist(3));
+	PixelBuffer pxbuf;
+	ASSERT_TRUE(sf->LoadSprite(10, pxbuf));
+	ASSERT_EQ(pxbuf.GetWidth(), 10);
+
+	// Sprite file of a different size: cache is not valid, and is rewritten
+	storage.push_back(0);
+	sf.reset(new SpriteFile());
+	sf->SetIndexCacheFile(cache_file);
+	err = sf->OpenFile(std::make_unique<Stream>(std::make_unique<VectorStream>(storage)), nullptr, metrics);
+	ASSERT_TRUE(err);
+	ASSERT_EQ(metrics[1].Width, 1);
+	sf.reset(new SpriteFile());
+	sf->SetIndexCacheFile(cache_file);
+	err = sf->OpenFile(std::make_unique<Stream>(std::make_unique<VectorStream>(storage)), nullptr, metrics);
+	ASSERT_TRUE(err);
+	ASSERT_EQ(metrics[1].Width, 1);
+	const soff_t cache_len = File::GetFileSize(cache_file);
+	ASSERT_EQ(cache_len, static_cast<soff_t>(cache_header_sz + index_header_sz + 11 * (2 + 2 + 8)));
+	ASSERT_FALSE(File::IsFile(String::FromFormat("%s.tmp", cache_file.GetCStr())));
+
+	// Truncated cache: cache is not valid, and is rewritten
+	sf.reset();
+	ASSERT_TRUE(File::TruncateFile(cache_file, cache_len - 8));
+	sf.reset(new SpriteFile());
+	sf->SetIndexCacheFile(cache_file);
+	err = sf->OpenFile(std::make_unique<Stream>(std::make_unique<VectorStream>(storage)), nullptr, metrics);
+	ASSERT_TRUE(err);
+	ASSERT_TRUE(sf->DoesSpriteExist(10));
+	ASSERT_EQ(metrics[10].Width, 10);
+	ASSERT_EQ(File::GetFileSize(cache_file), cache_len);
+
+	sf.reset();
+	File::DeleteFile(cache_file);
+}
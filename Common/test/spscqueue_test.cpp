@@ -0,0 +1,95 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2026 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+#include <memory>
+#if !defined(AGS_DISABLE_THREADS)
+#include <thread>
+#endif
+#include "gtest/gtest.h"
+#include "util/spscqueue.h"
+
+
+TEST(SpscQueue, BasicTest) {
+    SpscQueue<std::unique_ptr<int>> queue(3);
+    ASSERT_EQ(queue.GetCapacity(), 3u);
+    ASSERT_TRUE(queue.IsEmpty());
+    ASSERT_EQ(queue.Front(), nullptr);
+
+    std::unique_ptr<int> item;
+    ASSERT_FALSE(queue.Pop(item));
+    for (int i = 0; i < 3; ++i)
+    {
+        item.reset(new int(i));
+        ASSERT_TRUE(queue.Push(std::move(item)));
+        ASSERT_EQ(item, nullptr);
+    }
+    ASSERT_TRUE(queue.IsFull());
+    ASSERT_EQ(queue.GetCount(), 3u);
+    // Failed push must not take the item
+    item.reset(new int(3));
+    ASSERT_FALSE(queue.Push(std::move(item)));
+    ASSERT_NE(item, nullptr);
+
+    ASSERT_EQ(**queue.Front(), 0);
+    ASSERT_TRUE(queue.Pop(item));
+    ASSERT_EQ(*item, 0);
+    // Push over the end of the ring
+    ASSERT_TRUE(queue.Push(std::unique_ptr<int>(new int(3))));
+    for (int i = 1; i <= 3; ++i)
+    {
+        ASSERT_TRUE(queue.Pop(item));
+        ASSERT_EQ(*item, i);
+    }
+    ASSERT_TRUE(queue.IsEmpty());
+
+    queue.Push(std::unique_ptr<int>(new int(0)));
+    queue.Reset(1);
+    ASSERT_TRUE(queue.IsEmpty());
+    ASSERT_EQ(queue.GetCapacity(), 1u);
+}
+
+#if !defined(AGS_DISABLE_THREADS)
+TEST(SpscQueue, Threaded) {
+    const int count = 100000;
+    SpscQueue<int> queue(16);
+    std::thread producer([&queue]()
+    {
+        for (int i = 0; i < count;)
+        {
+            int item = i;
+            if (queue.Push(std::move(item)))
+                ++i;
+            else
+                std::this_thread::yield();
+        }
+    });
+
+    // Items must arrive all and in order
+    int expect = 0;
+    while (expect < count)
+    {
+        int item;
+        if (queue.Pop(item))
+        {
+            ASSERT_EQ(item, expect);
+            ++expect;
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+    ASSERT_TRUE(queue.IsEmpty());
+}
+#endif
@@ -14,6 +14,7 @@
 #include <array>
 #include <cstring>
 #include <memory>
+#include <string>
 #include <vector>
 #include "gtest/gtest.h"
 #include "util/bufferedstream.h"
@@ -337,6 +338,74 @@ TEST(Stream, DeflateStream2) {
     TestDeflateStream_RandomNumericSeq(DeflateStream::BufferSize * 4);
 }
 
+TEST(Stream, ReadRawLine) {
+    // NOTE: ReadRawLine reads the data in chunks of 256 bytes
+    const std::string line1(255, 'a'); // CR is the last char in the chunk
+    const std::string line2(255, 'b'); // CRLF is split between chunks
+    const std::string line3(300, 'c'); // line longer than a chunk
+    const std::string text = line1 + "\r" + line2 + "\r\n" + line3 + "\n"
+        + "short\r\n" + "\n" + "last";
+    std::vector<uint8_t> membuf(text.begin(), text.end());
+    Stream in(std::make_unique<VectorStream>(membuf));
+
+    char buf[1024];
+    soff_t pos = 0;
+    ASSERT_TRUE(ReadRawLine(&in, buf, sizeof(buf)));
+    ASSERT_STREQ(buf, line1.c_str());
+    pos += line1.size() + 1;
+    ASSERT_EQ(in.GetPosition(), pos);
+    ASSERT_TRUE(ReadRawLine(&in, buf, sizeof(buf)));
+    ASSERT_STREQ(buf, line2.c_str());
+    pos += line2.size() + 2;
+    ASSERT_EQ(in.GetPosition(), pos);
+    ASSERT_TRUE(ReadRawLine(&in, buf, sizeof(buf)));
+    ASSERT_STREQ(buf, line3.c_str());
+    pos += line3.size() + 1;
+    ASSERT_EQ(in.GetPosition(), pos);
+    ASSERT_TRUE(ReadRawLine(&in, buf, sizeof(buf)));
+    ASSERT_STREQ(buf, "short");
+    pos += 7;
+    ASSERT_EQ(in.GetPosition(), pos);
+    ASSERT_TRUE(ReadRawLine(&in, buf, sizeof(buf)));
+    ASSERT_STREQ(buf, "");
+    pos += 1;
+    ASSERT_EQ(in.GetPosition(), pos);
+    ASSERT_TRUE(ReadRawLine(&in, buf, sizeof(buf)));
+    ASSERT_STREQ(buf, "last");
+    ASSERT_EQ(in.GetPosition(), static_cast<soff_t>(text.size()));
+    ASSERT_TRUE(in.EOS());
+    // Reading past the end gives empty line
+    ASSERT_TRUE(ReadRawLine(&in, buf, sizeof(buf)));
+    ASSERT_STREQ(buf, "");
+}
+
+TEST(Stream, ReadRawLineLongerThanBuffer) {
+    const std::string line1(300, 'a');
+    const std::string text = line1 + "\r\n" + "next";
+    std::vector<uint8_t> membuf(text.begin(), text.end());
+    Stream in(std::make_unique<VectorStream>(membuf));
+
+    // The line is read in parts, each fills the buffer except for null-terminator
+    char buf[100];
+    std::string line;
+    soff_t pos = 0;
+    for (int i = 0; i < 3; ++i)
+    {
+        ASSERT_FALSE(ReadRawLine(&in, buf, sizeof(buf)));
+        ASSERT_EQ(strlen(buf), sizeof(buf) - 1);
+        line += buf;
+        pos += sizeof(buf) - 1;
+        ASSERT_EQ(in.GetPosition(), pos);
+    }
+    ASSERT_TRUE(ReadRawLine(&in, buf, sizeof(buf)));
+    line += buf;
+    ASSERT_EQ(line, line1);
+    ASSERT_EQ(in.GetPosition(), static_cast<soff_t>(line1.size() + 2));
+    ASSERT_TRUE(ReadRawLine(&in, buf, sizeof(buf)));
+    ASSERT_STREQ(buf, "next");
+    ASSERT_TRUE(in.EOS());
+}
+
 #if (AGS_PLATFORM_TEST_FILE_IO)
 
 class FileBasedTest : public ::testing::Test {
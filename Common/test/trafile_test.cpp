@@ -0,0 +1,129 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2026 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+#include <memory>
+#include <vector>
+#include "gtest/gtest.h"
+#include "data/tra_file.h"
+#include "util/memory_compat.h"
+#include "util/memorystream.h"
+
+using namespace AGS::Common;
+
+TEST(TraFile, DictIndexFind) {
+    std::vector<std::pair<String, String>> pairs;
+    for (int i = 0; i < 1000; ++i)
+        pairs.emplace_back(String::FromFormat("Line %d", i), String::FromFormat("Linea %d", i));
+    pairs.emplace_back("Line 5", "Repeat");
+    pairs.emplace_back("", "Empty key");
+
+    TraDictIndex index;
+    index.Build(pairs);
+    ASSERT_EQ(index.GetCount(), 1000u);
+    for (int i = 0; i < 1000; ++i)
+    {
+        const char *tr = index.Find(String::FromFormat("Line %d", i).GetCStr());
+        ASSERT_NE(tr, nullptr);
+        ASSERT_STREQ(tr, String::FromFormat("Linea %d", i).GetCStr());
+    }
+    ASSERT_EQ(index.Find("Line 1000"), nullptr);
+    ASSERT_EQ(index.Find("Line"), nullptr);
+    ASSERT_EQ(index.Find(""), nullptr);
+}
+
+TEST(TraFile, DictIndexWriteRead) {
+    Translation tra;
+    tra.GameUid = 123;
+    tra.GameName = "Test Game";
+    for (int i = 0; i < 100; ++i)
+        tra.Dict[String::FromFormat("Line %d", i)] = String::FromFormat("Linea %d", i);
+    tra.Dict["Untranslated"] = "";
+
+    std::vector<uint8_t> membuf;
+    WriteTraData(tra, std::make_unique<Stream>(
+        std::make_unique<VectorStream>(membuf, kStream_Write)), true);
+
+    Translation tra2;
+    HError err = ReadTraData(tra2, std::make_unique<Stream>(
+        std::make_unique<VectorStream>(membuf)));
+    ASSERT_TRUE(err);
+    ASSERT_EQ(tra2.GameUid, 123);
+    ASSERT_STREQ(tra2.GameName.GetCStr(), "Test Game");
+    // The regular dictionary is skipped when the index is present
+    ASSERT_TRUE(tra2.Dict.empty());
+    ASSERT_EQ(tra2.DictIndex.GetCount(), 100u);
+    for (int i = 0; i < 100; ++i)
+    {
+        const char *tr = tra2.DictIndex.Find(String::FromFormat("Line %d", i).GetCStr());
+        ASSERT_NE(tr, nullptr);
+        ASSERT_STREQ(tr, String::FromFormat("Linea %d", i).GetCStr());
+    }
+    ASSERT_EQ(tra2.DictIndex.Find("Untranslated"), nullptr);
+}
+
+TEST(TraFile, DictIndexReadInvalidSizes) {
+    // Table sizes which do not fit in the block must be rejected before allocating
+    std::vector<uint8_t> membuf;
+    {
+        Stream out(std::make_unique<VectorStream>(membuf, kStream_Write));
+        out.WriteInt32(0x10000000); // entries
+        out.WriteInt32(0x40000000); // slots
+        out.WriteInt32(0x7FFFFFFF); // pool size
+        out.WriteInt32(0);
+    }
+    TraDictIndex index;
+    Stream in(std::make_unique<VectorStream>(membuf));
+    ASSERT_FALSE(index.Read(&in, membuf.size()));
+    ASSERT_TRUE(index.IsEmpty());
+
+    // Pool too small for the number of entries
+    membuf.clear();
+    {
+        Stream out(std::make_unique<VectorStream>(membuf, kStream_Write));
+        out.WriteInt32(4); // entries
+        out.WriteInt32(8); // slots
+        out.WriteInt32(4); // pool size
+        for (int i = 0; i < 8 + 4 * 4 + 1; ++i)
+            out.WriteInt32(0);
+    }
+    Stream in2(std::make_unique<VectorStream>(membuf));
+    ASSERT_FALSE(index.Read(&in2, membuf.size()));
+}
+
+TEST(TraFile, DictIndexReadNoFreeSlots) {
+    std::vector<std::pair<String, String>> pairs;
+    pairs.emplace_back("Line", "Linea");
+    TraDictIndex index;
+    index.Build(pairs);
+    std::vector<uint8_t> membuf;
+    {
+        Stream out(std::make_unique<VectorStream>(membuf, kStream_Write));
+        index.Write(&out);
+    }
+    TraDictIndex index2;
+    Stream in(std::make_unique<VectorStream>(membuf));
+    ASSERT_TRUE(index2.Read(&in, membuf.size()));
+    ASSERT_STREQ(index2.Find("Line"), "Linea");
+
+    // Every slot refers to a valid entry, which would make lookups endless
+    const size_t slot_count = 16;
+    ASSERT_EQ(membuf[sizeof(int32_t)], slot_count); // minimal table size
+    for (size_t i = 0; i < slot_count; ++i)
+    {
+        const size_t off = 3 * sizeof(int32_t) + i * sizeof(int32_t);
+        membuf[off] = 1; membuf[off + 1] = 0; membuf[off + 2] = 0; membuf[off + 3] = 0;
+    }
+    Stream in2(std::make_unique<VectorStream>(membuf));
+    ASSERT_FALSE(index2.Read(&in2, membuf.size()));
+    ASSERT_TRUE(index2.IsEmpty());
+}
@@ -136,6 +136,11 @@ bool File::RenameFile(const String &old_name, const String &new_name)
     return ags_file_rename(old_name.GetCStr(), new_name.GetCStr()) == 0;
 }
 
+bool File::ReplaceFile(const String &old_name, const String &new_name)
+{
+    return ags_file_replace(old_name.GetCStr(), new_name.GetCStr()) == 0;
+}
+
 bool File::CopyFile(const String &src_path, const String &dst_path, bool overwrite)
 {
     return ags_file_copy(src_path.GetCStr(), dst_path.GetCStr(), overwrite) == 0;
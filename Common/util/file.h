@@ -70,6 +70,9 @@ namespace File
     bool        DeleteFile(const String &filename);
     // Renames existing file to the new name; returns TRUE on success
     bool        RenameFile(const String &old_name, const String &new_name);
+    // Renames existing file to the new name, replacing the file with that name
+    // if one exists; returns TRUE on success
+    bool        ReplaceFile(const String &old_name, const String &new_name);
     // Copies a file from src_path to dst_path; returns TRUE on success
     bool        CopyFile(const String &src_path, const String &dst_path, bool overwrite);
     // Truncates existing file to the given length in bytes.
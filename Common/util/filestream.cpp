@@ -144,7 +144,9 @@ void FileStream::Open(const String &file_name, FileOpenMode open_mode, StreamMod
     if (_file == nullptr)
         throw std::runtime_error("Error opening file.");
     _ownHandle = true;
-    _path = file_name;
+    // Keep an independent copy of the path, not sharing a buffer with the
+    // caller's string, so that the stream may be passed to another thread
+    _path.SetString(file_name.GetCStr(), file_name.GetLength());
     _openMode = open_mode;
     _workMode = static_cast<StreamMode>(work_mode | kStream_Seek);
 }
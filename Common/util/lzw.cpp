@@ -198,10 +198,9 @@ bool lzwexpand(const uint8_t *src, size_t src_sz, uint8_t *dst, size_t dst_sz)
   if (dst_sz == 0)
     return false; // nowhere to expand to
 
-  lzbuffer = (uint8_t *)malloc(N);
-  if (lzbuffer == nullptr) {
-    return false; // not enough memory
-  }
+  // NOTE: the ring buffer is local, as the expansion may run
+  // on multiple threads at once (e.g. when preloading rooms)
+  uint8_t lzbuf[N];
   i = N - F;
 
   // Read from the src and expand, until either src or dst runs out of space
@@ -225,13 +224,13 @@ bool lzwexpand(const uint8_t *src, size_t src_sz, uint8_t *dst, size_t dst_sz)
           break; // not enough dest buffer
 
         while (len--) {
-          *(dst_ptr++) = (lzbuffer[i] = lzbuffer[j]);
+          *(dst_ptr++) = (lzbuf[i] = lzbuf[j]);
           j = (j + 1) & (N - 1);
           i = (i + 1) & (N - 1);
         }
       } else {
         ch = *(src_ptr++);
-        *(dst_ptr++) = (lzbuffer[i] = static_cast<uint8_t>(ch));
+        *(dst_ptr++) = (lzbuf[i] = static_cast<uint8_t>(ch));
         i = (i + 1) & (N - 1);
       }
 
@@ -242,6 +241,5 @@ bool lzwexpand(const uint8_t *src, size_t src_sz, uint8_t *dst, size_t dst_sz)
     } // end for mask
   }
 
-  free(lzbuffer);
   return (src_ptr - src) == src_sz;
 }
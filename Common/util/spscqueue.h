@@ -0,0 +1,104 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2026 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+//
+// SpscQueue is a fixed-capacity lock-free ring queue for passing elements
+// between a single producer and a single consumer thread.
+//
+// Push may only be called by the producer, and Pop and Front only by the
+// consumer; each side may be shared by several threads, so long as these
+// are serialized by other means (e.g. a mutex of their own). The rest of
+// the methods, such as Reset, may only be called when neither side is using
+// the queue concurrently.
+//
+//=============================================================================
+#ifndef __AGS_CN_UTIL__SPSCQUEUE_H
+#define __AGS_CN_UTIL__SPSCQUEUE_H
+
+#include <atomic>
+#include <utility>
+#include <vector>
+
+template <typename T>
+class SpscQueue
+{
+public:
+    SpscQueue() = default;
+    SpscQueue(size_t capacity) { Reset(capacity); }
+
+    // Clears the queue and sets a new capacity
+    void Reset(size_t capacity)
+    {
+        _items.clear();
+        // one slot is always left free, to tell a full queue from empty one
+        _items.resize(capacity + 1);
+        _head.store(0u, std::memory_order_relaxed);
+        _tail.store(0u, std::memory_order_relaxed);
+    }
+
+    // Gets maximal number of elements in queue
+    size_t GetCapacity() const { return _items.empty() ? 0u : _items.size() - 1; }
+    // Gets the number of elements in queue; the result is only approximate
+    // if the other side is working with the queue at the same time
+    size_t GetCount() const
+    {
+        const size_t head = _head.load(std::memory_order_acquire);
+        const size_t tail = _tail.load(std::memory_order_acquire);
+        return (tail >= head) ? (tail - head) : (tail + _items.size() - head);
+    }
+    bool IsEmpty() const { return GetCount() == 0u; }
+    bool IsFull() const { return GetCount() == GetCapacity(); }
+
+    // Adds an element to the end of queue; fails if the queue is full,
+    // in which case the element is not moved from
+    bool Push(T &&item)
+    {
+        if (_items.empty())
+            return false;
+        const size_t tail = _tail.load(std::memory_order_relaxed);
+        const size_t next = (tail + 1) % _items.size();
+        if (next == _head.load(std::memory_order_acquire))
+            return false;
+        _items[tail] = std::move(item);
+        _tail.store(next, std::memory_order_release);
+        return true;
+    }
+
+    // Gets the first element in queue, or null if the queue is empty
+    T *Front()
+    {
+        const size_t head = _head.load(std::memory_order_relaxed);
+        if (head == _tail.load(std::memory_order_acquire))
+            return nullptr;
+        return &_items[head];
+    }
+
+    // Removes the first element from queue and moves it into the given
+    // variable; fails if the queue is empty
+    bool Pop(T &item)
+    {
+        const size_t head = _head.load(std::memory_order_relaxed);
+        if (head == _tail.load(std::memory_order_acquire))
+            return false;
+        item = std::move(_items[head]);
+        _head.store((head + 1) % _items.size(), std::memory_order_release);
+        return true;
+    }
+
+private:
+    std::vector<T> _items;
+    std::atomic<size_t> _head{0u}; // index of the first element, owned by consumer
+    std::atomic<size_t> _tail{0u}; // index past the last element, owned by producer
+};
+
+#endif // __AGS_CN_UTIL__SPSCQUEUE_H
@@ -200,6 +200,18 @@ int ags_file_rename(const char *src, const char *dst)
 #endif // POSIX
 }
 
+int ags_file_replace(const char *src, const char *dst)
+{
+#if AGS_PLATFORM_OS_WINDOWS
+    WCHAR wsrc[MAX_PATH_SZ], wdst[MAX_PATH_SZ];
+    MultiByteToWideChar(CP_UTF8, 0, src, -1, wsrc, MAX_PATH_SZ);
+    MultiByteToWideChar(CP_UTF8, 0, dst, -1, wdst, MAX_PATH_SZ);
+    return !MoveFileExW(wsrc, wdst, MOVEFILE_REPLACE_EXISTING); // inverse result to match 0 = success
+#else // POSIX
+    return rename(src, dst); // POSIX rename replaces existing file atomically
+#endif // POSIX
+}
+
 int ags_file_copy(const char *src, const char *dst, int overwrite)
 {
 #if AGS_PLATFORM_OS_WINDOWS
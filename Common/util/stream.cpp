@@ -344,5 +344,52 @@ soff_t CopyStream(Stream *in, Stream *out, soff_t length)
     return CopyStream(in->GetStreamBase(), out->GetStreamBase(), length);
 }
 
+bool ReadRawLine(Stream *in, char *buffer, size_t buf_len)
+{
+    if (buf_len == 0) return false;
+    // Read the data in small chunks right into the line buffer, and when
+    // a linebreak is found then seek back to the beginning of the next line
+    const size_t chunk_size = 256u;
+    size_t len = 0u;
+    while (len < buf_len - 1)
+    {
+        const size_t want = std::min(chunk_size, buf_len - 1 - len);
+        const size_t got = in->Read(buffer + len, want);
+        const size_t end = len + got;
+        for (size_t i = len; i < end; ++i)
+        {
+            const char c = buffer[i];
+            if (c != '\n' && c != '\r')
+                continue;
+            size_t next = i + 1; // beginning of the next line
+            if (c == '\r') // CR or CRLF
+            {
+                // Look for '\n', but it may be missing, which is also a valid case
+                if (next < end)
+                {
+                    if (buffer[next] == '\n') next++;
+                }
+                else
+                {
+                    int c2 = in->ReadByte();
+                    if (c2 >= 0 && c2 != '\n') in->Seek(-1, kSeekCurrent);
+                }
+            }
+            if (next < end)
+                in->Seek(-static_cast<soff_t>(end - next), kSeekCurrent);
+            buffer[i] = 0;
+            return true;
+        }
+        len = end;
+        if (got < want) // EOF
+        {
+            buffer[len] = 0;
+            return true;
+        }
+    }
+    buffer[buf_len - 1] = 0;
+    return false; // not enough buffer
+}
+
 } // namespace Common
 } // namespace AGS
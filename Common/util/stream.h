@@ -557,6 +557,13 @@ soff_t CopyStream(Stream *in, Stream *out);
 // returns number of bytes actually written
 soff_t CopyStream(Stream *in, Stream *out, soff_t length);
 
+// Reads a line of chars terminated by LF, CR or CRLF into the buffer, until the
+// linebreak is met or the buffer is filled; the linebreak is not stored.
+// On success the stream is positioned at the beginning of the next line.
+// Returns whether reached the end of line (false in case not enough buffer);
+// guarantees null-terminator in the buffer.
+bool ReadRawLine(Stream *in, char *buffer, size_t buf_len);
+
 } // namespace Common
 } // namespace AGS
 
@@ -11,18 +11,25 @@
 // https://opensource.org/license/artistic-2-0/
 //
 //=============================================================================
-#include <utility>
+#include <algorithm>
+#include <atomic>
 #include <iostream>
+#include <sstream>
+#include <thread>
+#include <utility>
 
 #include "compiler.h"
 #include "script/cs_compiler.h"
+#include "script/cc_compiledscript.h"
 #include "script/cc_common.h"
 #include "script/cc_internal.h"
 #include "util/filestream.h"
+#include "util/memorystream.h"
 #include "util/file.h"
 #include "util/path.h"
 #include "util/textstreamreader.h"
 #include "util/string_compat.h"
+#include "util/string_utils.h"
 #include "preproc/preprocessor.h"
 #include "compiler.h"
 
@@ -69,8 +76,14 @@ std::vector<const char *> GetScriptAPIs()
 
 void CompilerOptions::PrintToStdout() const {
     printf("\n--- Compiler Settings ---\n");
-    printf("Input: %s\n", InputScriptFile.c_str());
-    printf("Output: %s\n", OutputObjFile.c_str());
+    printf("Input:");
+    for (size_t i = 0; i < InputScriptFiles.size(); ++i)
+        printf(i > 0 ? ", %s" : " %s", InputScriptFiles[i].c_str());
+    printf("\nOutput:");
+    for (size_t i = 0; i < OutputObjFiles.size(); ++i)
+        printf(i > 0 ? ", %s" : " %s", OutputObjFiles[i].c_str());
+    printf("\n");
+    if (Jobs > 1) printf("Jobs: %d\n", Jobs);
     printf("Headers:");
     bool comma = false;
     for (const auto& header : HeaderFiles)
@@ -88,6 +101,7 @@ void CompilerOptions::PrintToStdout() const {
         comma = true;
     }
     printf("\nVersion: %s\n", Version.c_str());
+    if (!PchFile.empty()) printf("Precompiled headers: %s\n", PchFile.c_str());
     printf("ScriptAPIVersion: %s\n", ScriptAPI.ScriptAPIVersion.c_str());
     printf("ScriptCompatLevel: %s\n", ScriptAPI.ScriptCompatLevel.c_str());
     printf("Flags: ");
@@ -107,10 +121,113 @@ void CompilerOptions::PrintToStdout() const {
 }
 
 
-int Compile(const CompilerOptions& comp_opts)
+//-----------------------------------------------------------------------//
+// Precompiled headers
+//-----------------------------------------------------------------------//
+// The cache file holds the compiler state right after all the headers
+// were processed: the preprocessor macros, the symbol table (which includes
+// struct layouts) and the partially compiled script. It is keyed by a hash
+// of everything that affects that state, and is simply rebuilt when the key
+// does not match.
+static const char PchSignature[] = "AGSPCH";
+static const int32_t PchFormatVersion = 1;
+
+// FNV-1a, 64-bit
+static void HashBytes(uint64_t &hash, const void *data, size_t len)
+{
+    const uint8_t *p = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < len; ++i)
+    {
+        hash ^= p[i];
+        hash *= 0x100000001b3ULL;
+    }
+}
+
+static void HashString(uint64_t &hash, const char *str)
+{
+    // include terminator, to separate consecutive strings
+    HashBytes(hash, str, strlen(str) + 1);
+}
+
+static uint64_t MakePchKey(const CompilerOptions &comp_opts,
+    const std::vector<std::pair<String, String>> &heads)
+{
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    HashBytes(hash, &PchFormatVersion, sizeof(PchFormatVersion));
+    HashString(hash, comp_opts.Version.c_str());
+    HashString(hash, comp_opts.ScriptAPI.ScriptAPIVersion.c_str());
+    HashString(hash, comp_opts.ScriptAPI.ScriptCompatLevel.c_str());
+    const bool flags[] = { comp_opts.DebugMode,
+        comp_opts.Flags.ExportAll, comp_opts.Flags.LineNumbers, comp_opts.Flags.AutoImport,
+        comp_opts.Flags.DebugRun, comp_opts.Flags.NoImportOverride,
+        comp_opts.Flags.EnforceObjectBasedScript, comp_opts.Flags.LeftToRightPrecedence,
+        comp_opts.Flags.EnforceNewStrings, comp_opts.Flags.EnforceNewAudio,
+        comp_opts.Flags.UseOldCustomDialogOptionsAPI };
+    HashBytes(hash, flags, sizeof(flags));
+    for (const auto &macro : comp_opts.Macros)
+    {
+        HashString(hash, macro.first.c_str());
+        HashString(hash, macro.second.c_str());
+    }
+    for (const auto &head : heads)
+    {
+        HashString(hash, head.second.GetCStr());
+        HashBytes(hash, head.first.GetCStr(), head.first.GetLength());
+        HashBytes(hash, "", 1);
+    }
+    return hash;
+}
+
+// Reads the serialized headers state from the cache file,
+// returns false if the cache is missing or stale
+static bool ReadPch(const String &filename, uint64_t key, std::vector<uint8_t> &heads_state)
+{
+    std::unique_ptr<Stream> in(File::OpenFileRead(filename));
+    if (!in)
+        return false;
+    if (StrUtil::ReadCStrAsStdString(in.get()) != PchSignature ||
+        in->ReadInt32() != PchFormatVersion ||
+        static_cast<uint64_t>(in->ReadInt64()) != key)
+        return false;
+    const soff_t state_len = in->GetLength() - in->GetPosition();
+    if (state_len <= 0)
+        return false;
+    heads_state.resize(static_cast<size_t>(state_len));
+    return in->Read(heads_state.data(), heads_state.size()) == heads_state.size();
+}
+
+// Saves the serialized headers state to the cache file; the file is
+// written under a temporary name first, so that another compiler process
+// never reads a partially written cache
+static void WritePch(const String &filename, uint64_t key, const std::vector<uint8_t> &heads_state)
+{
+    String tmp_filename = String::FromFormat("%s.tmp", filename.GetCStr());
+    {
+        std::unique_ptr<Stream> out(File::CreateFile(tmp_filename));
+        if (!out || !out->CanWrite())
+        {
+            std::cerr << "Warning: failed to open for writing: " << tmp_filename.GetCStr() << std::endl;
+            return;
+        }
+        StrUtil::WriteCStr(PchSignature, out.get());
+        out->WriteInt32(PchFormatVersion);
+        out->WriteInt64(static_cast<int64_t>(key));
+        out->Write(heads_state.data(), heads_state.size());
+    }
+    File::DeleteFile(filename);
+    if (!File::RenameFile(tmp_filename, filename))
+    {
+        std::cerr << "Warning: failed to write precompiled headers: " << filename.GetCStr() << std::endl;
+        File::DeleteFile(tmp_filename);
+    }
+}
+
+//-----------------------------------------------------------------------//
+// Compilation steps
+//-----------------------------------------------------------------------//
+// Defines the macros which depend on compiler options
+static void DefineMacros(const CompilerOptions &comp_opts, AGS::Preprocessor::Preprocessor &pp)
 {
-    comp_opts.PrintToStdout();
-    AGS::Preprocessor::Preprocessor pp = AGS::Preprocessor::Preprocessor();
     std::vector<std::string> scriptAPIVersionMacros;
     std::vector<std::string> scriptCompatLevelMacros;
 
@@ -120,9 +237,6 @@ int Compile(const CompilerOptions& comp_opts)
         scriptCompatLevelMacros.emplace_back(std::string(PREFIX_SCRIPT_COMPAT) + ScriptAPIs[i]);
     }
 
-    //-----------------------------------------------------------------------//
-    // Configure macros
-    //-----------------------------------------------------------------------//
     pp.DefineMacro("AGS_NEW_STRINGS", "1");
     pp.DefineMacro("AGS_SUPPORTS_IFVER", "1");
 
@@ -175,10 +289,12 @@ int Compile(const CompilerOptions& comp_opts)
     {
         pp.DefineMacro(macro.first.c_str(), macro.second.c_str());
     }
+}
 
-    //-----------------------------------------------------------------------//
-    // Configure compiler
-    //-----------------------------------------------------------------------//
+// Configures the compiler; compiler settings are stored per thread,
+// so this must be called on each thread that compiles scripts
+static void SetCompilerOptions(const CompilerOptions &comp_opts)
+{
     ccSetSoftwareVersion(comp_opts.Version.c_str());
 
     ccSetOption(SCOPT_EXPORTALL, comp_opts.Flags.ExportAll);
@@ -188,11 +304,15 @@ int Compile(const CompilerOptions& comp_opts)
 
     ccSetOption(SCOPT_LEFTTORIGHT, comp_opts.Flags.LeftToRightPrecedence);
     ccSetOption(SCOPT_OLDSTRINGS, !comp_opts.Flags.EnforceNewStrings);
+}
 
-    ccRemoveDefaultHeaders();
-
+// Processes the headers, or restores them from the precompiled headers,
+// and serializes the resulting preprocessor and compiler state, so that
+// every script module compilation could restore its own copy of it
+static bool PrepareHeaders(const CompilerOptions &comp_opts, std::vector<uint8_t> &heads_state)
+{
     //-----------------------------------------------------------------------//
-    // Read input files
+    // Read header files
     //-----------------------------------------------------------------------//
     std::vector<std::pair<String, String>> heads;
     for(const auto& header: comp_opts.HeaderFiles)
@@ -200,14 +320,14 @@ int Compile(const CompilerOptions& comp_opts)
         if (header.empty())
         {
             std::cerr << "Error: empty header filename. Do you have a trailing `:` or `;`? "<< std::endl;
-            return -1;
+            return false;
         }
 
         std::unique_ptr<Stream> in (File::OpenFileRead(header.c_str()));
         if (!in)
         {
             std::cerr << "Error: failed to open header for reading: " << header << std::endl;
-            return -1;
+            return false;
         }
 
         String headername = Path::GetFilename(header.c_str());
@@ -217,28 +337,21 @@ int Compile(const CompilerOptions& comp_opts)
         heads.emplace_back(sr.ReadAll(), headername);
     }
 
-    String script_input;
-    const char* src = nullptr;
-
-    if (comp_opts.InputScriptFile.empty())
-    {
-        std::cerr << "Error: empty script filename." << std::endl;
-        return -1;
-    }
-
-    src = comp_opts.InputScriptFile.c_str();
-    std::unique_ptr<Stream> in (File::OpenFileRead(src));
-    if (!in)
+    uint64_t pch_key = 0;
+    if (!comp_opts.PchFile.empty())
     {
-        std::cerr << "Error: failed to open script for reading: " << src << std::endl;
-        return -1;
+        pch_key = MakePchKey(comp_opts, heads);
+        if (ReadPch(comp_opts.PchFile.c_str(), pch_key, heads_state))
+            return true;
     }
-    TextStreamReader sr(std::move(in));
-    script_input = sr.ReadAll();
 
     //-----------------------------------------------------------------------//
     // Preprocess headers and set them for use when compiling
     //-----------------------------------------------------------------------//
+    AGS::Preprocessor::Preprocessor pp = AGS::Preprocessor::Preprocessor();
+    DefineMacros(comp_opts, pp);
+
+    ccRemoveDefaultHeaders();
     std::vector<std::pair<String, String>> preprocessed_heads;
     for(const auto& head: heads)
     {
@@ -249,27 +362,85 @@ int Compile(const CompilerOptions& comp_opts)
     }
     heads.clear();
 
+    //-----------------------------------------------------------------------//
+    // Compile headers
+    //-----------------------------------------------------------------------//
+    std::unique_ptr<ccCompiledScript> compiled_heads;
+    if (!comp_opts.PreprocessOnly)
+    {
+        compiled_heads.reset(ccCompileHeaders());
+        if (!compiled_heads)
+        {
+            const auto &error = cc_get_error();
+            std::cerr << "Error: compile failed at " << ccCurScriptName << ", line " << error.Line << " : " << error.ErrorString.GetCStr() << std::endl;
+            return false;
+        }
+    }
+    ccRemoveDefaultHeaders();
+
+    Stream out(std::unique_ptr<VectorStream>(new VectorStream(heads_state, kStream_Write)));
+    pp.WriteMacros(&out);
+    if (compiled_heads)
+        ccWriteHeadersState(compiled_heads.get(), &out);
+
+    if (!comp_opts.PchFile.empty() && compiled_heads)
+        WritePch(comp_opts.PchFile.c_str(), pch_key, heads_state);
+    return true;
+}
+
+// Compiles a single script module on top of the prepared headers state,
+// and writes the script object; errors are printed into the given stream
+static int CompileModule(const CompilerOptions &comp_opts, const std::vector<uint8_t> &heads_state,
+    const std::string &input_file, const std::string &output_file, std::ostream &err)
+{
+    SetCompilerOptions(comp_opts);
+    Stream heads_in(std::unique_ptr<VectorStream>(new VectorStream(heads_state)));
+    AGS::Preprocessor::Preprocessor pp = AGS::Preprocessor::Preprocessor();
+    pp.ReadMacros(&heads_in);
+
+    //-----------------------------------------------------------------------//
+    // Read input file
+    //-----------------------------------------------------------------------//
+    String script_input;
+    const char* src = nullptr;
+
+    if (input_file.empty())
+    {
+        err << "Error: empty script filename." << std::endl;
+        return -1;
+    }
+
+    src = input_file.c_str();
+    std::unique_ptr<Stream> in (File::OpenFileRead(src));
+    if (!in)
+    {
+        err << "Error: failed to open script for reading: " << src << std::endl;
+        return -1;
+    }
+    TextStreamReader sr(std::move(in));
+    script_input = sr.ReadAll();
+
     //-----------------------------------------------------------------------//
     // Preprocess script
     //-----------------------------------------------------------------------//
     String script_pp = nullptr;
-    String filename = Path::GetFilename(comp_opts.InputScriptFile.c_str());
+    String filename = Path::GetFilename(input_file.c_str());
     String script_name = Path::RemoveExtension(filename);
 
     script_pp = pp.Preprocess(script_input,script_name);
     if ((script_pp == nullptr) || (cc_has_error()))
     {
         const auto &error = cc_get_error();
-        std::cerr << "Error: preprocessor failed at " << script_name.GetCStr() <<
+        err << "Error: preprocessor failed at " << script_name.GetCStr() <<
             ", line " << error.Line << " : " << error.ErrorString.GetCStr() << std::endl;
         return -1;
     }
 
     if(comp_opts.PreprocessOnly)
     {
-        std::unique_ptr<Stream> out (File::CreateFile(comp_opts.OutputObjFile.c_str()));
+        std::unique_ptr<Stream> out (File::CreateFile(output_file.c_str()));
         if (!out || !(out->CanWrite())) {
-            std::cerr << "Error: failed to open for writing: " << comp_opts.OutputObjFile << std::endl;
+            err << "Error: failed to open for writing: " << output_file << std::endl;
             return -1;
         }
         script_pp.Write(out.get());
@@ -279,26 +450,87 @@ int Compile(const CompilerOptions& comp_opts)
     //-----------------------------------------------------------------------//
     // Compile script
     //-----------------------------------------------------------------------//
-    ccScript* script = ccCompileText(script_pp.GetCStr(), script_name.GetCStr());
+    ccCompiledScript *compiled_heads = ccReadHeadersState(&heads_in);
+    if (!compiled_heads)
+    {
+        err << "Error: failed to restore compiled headers for " << script_name.GetCStr() << std::endl;
+        return -1;
+    }
+    std::unique_ptr<ccScript> script(ccCompileTextAfterHeaders(compiled_heads, script_pp.GetCStr(), script_name.GetCStr()));
     if ((script == nullptr) || (cc_has_error()))
     {
         const auto &error = cc_get_error();
-        std::cerr << "Error: compile failed at " << ccCurScriptName << ", line " << error.Line << " : " << error.ErrorString.GetCStr() << std::endl;
+        err << "Error: compile failed at " << ccCurScriptName << ", line " << error.Line << " : " << error.ErrorString.GetCStr() << std::endl;
         return -1;
     }
 
     //-----------------------------------------------------------------------//
     // Write script object
     //-----------------------------------------------------------------------//
-    if(!comp_opts.OutputObjFile.empty())
+    if(!output_file.empty())
     {
-        std::unique_ptr<Stream> out (File::CreateFile(comp_opts.OutputObjFile.c_str()));
+        std::unique_ptr<Stream> out (File::CreateFile(output_file.c_str()));
         if (!out || !(out->CanWrite())) {
-            std::cerr << "Error: failed to open for writing: " << comp_opts.OutputObjFile << std::endl;
+            err << "Error: failed to open for writing: " << output_file << std::endl;
             return -1;
         }
         script->Write(out.get());
     }
 
     return 0;
-}
\ No newline at end of file
+}
+
+int Compile(const CompilerOptions& comp_opts)
+{
+    comp_opts.PrintToStdout();
+
+    if (comp_opts.InputScriptFiles.empty())
+    {
+        std::cerr << "Error: empty script filename." << std::endl;
+        return -1;
+    }
+
+    SetCompilerOptions(comp_opts);
+    std::vector<uint8_t> heads_state;
+    if (!PrepareHeaders(comp_opts, heads_state))
+        return -1;
+
+    //-----------------------------------------------------------------------//
+    // Compile script modules, each worker takes the next pending module;
+    // errors are collected and printed in the order of input files
+    //-----------------------------------------------------------------------//
+    const size_t num_modules = comp_opts.InputScriptFiles.size();
+    std::vector<int> results(num_modules);
+    std::vector<std::ostringstream> errors(num_modules);
+    std::atomic<size_t> next_module(0);
+    auto worker = [&]()
+    {
+        for (size_t i = next_module++; i < num_modules; i = next_module++)
+        {
+            results[i] = CompileModule(comp_opts, heads_state,
+                comp_opts.InputScriptFiles[i], comp_opts.OutputObjFiles[i], errors[i]);
+        }
+    };
+
+#if AGS_CC_THREADLOCAL
+    const size_t num_threads = std::min(num_modules, static_cast<size_t>(std::max(1, comp_opts.Jobs)));
+#else
+    // the shared script state is not per-thread in this build
+    const size_t num_threads = 1;
+#endif
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < num_threads; ++i)
+        threads.emplace_back(worker);
+    worker();
+    for (auto &thread : threads)
+        thread.join();
+
+    int result = 0;
+    for (size_t i = 0; i < num_modules; ++i)
+    {
+        std::cerr << errors[i].str();
+        if (results[i] != 0)
+            result = results[i];
+    }
+    return result;
+}
@@ -52,8 +52,10 @@ public:
     bool DebugMode = false; // build for debug
     std::vector<std::pair<std::string, std::string>> Macros{};
     std::vector<std::string> HeaderFiles{};
-    std::string InputScriptFile{};
-    std::string OutputObjFile{};
+    std::vector<std::string> InputScriptFiles{};
+    std::vector<std::string> OutputObjFiles{}; // one per input file
+    int Jobs = 1; // number of scripts compiled in parallel
+    std::string PchFile{}; // precompiled headers cache
     std::string Version{};
     CompilerOptions() = default;
     ~CompilerOptions() = default;
@@ -19,12 +19,13 @@
 #include "ac/def_version.h"
 #include "util/path.h"
 #include "util/cmdlineopts.h"
+#include "util/string_utils.h"
 #include "compiler.h"
 
 using namespace AGS::Common;
 using namespace AGS::Common::CmdLineOpts;
 
-const char *HELP_STRING = R"EOS(Usage: agscc [options] <INPUT.asc>
+const char *HELP_STRING = R"EOS(Usage: agscc [options] <INPUT.asc> [<INPUT2.asc>...]
 -A <version>                 Script API Version               (default:Highest)
 -C <version>                 Script API Compatibility version (default:Highest)
 -H, --Headers <H1>[:<H2>...] Header Files in order  (; as separator in cmd.exe)
@@ -42,9 +43,13 @@ const char *HELP_STRING = R"EOS(Usage: agscc [options] <INPUT.asc>
 -fforcenewaudio[=0]          Enforce new audio system               (default:1)
 -foldcustomdialogopt[=0]     Use old custom dialog API
 -g                           Generate debug information
+-j <N>                       Compile up to N input scripts in parallel
 --tell-api-versions          Returns supported Script API Versions
 -o <OUT.o>, --output <OUT.o> Place output in specified file.  (default:INPUT.o)
+                             Only allowed with a single input script
 --override-version <VERSION> Overrides editor version
+--pch <FILE>                 Cache processed headers in <FILE>, and reuse them
+                             while headers and options stay the same
 -h, --help                   Print this usage message
 )EOS";
 
@@ -98,6 +103,7 @@ ParsedOptions parser_to_compiler_opts(const ParseResult& parseResult)
         return ParsedOptions(-1);
     }
 
+    std::string output_obj_file;
     compilerOptions.PreprocessOnly = parseResult.Opt.count("-E");
     compilerOptions.DebugMode = parseResult.Opt.count("-g");
 
@@ -169,7 +175,23 @@ ParsedOptions parser_to_compiler_opts(const ParseResult& parseResult)
 
         if(opt_with_value.first == "-o" || opt_with_value.first == "--output")
         {
-            compilerOptions.OutputObjFile = opt_with_value.second.GetCStr();
+            output_obj_file = opt_with_value.second.GetCStr();
+            continue;
+        }
+
+        if(opt_with_value.first == "-j")
+        {
+            compilerOptions.Jobs = StrUtil::StringToInt(opt_with_value.second, 0);
+            if(compilerOptions.Jobs < 1) {
+                std::cerr << "Error: invalid number of jobs " << opt_with_value.second.GetCStr() << std::endl;
+                return ParsedOptions(-1);
+            }
+            continue;
+        }
+
+        if(opt_with_value.first == "--pch")
+        {
+            compilerOptions.PchFile = opt_with_value.second.GetCStr();
             continue;
         }
 
@@ -240,12 +262,22 @@ ParsedOptions parser_to_compiler_opts(const ParseResult& parseResult)
         }
     }
 
-    compilerOptions.InputScriptFile = parseResult.PosArgs[0].GetCStr();
+    for(const auto& pos_arg : parseResult.PosArgs)
+        compilerOptions.InputScriptFiles.push_back(pos_arg.GetCStr());
 
-    if(compilerOptions.OutputObjFile.empty()) {
+    if(!output_obj_file.empty()) {
+        if(compilerOptions.InputScriptFiles.size() > 1) {
+            std::cerr << "Error: output file cannot be set when compiling multiple scripts" << std::endl;
+            return ParsedOptions(-1);
+        }
+        compilerOptions.OutputObjFiles.push_back(output_obj_file);
+    }
+    else {
         // no output file explicitly set, let's use input.o instead
-        std::string filename = Path::RemoveExtension(compilerOptions.InputScriptFile.c_str()).GetCStr();
-        compilerOptions.OutputObjFile = filename + ".o";
+        for(const auto& input : compilerOptions.InputScriptFiles) {
+            std::string filename = Path::RemoveExtension(input.c_str()).GetCStr();
+            compilerOptions.OutputObjFiles.push_back(filename + ".o");
+        }
     }
 
     if(compilerOptions.Version.empty()) {
@@ -266,7 +298,7 @@ Copyright (c) 2021 AGS Team and contributors
 )EOS"
     );
 
-    ParseResult parseResult = Parse(argc,argv,{"-D", "-H", "--Headers", "-A", "-C", "-f", "-o", "--output"});
+    ParseResult parseResult = Parse(argc,argv,{"-D", "-H", "--Headers", "-A", "-C", "-f", "-o", "--output", "-j", "--pch"});
     ParsedOptions parsedOptions = parser_to_compiler_opts(parseResult);
 
     if(parsedOptions.Exit) return parsedOptions.ErrorCode;
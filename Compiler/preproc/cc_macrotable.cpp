@@ -14,6 +14,8 @@
 #include "util/string.h"
 #include "script/cc_common.h"
 #include "preproc/cc_macrotable.h"
+#include "util/stream.h"
+#include "util/string_utils.h"
 
 using namespace AGS::Common;
 
@@ -62,3 +64,24 @@ void MacroTable::clear()
 {
     _macro_table.clear();
 }
+
+void MacroTable::write(Stream *out) const
+{
+    out->WriteInt32(_macro_table.size());
+    for (const auto &macro : _macro_table)
+    {
+        StrUtil::WriteString(macro.first, out);
+        StrUtil::WriteString(macro.second, out);
+    }
+}
+
+void MacroTable::read(Stream *in)
+{
+    _macro_table.clear();
+    const int32_t count = in->ReadInt32();
+    for (int32_t i = 0; i < count; ++i)
+    {
+        String name = StrUtil::ReadString(in);
+        _macro_table[name] = StrUtil::ReadString(in);
+    }
+}
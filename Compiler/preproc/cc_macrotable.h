@@ -19,6 +19,8 @@
 
 typedef AGS::Common::String AGString;
 
+namespace AGS { namespace Common { class Stream; } }
+
 struct MacroTable {
 private:
     std::map<AGString,AGString> _macro_table;
@@ -29,6 +31,10 @@ public:
     void remove(const AGString &macroname);
     void merge(MacroTable & macro_table);
     void clear();
+    // write all the macros to the stream
+    void write(AGS::Common::Stream *out) const;
+    // replace the table contents with the macros written by write()
+    void read(AGS::Common::Stream *in);
 };
 
 #endif // __CC_MACROTABLE_H
\ No newline at end of file
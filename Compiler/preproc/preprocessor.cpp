@@ -521,6 +521,14 @@ namespace Preprocessor {
         _macros.merge(macros);
     }
 
+    void Preprocessor::WriteMacros(Stream *out) const {
+        _macros.write(out);
+    }
+
+    void Preprocessor::ReadMacros(Stream *in) {
+        _macros.read(in);
+    }
+
     void Preprocessor::SetAppVersion(const String &version) {
         _applicationVersion = Version(version);
     }
@@ -77,6 +77,10 @@ namespace Preprocessor {
         void SetAppVersion(const String& version);
         void MergeMacros(MacroTable &macros);
         void DefineMacro(const String &name, const String &value);
+        // Writes all the currently defined macros to the stream
+        void WriteMacros(Stream *out) const;
+        // Replaces all the defined macros with the ones written by WriteMacros
+        void ReadMacros(Stream *in);
 
         String Preprocess(const String &script, const String &scriptName);
     };
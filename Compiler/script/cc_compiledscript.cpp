@@ -18,6 +18,10 @@
 #include "script/cc_internal.h"       // macro definitions
 #include "script/cc_symboltable.h"     // symbolTable
 #include "script/cc_common.h"      // ccGetOption
+#include "util/stream.h"
+#include "util/string_utils.h"
+
+using namespace AGS::Common;
 
 void ccCompiledScript::write_cmd(int cmdd) {
     write_code(cmdd);
@@ -240,3 +244,40 @@ void ccCompiledScript::free_extra() {
     funccodeoffs = {};
     funcnumparams = {};
 }
+
+void ccCompiledScript::write_state(Stream *out) const {
+    Write(out);
+    out->WriteInt32(functions.size());
+    for (size_t i = 0; i < functions.size(); ++i) {
+        StrUtil::WriteCStr(functions[i].c_str(), out);
+        out->WriteInt32(funccodeoffs[i]);
+        out->WriteInt16(funcnumparams[i]);
+    }
+    out->WriteInt32(codeallocated);
+    out->WriteInt32(cur_sp);
+    out->WriteInt32(next_line);
+    out->WriteInt32(ax_val_type);
+    out->WriteInt32(ax_val_scope);
+}
+
+bool ccCompiledScript::read_state(Stream *in) {
+    if (!Read(in))
+        return false;
+    const int32_t num_funcs = in->ReadInt32();
+    if (num_funcs < 0)
+        return false;
+    functions.resize(num_funcs);
+    funccodeoffs.resize(num_funcs);
+    funcnumparams.resize(num_funcs);
+    for (int32_t i = 0; i < num_funcs; ++i) {
+        functions[i] = StrUtil::ReadCStrAsStdString(in);
+        funccodeoffs[i] = in->ReadInt32();
+        funcnumparams[i] = in->ReadInt16();
+    }
+    codeallocated = in->ReadInt32();
+    cur_sp = in->ReadInt32();
+    next_line = in->ReadInt32();
+    ax_val_type = in->ReadInt32();
+    ax_val_scope = in->ReadInt32();
+    return true;
+}
@@ -33,6 +33,11 @@ struct ccCompiledScript: public ccScript {
     // free the extra bits that ccScript doesn't have
     // FIXME: refactor this, implement std::move constructor for ccScript?
     void free_extra();
+    // write the whole compilation state, including the parts
+    // which ccScript::Write skips, so that compilation may be resumed later
+    void write_state(AGS::Common::Stream *out) const;
+    // read back the state written with write_state
+    bool read_state(AGS::Common::Stream *in);
     int  add_global(int,const char*);
     int  add_string(const char*);
     void add_fixup(int32_t,char);
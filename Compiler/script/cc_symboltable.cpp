@@ -17,6 +17,10 @@
 #include "script/cc_symboltable.h"
 #include "script/cc_internal.h"      // macro definitions
 #include "script/cc_symboldef.h"   // macro definitions
+#include "util/stream.h"
+#include "util/string_utils.h"
+
+using namespace AGS::Common;
 
 symbolTable::symbolTable() {
     normalIntSym = 0;
@@ -259,4 +263,70 @@ int symbolTable::add_operator(const char *nta, int priority, int vcpucmd) {
     return nss;
 }
 
-symbolTable sym;
+void symbolTable::write(Stream *out) const {
+    out->WriteInt32(normalIntSym);
+    out->WriteInt32(normalStringSym);
+    out->WriteInt32(normalFloatSym);
+    out->WriteInt32(normalVoidSym);
+    out->WriteInt32(nullSym);
+    out->WriteInt32(stringStructSym);
+    out->WriteInt32(entries.size());
+    for (const auto &entry : entries) {
+        StrUtil::WriteString(entry.sname.c_str(), entry.sname.size(), out);
+        out->WriteInt16(entry.stype);
+        out->WriteInt32(entry.flags);
+        out->WriteInt16(entry.vartype);
+        out->WriteInt32(entry.soffs);
+        out->WriteInt32(entry.ssize);
+        out->WriteInt16(entry.sscope);
+        out->WriteInt32(entry.arrsize);
+        out->WriteInt16(entry.extends);
+        out->WriteInt32(entry.funcparams.size());
+        for (const auto &param : entry.funcparams) {
+            out->WriteInt32(param.Type);
+            out->WriteInt32(param.DefaultValue);
+            out->WriteInt8(param.HasDefaultValue ? 1 : 0);
+        }
+    }
+}
+
+bool symbolTable::read(Stream *in) {
+    reset();
+    entries.clear();
+    symbolTree.clear();
+
+    normalIntSym = in->ReadInt32();
+    normalStringSym = in->ReadInt32();
+    normalFloatSym = in->ReadInt32();
+    normalVoidSym = in->ReadInt32();
+    nullSym = in->ReadInt32();
+    stringStructSym = in->ReadInt32();
+    const int32_t num_entries = in->ReadInt32();
+    if (num_entries < 0)
+        return false;
+    entries.resize(num_entries);
+    for (int32_t i = 0; i < num_entries; ++i) {
+        SymbolTableEntry &entry = entries[i];
+        entry.sname = StrUtil::ReadString(in).GetCStr();
+        entry.stype = in->ReadInt16();
+        entry.flags = in->ReadInt32();
+        entry.vartype = in->ReadInt16();
+        entry.soffs = in->ReadInt32();
+        entry.ssize = in->ReadInt32();
+        entry.sscope = in->ReadInt16();
+        entry.arrsize = in->ReadInt32();
+        entry.extends = in->ReadInt16();
+        const int32_t num_params = in->ReadInt32();
+        if (num_params < 0)
+            return false;
+        entry.funcparams.resize(num_params);
+        for (auto &param : entry.funcparams) {
+            param.Type = in->ReadInt32();
+            param.DefaultValue = in->ReadInt32();
+            param.HasDefaultValue = in->ReadInt8() != 0;
+        }
+        // names are unique, see add_ex(), so the lookup tree may be rebuilt
+        symbolTree.addEntry(entry.sname.c_str(), i);
+    }
+    return true;
+}
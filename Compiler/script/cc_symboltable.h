@@ -18,10 +18,13 @@
 #include <map>
 #include <string>
 #include <vector>
+#include "script/cc_common.h"          // CC_THREAD_LOCAL
 #include "script/cs_parser_common.h"   // macro definitions
 #include "script/cc_treemap.h"
 #include "script/cc_symboldef.h"
 
+namespace AGS { namespace Common { class Stream; } }
+
 // So there's another symbol definition in cc_symboldef.h
 struct SymbolTableEntry
 {
@@ -77,6 +80,11 @@ struct symbolTable {
 
     int  get_type(int ii);
 
+    // writes all the symbols and predefined indexes to the stream
+    void write(AGS::Common::Stream *out) const;
+    // replaces the table contents with the ones written by write();
+    // returns false if the data is not valid
+    bool read(AGS::Common::Stream *in);
 
 private:
 
@@ -90,6 +98,7 @@ private:
 };
 
 
-extern symbolTable sym;
+// the symbol table of the current compilation, one per compiling thread
+extern CC_THREAD_LOCAL symbolTable sym;
 
 #endif //__CC_SYMBOLTABLE_H
@@ -21,10 +21,14 @@
 #include "script/cc_internal.h"
 #include "script/cs_parser.h"
 
-const char *ccSoftwareVersion = "1.0";
+using namespace AGS::Common;
 
-std::vector<const char*> defaultheaders;
-std::vector<const char*> defaultHeaderNames;
+// Compilation settings and state are kept per thread,
+// so that independent scripts may be compiled in parallel
+CC_THREAD_LOCAL const char *ccSoftwareVersion = "1.0";
+
+CC_THREAD_LOCAL std::vector<const char*> defaultheaders;
+CC_THREAD_LOCAL std::vector<const char*> defaultHeaderNames;
 
 void ccGetExtensions(std::vector<std::string> &exts)
 {
@@ -50,14 +54,11 @@ void ccSetSoftwareVersion(const char *versionNumber) {
     ccSoftwareVersion = versionNumber;
 }
 
-ccScript* ccCompileText(const char *texo, const char *scriptName) {
+ccCompiledScript *ccCompileHeaders() {
     ccCompiledScript *cctemp = new ccCompiledScript();
 
     sym.reset();
 
-    if (scriptName == NULL)
-        scriptName = "Main script";
-
     cc_clear_error();
 
     for (size_t t=0;t<defaultheaders.size();t++) {
@@ -71,11 +72,43 @@ ccScript* ccCompileText(const char *texo, const char *scriptName) {
         if (cc_has_error()) break;
     }
 
-    if (!cc_has_error()) {
-        ccCurScriptName = scriptName;
-        cctemp->start_new_section(ccCurScriptName.c_str());
-        cc_compile(texo,cctemp);
+    if (cc_has_error()) {
+        delete cctemp;
+        return NULL;
+    }
+    return cctemp;
+}
+
+void ccWriteHeadersState(const ccCompiledScript *headers, Stream *out) {
+    sym.write(out);
+    headers->write_state(out);
+}
+
+ccCompiledScript *ccReadHeadersState(Stream *in) {
+    ccCompiledScript *cctemp = new ccCompiledScript();
+    if (!sym.read(in) || !cctemp->read_state(in)) {
+        delete cctemp;
+        return NULL;
     }
+    return cctemp;
+}
+
+ccScript* ccCompileText(const char *texo, const char *scriptName) {
+    ccCompiledScript *cctemp = ccCompileHeaders();
+    if (cctemp == NULL)
+        return NULL;
+    return ccCompileTextAfterHeaders(cctemp, texo, scriptName);
+}
+
+ccScript *ccCompileTextAfterHeaders(ccCompiledScript *cctemp, const char *texo, const char *scriptName) {
+    if (scriptName == NULL)
+        scriptName = "Main script";
+
+    cc_clear_error();
+
+    ccCurScriptName = scriptName;
+    cctemp->start_new_section(ccCurScriptName.c_str());
+    cc_compile(texo,cctemp);
 
     if (cc_has_error()) {
         delete cctemp;
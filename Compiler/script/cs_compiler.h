@@ -18,6 +18,7 @@
 #ifndef __CS_COMPILER_H
 #define __CS_COMPILER_H
 
+#include "script/cc_common.h"  // CC_THREAD_LOCAL
 #include "script/cc_script.h"  // ccScript
 
 // ********* SCRIPT COMPILATION FUNCTIONS **************
@@ -42,6 +43,18 @@ extern void ccSetSoftwareVersion(const char *version);
 // compile the script supplied, returns NULL on failure
 extern ccScript *ccCompileText(const char *script, const char *scriptName);
 
-extern const char *ccSoftwareVersion;
+struct ccCompiledScript;
+// compile only the default headers; returns the compilation state
+// to continue from with ccCompileTextAfterHeaders, or NULL on failure
+extern ccCompiledScript *ccCompileHeaders();
+// compile the script supplied on top of the state returned by ccCompileHeaders
+// or ccReadHeadersState; the state is consumed, returns NULL on failure
+extern ccScript *ccCompileTextAfterHeaders(ccCompiledScript *headers, const char *script, const char *scriptName);
+// write the compiled headers state, along with the symbol table
+extern void ccWriteHeadersState(const ccCompiledScript *headers, AGS::Common::Stream *out);
+// restore the compiled headers state and the symbol table, returns NULL on failure
+extern ccCompiledScript *ccReadHeadersState(AGS::Common::Stream *in);
+
+extern CC_THREAD_LOCAL const char *ccSoftwareVersion;
 
 #endif // __CS_COMPILER_H
\ No newline at end of file
@@ -28,7 +28,7 @@
 #include "util/string_utils.h"
 #include "util/utf8.h"
 
-extern int currentline;
+extern CC_THREAD_LOCAL int currentline;
 
 char ccCopyright[]="ScriptCompiler32 v" SCOM_VERSIONSTR " (c) 2000-2007 Chris Jones and 2011-2026 others";
 
@@ -79,8 +79,8 @@ void clear_chunk_list(std::vector<ccChunk> *list) {
 
 static int is_part_of_symbol(char thischar, char startchar) {
     // workaround for strings
-    static int sayno_next_char = 0;
-    static int next_is_escaped = 0;
+    static CC_THREAD_LOCAL int sayno_next_char = 0;
+    static CC_THREAD_LOCAL int next_is_escaped = 0;
     if (sayno_next_char) {
         sayno_next_char = 0;
         return 0;
@@ -144,10 +144,14 @@ static int is_part_of_symbol(char thischar, char startchar) {
 
 // NOTE: global buffers meant to store parsed lines and symbols;
 // most of these were local char arrays of fixed size, refactored into global std::string for convenience
-std::string constructedMemberName;
-std::string thissymbol;
-std::string thissymbol_mangled;
-std::string constructedFunctionName;
+// The symbol table is defined here, by its main user, so that
+// the compiler may inline the access to the thread-local object
+CC_THREAD_LOCAL symbolTable sym;
+
+CC_THREAD_LOCAL std::string constructedMemberName;
+CC_THREAD_LOCAL std::string thissymbol;
+CC_THREAD_LOCAL std::string thissymbol_mangled;
+CC_THREAD_LOCAL std::string constructedFunctionName;
 
 const char *get_member_full_name(int structSym, int memberSym) {
 
@@ -1694,7 +1698,7 @@ int extractPathIntoParts(VariableSymlist *variablePath, int slilen, int32_t *sym
   return variablePathSize;
 }
 
-int readcmd_lastcalledwith=0;
+CC_THREAD_LOCAL int readcmd_lastcalledwith=0;
 int get_readcmd_for_size(int sizz, int writeinstead) {
   int readcmd = SCMD_MEMREAD;
   if (writeinstead) {
@@ -2083,7 +2087,7 @@ int do_variable_memory_access(ccCompiledScript *scrip, int variableSym,
 
 // If the variable being read is actually a property, not a
 // member variable, then read_variable_into_ax sets this
-int readonly_cannot_cause_error = 0;
+CC_THREAD_LOCAL int readonly_cannot_cause_error = 0;
 
 int do_variable_ax(int slilen, int32_t *syml, ccCompiledScript*scrip, int writing, int mustBeWritable, bool negateLiteral = false) {
   // read the various types of values into AX
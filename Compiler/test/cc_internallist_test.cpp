@@ -13,9 +13,8 @@
 //=============================================================================
 #include "gtest/gtest.h"
 #include "script/cc_internallist.h"
+#include "script/cc_common.h" // currentline, modified by getnext
 
-// defined in script_common, modified by getnext
-extern int currentline; 
 
 
 TEST(InternalList, Constructor) {
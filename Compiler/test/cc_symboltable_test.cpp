@@ -15,6 +15,10 @@
 
 #include "script/cc_symboltable.h"
 #include "script/cc_symboldef.h"
+#include "util/file.h"
+#include "util/stream.h"
+
+using namespace AGS::Common;
 
 TEST(SymbolTable, GetNameNonExistent) {
     symbolTable testSym;
@@ -227,3 +231,50 @@ TEST(SymbolTable, OperatorToVCPUCmd) {
 	testSym.entries[sym_01].vartype = 100;
 	ASSERT_TRUE(testSym.entries[sym_01].operatorToVCPUCmd() == 100);
 }
+
+TEST(SymbolTable, WriteRead) {
+    const char *filename = "symboltable_test.tmp";
+    symbolTable testSym;
+    testSym.reset();
+    int foo_sym = testSym.add_ex("foo", SYM_FUNCTION, 4);
+    testSym.entries[foo_sym].flags = SFLG_IMPORTED;
+    testSym.entries[foo_sym].sscope = 2;
+    FuncParamInfo param;
+    param.Type = testSym.normalIntSym;
+    param.DefaultValue = 7;
+    param.HasDefaultValue = true;
+    testSym.entries[foo_sym].funcparams.resize(2);
+    testSym.entries[foo_sym].funcparams[1] = param;
+    testSym.stringStructSym = foo_sym;
+    {
+        std::unique_ptr<Stream> out(File::CreateFile(filename));
+        ASSERT_TRUE(out != nullptr);
+        testSym.write(out.get());
+    }
+
+    symbolTable readSym;
+    readSym.add_ex("bar", 0, 0);
+    {
+        std::unique_ptr<Stream> in(File::OpenFileRead(filename));
+        ASSERT_TRUE(in != nullptr);
+        ASSERT_TRUE(readSym.read(in.get()));
+    }
+    File::DeleteFile(filename);
+
+    ASSERT_EQ(testSym.entries.size(), readSym.entries.size());
+    EXPECT_EQ(-1, readSym.find("bar"));
+    EXPECT_EQ(foo_sym, readSym.find("foo"));
+    EXPECT_EQ(testSym.find("while"), readSym.find("while"));
+    EXPECT_EQ(testSym.normalIntSym, readSym.normalIntSym);
+    EXPECT_EQ(testSym.nullSym, readSym.nullSym);
+    EXPECT_EQ(foo_sym, readSym.stringStructSym);
+    const SymbolTableEntry &entry = readSym.entries[foo_sym];
+    EXPECT_EQ(SYM_FUNCTION, entry.stype);
+    EXPECT_EQ(4, entry.ssize);
+    EXPECT_EQ(SFLG_IMPORTED, entry.flags);
+    EXPECT_EQ(2, entry.sscope);
+    ASSERT_EQ(2u, entry.funcparams.size());
+    EXPECT_EQ(static_cast<uint32_t>(testSym.normalIntSym), entry.funcparams[1].Type);
+    EXPECT_EQ(7, entry.funcparams[1].DefaultValue);
+    EXPECT_TRUE(entry.funcparams[1].HasDefaultValue);
+}
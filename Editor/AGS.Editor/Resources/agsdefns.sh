@@ -739,6 +739,28 @@ builtin managed struct Set
 };
 #endif // SCRIPT_API_v350
 
+#ifdef SCRIPT_API_v363
+builtin managed struct StringBuilder
+{
+  /// Creates a new empty StringBuilder, optionally reserving space for the given number of bytes.
+  import static StringBuilder* Create(int capacity = 0); // $AUTOCOMPLETESTATICONLY$
+
+  /// Appends the specified string to the end of the text.
+  import void Append(const string text);
+  /// Appends a single character to the end of the text.
+  import void AppendChar(int extraChar);
+  /// Removes all the text.
+  import void Clear();
+  /// Inserts the specified string at the given character index.
+  import void Insert(int index, const string text);
+  /// Creates a new String containing the accumulated text.
+  import String ToString();
+
+  /// Gets the length of the accumulated text, in characters.
+  import readonly attribute int Length;
+};
+#endif // SCRIPT_API_v363
+
 builtin managed struct AudioClip;
 
 builtin managed struct ViewFrame {
@@ -885,6 +907,10 @@ builtin struct Room {
   /// Gets the number of backgrounds in this room.
   import static readonly attribute int BackgroundCount;
 #endif
+#ifdef SCRIPT_API_v363
+  /// Starts loading the specified room in background, so that changing to it later is faster. Returns false if the room does not exist.
+  import static bool Preload(int room);   // $AUTOCOMPLETESTATICONLY$
+#endif // SCRIPT_API_v363
 };
 
 builtin struct Parser {
@@ -1503,6 +1529,12 @@ builtin managed struct File {
   /// Writes up to "count" number of bytes from the provided dynamic array, starting with certain index. Returns actual number of written bytes.
   import int    WriteRawBytes(char bytes[], int index, int count);
 #endif // SCRIPT_API_v362
+#ifdef SCRIPT_API_v363
+  /// Reads the whole file as a text; returns null if the file could not be opened.
+  import static String ReadAllText(const string filename);   // $AUTOCOMPLETESTATICONLY$
+  /// Reads all the lines of text from the file; returns null if the file could not be opened.
+  import static String[] ReadLines(const string filename);   // $AUTOCOMPLETESTATICONLY$
+#endif // SCRIPT_API_v363
   int reserved[2];   // $AUTOCOMPLETEIGNORE$
 };
 
@@ -3524,6 +3556,8 @@ builtin struct Game {
   import static void Resume();
   /// Returns the default crossfade speed of the specified audio type, in volume units per step (1 - 100). Value 0 disables crossfade.
   import static void SetAudioTypeCrossfadeSpeed(AudioType, int speed);
+  /// Sets how often this script's repeatedly_execute_always and late_repeatedly_execute_always are run, in game ticks; 1 means every tick.
+  import static void SetRepExecInterval(int ticks);
   /// Returns whether the game is currently paused.
   import static readonly attribute bool IsPaused;
   /// Gets/sets game's running speed, in frames per second.
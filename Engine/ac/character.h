@@ -236,6 +236,9 @@ void Character_DoMove(CharacterInfo *chaa, const char *api_name,
 // merging CharacterInfo and CharacterExtras.
 //
 void UpdateCharacterMoveAndAnim(CharacterInfo *chi, CharacterExtras *chex, std::vector<int> &followingAsSheep);
+// Tests if the character which is not in the displayed room has anything to update;
+// if not, then UpdateCharacterMoveAndAnim may be skipped for it
+bool IsCharacterActiveOffRoom(const CharacterInfo *chi, const CharacterExtras *chex);
 void UpdateFollowingExactlyCharacter(CharacterInfo *chi);
 bool UpdateCharacterTurning(CharacterInfo *chi, CharacterExtras *chex);
 void UpdateCharacterMoving(CharacterInfo *chi, CharacterExtras *chex, int &doing_nothing);
@@ -129,6 +129,26 @@ void UpdateCharacterMoveAndAnim(CharacterInfo *chi, CharacterExtras *chex, std::
     chex->process_idle_this_time = 0;
 }
 
+bool IsCharacterActiveOffRoom(const CharacterInfo *chi, const CharacterExtras *chex)
+{
+    // Characters outside of the displayed room are not moved, animated and
+    // do not idle, but they may still finish turning, follow someone,
+    // have their loop and frame fixed up, or reset the idle flag.
+    if ((chi->walking >= TURNING_AROUND) || (chex->following >= 0) ||
+        (chex->process_idle_this_time != 0))
+        return true;
+    const int view = chi->view;
+    if (view < 0 || view >= views.size())
+        return true;
+    // Match the conditions in FixupCharacterLoopAndFrame, which either
+    // fixes the loop and frame, or reports an error
+    const ViewStruct &vs = views[view];
+    if (chi->loop < 0 || chi->loop >= vs.numLoops)
+        return true;
+    const int frames_in_loop = vs.loops[chi->loop].numFrames;
+    return (frames_in_loop == 0) || (chi->frame >= frames_in_loop);
+}
+
 void UpdateFollowingExactlyCharacter(CharacterInfo *chi)
 {
     const auto &following = game.chars[charextra[chi->index_id].following];
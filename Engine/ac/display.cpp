@@ -588,11 +588,16 @@ bool try_auto_play_speech(const char *text, const char *&replace_text, int chari
 int source_text_length = -1;
 
 int GetTextDisplayLength(const char *text)
+{
+    return GetTextDisplayLength(text, strlen(text));
+}
+
+int GetTextDisplayLength(const char *text, size_t text_len)
 {
     // Skip voice-over token from the length calculation if required
     if (play.unfactor_speech_from_textlength != 0)
-        text = skip_voiceover_token(text);
-    return static_cast<int>(strlen(text));
+        text_len -= skip_voiceover_token(text) - text;
+    return static_cast<int>(text_len);
 }
 
 // Calculates lipsync frame duration (or duration per character) in game loops.
@@ -154,6 +154,8 @@ void post_display_cleanup();
 bool try_auto_play_speech(const char *text, const char *&replace_text, int charid);
 // Calculates meaningful length of the displayed text
 int GetTextDisplayLength(const char *text);
+// Calculates meaningful length of the displayed text, whose full length is already known
+int GetTextDisplayLength(const char *text, size_t text_len);
 // Calculates number of game loops for displaying a text on screen
 int GetTextDisplayTime(const char *text, int canberel = 0);
 // Draw an (optionally) outlined text
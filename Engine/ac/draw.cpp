@@ -48,6 +48,7 @@
 #include "ac/dynobj/scriptsystem.h"
 #include "debug/debugger.h"
 #include "debug/debug_log.h"
+#include "debug/profiler.h"
 #include "font/fonts.h"
 #include "gui/guimain.h"
 #include "gui/guiobject.h"
@@ -296,6 +297,7 @@ public:
 
         // If not in any cache, then try loading the sprite's bitmap,
         // and create a texture data from it
+        AGS_PROFILE_ZONE("TextureCache::Load");
         Bitmap *bitmap = source;
         std::unique_ptr<Bitmap> tmp_source;
         if (!source)
@@ -731,6 +733,7 @@ void init_draw_method()
 
     // Must init this as early as possible, as this affects bitmap->texture conv
     gfxDriver->UseSmoothScaling(play.ShouldAASprites());
+    gfxDriver->SetRenderThreads(usetup.RenderThreads);
 
     if (drawstate.SoftwareRender)
     {
@@ -1333,6 +1336,7 @@ extern volatile bool want_exit, abort_engine;
 
 void render_to_screen()
 {
+    AGS_PROFILE_ZONE("render_to_screen");
     // Stage: final plugin callback (still drawn on game screen)
     if (pl_any_want_hook(kPluginEvt_FinalScreenDraw))
     {
@@ -2348,6 +2352,7 @@ static void add_roomovers_for_drawing()
 // Compiles a list of room sprites (characters, objects, background)
 void prepare_room_sprites()
 {
+    AGS_PROFILE_ZONE("prepare_room_sprites");
     // Background sprite is required for the non-software renderers always,
     // and for software renderer in case there are overlapping viewports.
     // Note that software DDB is just a tiny wrapper around bitmap, so overhead is negligible.
@@ -2471,6 +2476,16 @@ struct DrawFPS
     int font = -1; // in case normal font changes at runtime
 } gl_DrawFPS;
 
+// GUI damage debug view: outlines the parts of GUI surfaces
+// which were redrawn during the last frame
+struct DrawGUIDamage
+{
+    IDriverDependantBitmap* ddb = nullptr;
+    std::unique_ptr<Bitmap> bmp;
+    std::vector<Rect> FullRects; // GUIs redrawn fully
+    std::vector<Rect> PartRects; // GUI regions redrawn after controls changes
+} gl_DrawGUIDamage;
+
 void dispose_engine_overlay()
 {
     gl_DrawFPS.bmp.reset();
@@ -2478,6 +2493,26 @@ void dispose_engine_overlay()
         gfxDriver->DestroyDDB(gl_DrawFPS.ddb);
     gl_DrawFPS.ddb = nullptr;
     gl_DrawFPS.font = -1;
+    gl_DrawGUIDamage.bmp.reset();
+    if (gl_DrawGUIDamage.ddb)
+        gfxDriver->DestroyDDB(gl_DrawGUIDamage.ddb);
+    gl_DrawGUIDamage.ddb = nullptr;
+}
+
+void draw_gui_damage(const Rect &viewport)
+{
+    auto &damageDisplay = gl_DrawGUIDamage.bmp;
+    recycle_bitmap(damageDisplay, game.GetColorDepth(), viewport.GetWidth(), viewport.GetHeight(), true);
+    const color_t full_color = damageDisplay->GetCompatibleColor(12); // light red
+    const color_t part_color = damageDisplay->GetCompatibleColor(10); // light green
+    for (const auto &rc : gl_DrawGUIDamage.FullRects)
+        damageDisplay->DrawRect(rc, full_color);
+    for (const auto &rc : gl_DrawGUIDamage.PartRects)
+        damageDisplay->DrawRect(rc, part_color);
+
+    gl_DrawGUIDamage.ddb = recycle_ddb_bitmap(gl_DrawGUIDamage.ddb, damageDisplay.get());
+    gfxDriver->DrawSprite(0, 0, gl_DrawGUIDamage.ddb);
+    invalidate_sprite_glob(0, 0, gl_DrawGUIDamage.ddb);
 }
 
 void draw_fps(const Rect &viewport)
@@ -2601,6 +2636,8 @@ static void draw_gui_controls_batch(int gui_id)
 // Draw GUI and overlays of all kinds, anything outside the room space
 void draw_gui_and_overlays()
 {
+    AGS_PROFILE_ZONE("draw_gui_and_overlays");
+    static std::vector<Rect> gui_dirty_rects; // reused between frames
     // Draw gui controls on separate textures if:
     // - it is a 3D renderer (software one may require adjustments -- needs testing)
     // - not legacy alpha blending (may we implement specific texture blend?)
@@ -2627,6 +2664,8 @@ void draw_gui_and_overlays()
 
     // Add GUIs
     set_our_eip(35);
+    gl_DrawGUIDamage.FullRects.clear();
+    gl_DrawGUIDamage.PartRects.clear();
     if (((debug_flags & DBG_NOIFACE)==0) && (displayed_room >= 0)) {
         GUI::Options.GreyOutInvWindow = play.inventory_greys_out;
 
@@ -2643,9 +2682,26 @@ void draw_gui_and_overlays()
                 eip_guinum = index;
                 set_our_eip(372);
                 const bool draw_with_controls = !draw_controls_as_textures;
-                if (gui.HasChanged() || (draw_with_controls && gui.HasControlsChanged()))
+                // When only some of the controls have changed, try to redraw only
+                // the parts of the GUI surface which they have damaged
+                auto &gbg = guibg[index];
+                if (draw_with_controls && gui.HasControlsChanged() && gbg.Bmp && gbg.Ddb &&
+                    (gbg.Bmp->GetSize() == Size(gui.GetWidth(), gui.GetHeight())) &&
+                    !((game.options[OPT_NEWGUIALPHA] == kGuiAlphaRender_Legacy) && (gui.GetBgImage() > 0)) &&
+                    gui.CalcDirtyRegions(gui_dirty_rects))
+                {
+                    for (const auto &rc : gui_dirty_rects)
+                    {
+                        gui.DrawRegion(gbg.Bmp.get(), rc);
+                        if ((debug_flags & DBG_GUIDAMAGE) != 0)
+                            gl_DrawGUIDamage.PartRects.push_back(Rect::MoveBy(rc, gui.GetX(), gui.GetY()));
+                    }
+                    sync_object_texture(gbg, gui.HasAlphaChannel());
+                }
+                else if (gui.HasChanged() || (draw_with_controls && gui.HasControlsChanged()))
                 {
-                    auto &gbg = guibg[index];
+                    if ((debug_flags & DBG_GUIDAMAGE) != 0)
+                        gl_DrawGUIDamage.FullRects.push_back(RectWH(gui.GetX(), gui.GetY(), gui.GetWidth(), gui.GetHeight()));
                     recycle_bitmap(gbg.Bmp, game.GetColorDepth(), gui.GetWidth(), gui.GetHeight(), true);
                     // Configure GUI drawing alpha support, depending on a game version:
                     // old versions of the engine did not make opaque drawing colors, so anything
@@ -2764,6 +2820,7 @@ void GfxDriverOnInitCallback(void *data)
 // Schedule room rendering: background, objects, characters
 static void construct_room_view()
 {
+    AGS_PROFILE_ZONE("construct_room_view");
     draw_preroom_background();
     prepare_room_sprites();
     // reset the Baselines Changed flag now that we've drawn stuff
@@ -3024,6 +3081,8 @@ void construct_engine_overlay()
     const Rect &viewport = RectWH(game.GetGameRes());
     gfxDriver->BeginSpriteBatch(viewport, SpriteTransform(), kFlip_None, nullptr, RENDER_BATCH_ENGINE_OVERLAY);
 
+    if ((debug_flags & DBG_GUIDAMAGE) != 0)
+        draw_gui_damage(viewport);
     if (display_fps != kFPS_Hide)
         draw_fps(viewport);
 
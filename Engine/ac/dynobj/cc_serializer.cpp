@@ -21,6 +21,7 @@
 #include "ac/dynobj/scriptcamera.h"
 #include "ac/dynobj/scriptcontainers.h"
 #include "ac/dynobj/scriptfile.h"
+#include "ac/dynobj/scriptstringbuilder.h"
 #include "ac/dynobj/scriptviewport.h"
 #include "ac/game.h"
 #include "debug/debug_log.h"
@@ -113,6 +114,10 @@ void AGSDeSerializer::Unserialize(int index, const char *objectType, const char
         ScriptDateTime *scf = new ScriptDateTime();
         scf->Unserialize(index, &mems, data_sz);
     }
+    else if (strcmp(objectType, "StringBuilder") == 0) {
+        ScriptStringBuilder *scf = new ScriptStringBuilder();
+        scf->Unserialize(index, &mems, data_sz);
+    }
     else if (strcmp(objectType, "ViewFrame") == 0) {
         ScriptViewFrame *scf = new ScriptViewFrame();
         scf->Unserialize(index, &mems, data_sz);
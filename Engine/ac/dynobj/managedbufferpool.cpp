@@ -0,0 +1,181 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2026 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+#include "ac/dynobj/managedbufferpool.h"
+#include <algorithm>
+#include <assert.h>
+#include <cinttypes>
+#include "debug/out.h"
+
+using namespace AGS::Common;
+
+// Size class id used for the large blocks allocated on heap
+const uint32_t LARGE_BLOCK_CLASS = UINT32_MAX;
+
+ManagedBufferPool bufferPool;
+
+
+ManagedBufferPool::~ManagedBufferPool()
+{
+    // NOTE: slabs are released by the vector; any buffers still in use
+    // at this point are leaked on purpose, as program is being closed.
+}
+
+// Size classes are: 16 - 256 bytes with 16 bytes step (16 classes),
+// 320 - 512 with 64 bytes step (4 classes), 640 - 1024 with 128 bytes step (4 classes)
+uint32_t ManagedBufferPool::GetSizeClass(size_t block_size)
+{
+    if (block_size <= 256)
+        return static_cast<uint32_t>((std::max<size_t>(block_size, 1u) + 15) / 16 - 1);
+    if (block_size <= 512)
+        return static_cast<uint32_t>(16 + (block_size - 257) / 64);
+    if (block_size <= MaxBlockSize)
+        return static_cast<uint32_t>(20 + (block_size - 513) / 128);
+    return LARGE_BLOCK_CLASS;
+}
+
+size_t ManagedBufferPool::GetClassBlockSize(uint32_t size_class)
+{
+    if (size_class < 16)
+        return (size_class + 1) * 16;
+    if (size_class < 20)
+        return 256 + (size_class - 15) * 64;
+    return 512 + (size_class - 19) * 128;
+}
+
+uint8_t *ManagedBufferPool::AllocateBlock(uint32_t size_class)
+{
+    SizeClass &sc = _classes[size_class];
+    if (sc.FreeList)
+    {
+        FreeBlock *block = sc.FreeList;
+        sc.FreeList = block->Next;
+        return reinterpret_cast<uint8_t*>(block);
+    }
+
+    const size_t block_size = GetClassBlockSize(size_class);
+    if (static_cast<size_t>(sc.SlabEnd - sc.SlabPos) < block_size)
+    {
+        // NOTE: the remainder of the previous slab, if any, is smaller
+        // than a block, and is left unused
+        _slabs.emplace_back(new uint8_t[SlabSize]);
+        sc.SlabPos = _slabs.back().get();
+        sc.SlabEnd = sc.SlabPos + SlabSize;
+        _stats.SlabsAllocated++;
+        _stats.SlabMemory += SlabSize;
+    }
+    uint8_t *block = sc.SlabPos;
+    sc.SlabPos += block_size;
+    return block;
+}
+
+uint8_t *ManagedBufferPool::Allocate(size_t size)
+{
+    const size_t block_size = size + sizeof(BlockHeader);
+    const uint32_t size_class = GetSizeClass(block_size);
+    uint8_t *block;
+    if (size_class == LARGE_BLOCK_CLASS)
+    {
+        block = new uint8_t[block_size];
+        _stats.LargeAllocs++;
+    }
+    else
+    {
+        block = AllocateBlock(size_class);
+        _classes[size_class].Allocs++;
+        _classes[size_class].InUse++;
+    }
+
+    reinterpret_cast<BlockHeader*>(block)->SizeClass = size_class;
+    _stats.Allocs++;
+    _stats.InUse++;
+    _stats.MaxInUse = std::max(_stats.MaxInUse, _stats.InUse);
+    return block + sizeof(BlockHeader);
+}
+
+void ManagedBufferPool::Free(void *buf)
+{
+    if (!buf)
+        return;
+
+    uint8_t *block = static_cast<uint8_t*>(buf) - sizeof(BlockHeader);
+    const uint32_t size_class = reinterpret_cast<BlockHeader*>(block)->SizeClass;
+    if (size_class == LARGE_BLOCK_CLASS)
+    {
+        delete[] block;
+    }
+    else
+    {
+        assert(size_class < SizeClassCount);
+        SizeClass &sc = _classes[size_class];
+        FreeBlock *free_block = reinterpret_cast<FreeBlock*>(block);
+        free_block->Next = sc.FreeList;
+        sc.FreeList = free_block;
+        sc.InUse--;
+    }
+    _stats.Frees++;
+    _stats.InUse--;
+}
+
+bool ManagedBufferPool::Trim()
+{
+    for (const auto &sc : _classes)
+    {
+        if (sc.InUse > 0)
+            return false;
+    }
+
+    for (auto &sc : _classes)
+    {
+        sc.FreeList = nullptr;
+        sc.SlabPos = nullptr;
+        sc.SlabEnd = nullptr;
+    }
+    _slabs.clear();
+    _stats.SlabMemory = 0u;
+    return true;
+}
+
+void ManagedBufferPool::PrintStats() const
+{
+    Debug::Printf(kDbgGroup_ManObj, kDbgMsg_Info,
+        "Managed Buffer Pool stats:\n"
+        "\tBuffers in use:              %+10" PRIu64 "\n"
+        "\tMax buffers in use at once:  %+10" PRIu64 "\n"
+        "\tTotal buffers allocated:     %+10" PRIu64 "\n"
+        "\tTotal buffers freed:         %+10" PRIu64 "\n"
+        "\tLarge buffers (on heap):     %+10" PRIu64 "\n"
+        "\tSlabs allocated:             %+10" PRIu64 "\n"
+        "\tSlab memory reserved:        %+10" PRIu64 "",
+        _stats.InUse,
+        _stats.MaxInUse,
+        _stats.Allocs, _stats.Frees,
+        _stats.LargeAllocs,
+        _stats.SlabsAllocated,
+        static_cast<uint64_t>(_stats.SlabMemory)
+    );
+    for (uint32_t i = 0; i < SizeClassCount; ++i)
+    {
+        const auto &sc = _classes[i];
+        if (sc.Allocs == 0u)
+            continue;
+        Debug::Printf(kDbgGroup_ManObj, kDbgMsg_Debug,
+            "\tSize class %4zu: allocated %10" PRIu64 ", in use %10" PRIu64 "",
+            GetClassBlockSize(i), sc.Allocs, sc.InUse);
+    }
+}
+
+void ManagedBufferDeleter::operator()(uint8_t *buf) const
+{
+    bufferPool.Free(buf);
+}
@@ -0,0 +1,113 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2026 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+//
+// ManagedBufferPool allocates memory for the script managed objects, such
+// as strings, user structs and dynamic arrays.
+//
+// Small buffers are taken from the size-class slabs: each size class keeps
+// a list of freed blocks, which are reused by the next allocations of the
+// same class, so that the scripts which create and discard lots of short
+// objects (e.g. when building strings) do not call the heap allocator
+// each time. Large buffers are allocated on heap as usual.
+//
+// NOTE: the pool is not thread-safe, same as the managed object pool.
+//
+//=============================================================================
+#ifndef __CC_MANAGEDBUFFERPOOL_H
+#define __CC_MANAGEDBUFFERPOOL_H
+
+#include <memory>
+#include <vector>
+#include "platform/types.h"
+
+class ManagedBufferPool
+{
+public:
+    // Number of the size classes served from slabs
+    static const size_t SizeClassCount = 24;
+    // Size of the largest block served from slabs, including internal header
+    static const size_t MaxBlockSize = 1024;
+    // Size of the memory chunk allocated for a slab
+    static const size_t SlabSize = 64 * 1024;
+
+    struct Stats
+    {
+        uint64_t Allocs = 0u; // total number of allocations
+        uint64_t Frees = 0u; // total number of deallocations
+        uint64_t LargeAllocs = 0u; // allocations which were done on heap
+        uint64_t InUse = 0u; // number of buffers currently in use
+        uint64_t MaxInUse = 0u; // max number of buffers in use at once
+        uint64_t SlabsAllocated = 0u; // total number of slabs allocated
+        size_t SlabMemory = 0u; // memory currently reserved by slabs
+    };
+
+    ManagedBufferPool() = default;
+    ~ManagedBufferPool();
+
+    // Allocates a buffer of the given size; the buffer must be freed
+    // by calling Free(), it's contents are not initialized
+    uint8_t *Allocate(size_t size);
+    // Frees the buffer previously returned by Allocate()
+    void Free(void *buf);
+    // Releases all the slabs if there are no buffers in use;
+    // returns whether the slabs were released
+    bool Trim();
+    // Gets allocation statistics
+    const Stats &GetStats() const { return _stats; }
+    // Prints allocation statistics to the debug log
+    void PrintStats() const;
+
+private:
+    // Header prepended to each block, tells which class the block belongs to
+    struct BlockHeader
+    {
+        uint32_t SizeClass;
+        uint32_t Reserved;
+    };
+    // A freed block, linked in the size class' free list
+    struct FreeBlock
+    {
+        FreeBlock *Next;
+    };
+    struct SizeClass
+    {
+        FreeBlock *FreeList = nullptr;
+        // Unused remainder of the last allocated slab
+        uint8_t *SlabPos = nullptr;
+        uint8_t *SlabEnd = nullptr;
+        uint64_t Allocs = 0u;
+        uint64_t InUse = 0u;
+    };
+
+    // Gets the size class index for the block of the given size (incl. header)
+    static uint32_t GetSizeClass(size_t block_size);
+    // Gets the block size of the given size class
+    static size_t GetClassBlockSize(uint32_t size_class);
+    // Allocates a new block of the given class
+    uint8_t *AllocateBlock(uint32_t size_class);
+
+    SizeClass _classes[SizeClassCount];
+    std::vector<std::unique_ptr<uint8_t[]>> _slabs;
+    Stats _stats;
+};
+
+// Deleter for the smart pointers holding the managed buffers
+struct ManagedBufferDeleter
+{
+    void operator()(uint8_t *buf) const;
+};
+
+extern ManagedBufferPool bufferPool;
+
+#endif // __CC_MANAGEDBUFFERPOOL_H
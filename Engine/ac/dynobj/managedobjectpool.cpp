@@ -15,6 +15,7 @@
 #include <vector>
 #include <string.h>
 #include "ac/dynobj/managedobjectpool.h"
+#include "ac/dynobj/managedbufferpool.h"
 #include "debug/out.h"
 #include "util/string_utils.h"               // fputstring, etc
 #include "script/cc_common.h"
@@ -293,6 +294,8 @@ void ManagedObjectPool::Reset()
         Remove(o, true);
     }
     objects.Clear();
+    // All the script objects are gone now, so release their memory too
+    bufferPool.Trim();
 
     PrintStats();
 }
@@ -313,6 +316,7 @@ void ManagedObjectPool::PrintStats()
         stats.RemovedGC,
         stats.GCTimesRun
     );
+    bufferPool.PrintStats();
 }
 
 void ManagedObjectPool::TraverseManagedObjects(const String &type, PfnProcessObject proc)
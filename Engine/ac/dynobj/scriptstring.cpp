@@ -30,7 +30,7 @@ const char *ScriptString::GetType()
 
 int ScriptString::Dispose(void *address, bool /*force*/)
 {
-    delete[] (static_cast<uint8_t*>(address) - MemHeaderSz);
+    bufferPool.Free(static_cast<uint8_t*>(address) - MemHeaderSz);
     return 1;
 }
 
@@ -50,7 +50,7 @@ void ScriptString::Serialize(const void* address, Stream *out)
 void ScriptString::Unserialize(int index, Stream *in, size_t /*data_sz*/)
 {
     size_t len = in->ReadInt32();
-    uint8_t *buf = new uint8_t[len + 1 + MemHeaderSz];
+    uint8_t *buf = bufferPool.Allocate(len + 1 + MemHeaderSz);
     char *text_ptr = reinterpret_cast<char*>(buf + MemHeaderSz);
     in->Read(text_ptr, len + 1); // it was writing trailing 0 for some reason
     text_ptr[len] = 0; // for safety
@@ -68,7 +68,7 @@ DynObjectRef ScriptString::CreateObject(uint8_t *buf)
     int32_t handle = ccRegisterManagedObject(text_ptr, &myScriptStringImpl);
     if (handle == 0)
     {
-        delete[] buf;
+        bufferPool.Free(buf);
         return DynObjectRef();
     }
     return DynObjectRef(handle, text_ptr, &myScriptStringImpl);
@@ -77,7 +77,7 @@ DynObjectRef ScriptString::CreateObject(uint8_t *buf)
 ScriptString::Buffer ScriptString::CreateBuffer(size_t len, size_t ulen)
 {
     assert(ulen <= len);
-    std::unique_ptr<uint8_t[]> buf(new uint8_t[len + 1 + MemHeaderSz]);
+    std::unique_ptr<uint8_t[], ManagedBufferDeleter> buf(bufferPool.Allocate(len + 1 + MemHeaderSz));
     auto *header = reinterpret_cast<Header*>(buf.get());
     header->Length = len;
     header->ULength = ulen;
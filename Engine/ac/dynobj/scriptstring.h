@@ -16,6 +16,7 @@
 
 #include <memory>
 #include "ac/dynobj/cc_agsdynamicobject.h"
+#include "ac/dynobj/managedbufferpool.h"
 
 struct ScriptString final : AGSCCDynamicObject
 {
@@ -39,16 +40,17 @@ public:
         Buffer() = default;
         ~Buffer() = default;
         Buffer(Buffer &&buf) = default;
+        Buffer &operator=(Buffer &&buf) = default;
         // Returns a pointer to the beginning of a text buffer
         char *Get() { return reinterpret_cast<char*>(_buf.get() + MemHeaderSz); }
         // Returns size allocated for a text content (includes null pointer)
         size_t GetSize() const { return _sz - MemHeaderSz; }
 
     private:
-        Buffer(std::unique_ptr<uint8_t[]> &&buf, size_t buf_sz)
+        Buffer(std::unique_ptr<uint8_t[], ManagedBufferDeleter> &&buf, size_t buf_sz)
             : _buf(std::move(buf)), _sz(buf_sz) {}
 
-        std::unique_ptr<uint8_t[]> _buf;
+        std::unique_ptr<uint8_t[], ManagedBufferDeleter> _buf;
         size_t _sz;
     };
 
@@ -0,0 +1,77 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2026 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+#include "ac/dynobj/scriptstringbuilder.h"
+#include <allegro.h>
+#include "ac/dynobj/dynobj_manager.h"
+#include "util/stream.h"
+
+using namespace AGS::Common;
+
+ScriptStringBuilder::ScriptStringBuilder(size_t capacity)
+{
+    _text.reserve(capacity);
+}
+
+int ScriptStringBuilder::Dispose(void* /*address*/, bool /*force*/)
+{
+    delete this;
+    return 1;
+}
+
+const char *ScriptStringBuilder::GetType()
+{
+    return "StringBuilder";
+}
+
+void ScriptStringBuilder::Append(const char *text, size_t len, size_t ulen)
+{
+    _text.append(text, len);
+    _ulen += ulen;
+}
+
+void ScriptStringBuilder::Insert(size_t at_char, const char *text, size_t len, size_t ulen)
+{
+    const size_t off = (at_char >= _ulen) ? _text.size() :
+        static_cast<size_t>(uoffset(_text.c_str(), static_cast<int>(at_char)));
+    _text.insert(off, text, len);
+    _ulen += ulen;
+}
+
+void ScriptStringBuilder::Clear()
+{
+    _text.clear();
+    _ulen = 0u;
+}
+
+size_t ScriptStringBuilder::CalcSerializeSize(const void* /*address*/)
+{
+    return sizeof(int32_t) * 2 + _text.size();
+}
+
+void ScriptStringBuilder::Serialize(const void* /*address*/, Stream *out)
+{
+    out->WriteInt32(static_cast<int32_t>(_text.size()));
+    out->WriteInt32(static_cast<int32_t>(_ulen));
+    out->Write(_text.c_str(), _text.size());
+}
+
+void ScriptStringBuilder::Unserialize(int index, Stream *in, size_t /*data_sz*/)
+{
+    const size_t len = static_cast<uint32_t>(in->ReadInt32());
+    _ulen = static_cast<uint32_t>(in->ReadInt32());
+    _text.resize(len);
+    if (len > 0)
+        in->Read(&_text[0], len);
+    ccRegisterUnserializedObject(index, this, this);
+}
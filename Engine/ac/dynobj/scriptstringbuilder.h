@@ -0,0 +1,62 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2026 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+//
+// ScriptStringBuilder is a script object that accumulates text in a growable
+// buffer. Unlike String.Append, which creates a new string each time,
+// appending to a StringBuilder only copies the new text, and the buffer is
+// reallocated with a geometric growth, making a series of appends linear.
+//
+//=============================================================================
+#ifndef __AGS_EE_DYNOBJ__SCRIPTSTRINGBUILDER_H
+#define __AGS_EE_DYNOBJ__SCRIPTSTRINGBUILDER_H
+
+#include <string>
+#include "ac/dynobj/cc_agsdynamicobject.h"
+
+struct ScriptStringBuilder final : AGSCCDynamicObject
+{
+public:
+    ScriptStringBuilder() = default;
+    // Constructs StringBuilder with the given reserved capacity, in bytes
+    ScriptStringBuilder(size_t capacity);
+
+    int Dispose(void *address, bool force) override;
+    const char *GetType() override;
+    void Unserialize(int index, AGS::Common::Stream *in, size_t data_sz) override;
+
+    // Gets the accumulated text
+    inline const char *GetCStr() const { return _text.c_str(); }
+    // Gets the text length in bytes
+    inline size_t GetLength() const { return _text.size(); }
+    // Gets the text length in characters
+    inline size_t GetULength() const { return _ulen; }
+
+    // Appends a text of the given length in bytes and characters
+    void Append(const char *text, size_t len, size_t ulen);
+    // Inserts a text of the given length at the character index
+    void Insert(size_t at_char, const char *text, size_t len, size_t ulen);
+    // Removes all the text, but keeps the allocated buffer
+    void Clear();
+
+private:
+    std::string _text;
+    size_t _ulen = 0u;
+
+    // Calculate and return required space for serialization, in bytes
+    size_t CalcSerializeSize(const void *address) override;
+    // Write object data into the provided stream
+    void Serialize(const void *address, AGS::Common::Stream *out) override;
+};
+
+#endif // __AGS_EE_DYNOBJ__SCRIPTSTRINGBUILDER_H
@@ -14,6 +14,7 @@
 #include <memory.h>
 #include "scriptuserobject.h"
 #include "ac/dynobj/dynobj_manager.h"
+#include "ac/dynobj/managedbufferpool.h"
 #include "util/stream.h"
 
 using namespace AGS::Common;
@@ -28,7 +29,7 @@ const char *ScriptUserObject::GetType()
 
 /* static */ DynObjectRef ScriptUserObject::Create(size_t size)
 {
-    uint8_t *new_data = new uint8_t[size + MemHeaderSz];
+    uint8_t *new_data = bufferPool.Allocate(size + MemHeaderSz);
     memset(new_data, 0, size + MemHeaderSz);
     Header &hdr = reinterpret_cast<Header&>(*new_data);
     hdr.Size = size;
@@ -36,7 +37,7 @@ const char *ScriptUserObject::GetType()
     int32_t handle = ccRegisterManagedObject(obj_ptr, &globalDynamicStruct);
     if (handle == 0)
     {
-        delete[] new_data;
+        bufferPool.Free(new_data);
         return DynObjectRef();
     }
     return DynObjectRef(handle, obj_ptr, &globalDynamicStruct);
@@ -44,7 +45,7 @@ const char *ScriptUserObject::GetType()
 
 int ScriptUserObject::Dispose(void *address, bool /*force*/)
 {
-    delete[] (static_cast<uint8_t*>(address) - MemHeaderSz);
+    bufferPool.Free(static_cast<uint8_t*>(address) - MemHeaderSz);
     return 1;
 }
 
@@ -63,7 +64,7 @@ void ScriptUserObject::Serialize(const void *address, AGS::Common::Stream *out)
 
 void ScriptUserObject::Unserialize(int index, Stream *in, size_t data_sz)
 {
-    uint8_t *new_data = new uint8_t[(data_sz - FileHeaderSz) + MemHeaderSz];
+    uint8_t *new_data = bufferPool.Allocate((data_sz - FileHeaderSz) + MemHeaderSz);
     Header &hdr = reinterpret_cast<Header&>(*new_data);
     hdr.Size = data_sz - FileHeaderSz;
     in->Read(new_data + MemHeaderSz, data_sz - FileHeaderSz);
@@ -122,7 +122,7 @@ enum AGSScriptEventType
     kScriptEvent_GameRestored   = 9, // a game save was restored successfully
     kScriptEvent_RoomAfterFadein = 10, // enter after fade-in
     kScriptEvent_RoomAfterFadeout = 11, // after fade-out, right before unloading
-    kScriptEvent_GameSaved      = 12, // reports game save result
+    kScriptEvent_GameSaved      = 12, // reports game save result: slot, error code (0 on success)
     kScriptEvent_DialogStart    = 13, // before game enters a "dialog" state
     kScriptEvent_DialogStop     = 14, // after game returns from a "dialog" state
     kScriptEvent_DialogRun      = 15, // a dialog option is run
@@ -272,32 +272,9 @@ void File_WriteRawLine(sc_File *fil, const char *towrite) {
   FileWriteRawLine(fil->handle, towrite);
 }
 
-// Reads line of chars until linebreak is met or buffer is filled;
-// returns whether reached the end of line (false in case not enough buffer);
-// guarantees null-terminator in the buffer.
 static bool File_ReadRawLineImpl(sc_File *fil, char* buffer, size_t buf_len) {
-    if (buf_len == 0) return false;
     Stream *in = get_file_stream(fil->handle, "File.ReadRawLine");
-    for (size_t i = 0; i < buf_len - 1; ++i)
-    {
-        int c = in->ReadByte();
-        if (c < 0 || c == '\n') // EOF or LF
-        {
-            buffer[i] = 0;
-            return true;
-        }
-        if (c == '\r') // CR or CRLF
-        {
-            c = in->ReadByte();
-            // Look for '\n', but it may be missing, which is also a valid case
-            if (c >= 0 && c != '\n') in->Seek(-1, kSeekCurrent);
-            buffer[i] = 0;
-            return true;
-        }
-        buffer[i] = c;
-    }
-    buffer[buf_len - 1] = 0;
-    return false; // not enough buffer
+    return ReadRawLine(in, buffer, buf_len);
 }
 
 void File_ReadRawLine(sc_File *fil, char* buffer) {
@@ -343,6 +320,60 @@ const char* File_ReadStringBack(sc_File *fil) {
   return CreateNewScriptString(std::move(buf));
 }
 
+// Opens the file and reads all of its contents into the new string buffer
+static bool File_ReadAllImpl(const char *fnmm, const char *api_name, ScriptString::Buffer &buf)
+{
+    std::unique_ptr<Stream> in(ResolveScriptPathAndOpen(fnmm, kFile_Open, kStream_Read));
+    if (!in)
+        return false;
+    const soff_t data_sz = in->GetLength() - in->GetPosition();
+    if (data_sz < 0 || static_cast<uint64_t>(data_sz) > INT32_MAX)
+    {
+        debug_script_warn("%s: file is too large: %s", api_name, fnmm);
+        return false;
+    }
+    buf = ScriptString::CreateBuffer(static_cast<size_t>(data_sz));
+    const size_t read_sz = in->Read(buf.Get(), static_cast<size_t>(data_sz));
+    buf.Get()[read_sz] = 0;
+    return true;
+}
+
+const char *File_ReadAllText(const char *fnmm)
+{
+    ScriptString::Buffer buf;
+    if (!File_ReadAllImpl(fnmm, "File.ReadAllText", buf))
+        return nullptr;
+    return CreateNewScriptString(std::move(buf));
+}
+
+void *File_ReadLines(const char *fnmm)
+{
+    ScriptString::Buffer buf;
+    if (!File_ReadAllImpl(fnmm, "File.ReadLines", buf))
+        return nullptr;
+    // Split the text by the linebreaks (LF, CR or CRLF) in place;
+    // the linebreak after the last line does not make an extra empty line
+    std::vector<const char*> lines;
+    char *text = buf.Get();
+    const size_t text_len = strlen(text);
+    char *line = text;
+    for (char *ptr = text, *end = text + text_len; ptr < end; ++ptr)
+    {
+        if (*ptr != '\n' && *ptr != '\r')
+            continue;
+        if ((*ptr == '\r') && (ptr + 1 < end) && (*(ptr + 1) == '\n'))
+            *(ptr++) = 0;
+        *ptr = 0;
+        lines.push_back(line);
+        line = ptr + 1;
+    }
+    if (line < text + text_len)
+        lines.push_back(line);
+
+    DynObjectRef arr = DynamicArrayHelpers::CreateStringArray(lines);
+    return arr.Obj();
+}
+
 int File_ReadInt(sc_File *fil) {
   return FileReadInt(fil->handle);
 }
@@ -1041,6 +1072,16 @@ RuntimeScriptValue Sc_sc_OpenFile(const RuntimeScriptValue *params, int32_t para
     API_SCALL_OBJAUTO_POBJ_PINT(sc_File, sc_OpenFile, const char);
 }
 
+RuntimeScriptValue Sc_File_ReadAllText(const RuntimeScriptValue *params, int32_t param_count)
+{
+    API_SCALL_OBJ_POBJ(const char, myScriptStringImpl, File_ReadAllText, const char);
+}
+
+RuntimeScriptValue Sc_File_ReadLines(const RuntimeScriptValue *params, int32_t param_count)
+{
+    API_SCALL_OBJ_POBJ(void, globalDynamicArray, File_ReadLines, const char);
+}
+
 RuntimeScriptValue Sc_File_ResolvePath(const RuntimeScriptValue *params, int32_t param_count)
 {
     API_SCALL_OBJ_POBJ(const char, myScriptStringImpl, File_ResolvePath, const char);
@@ -1192,6 +1233,8 @@ void RegisterFileAPI()
         { "File::Rename^2",           API_FN_PAIR(File_Rename) },
         { "File::Open^2",             API_FN_PAIR(sc_OpenFile) },
         { "File::ResolvePath^1",      API_FN_PAIR(File_ResolvePath) },
+        { "File::ReadAllText^1",      API_FN_PAIR(File_ReadAllText) },
+        { "File::ReadLines^1",        API_FN_PAIR(File_ReadLines) },
 
         { "File::Close^0",            API_FN_PAIR(File_Close) },
         { "File::ReadInt^0",          API_FN_PAIR(File_ReadInt) },
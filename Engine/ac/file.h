@@ -29,6 +29,8 @@ int		File_Exists(const char *fnmm);
 int		File_Delete(const char *fnmm);
 void	*sc_OpenFile(const char *fnmm, int mode);
 const char *File_ResolvePath(const char *fnmm);
+const char *File_ReadAllText(const char *fnmm);
+void	*File_ReadLines(const char *fnmm);
 void	File_Close(sc_File *fil);
 void	File_WriteString(sc_File *fil, const char *towrite);
 void	File_WriteInt(sc_File *fil, int towrite);
@@ -72,6 +72,7 @@
 #include "platform/base/agsplatformdriver.h"
 #include "platform/base/sys_main.h"
 #include "plugin/plugin_engine.h"
+#include "script/cc_instance.h"
 #include "script/script.h"
 #include "script/script_runtime.h"
 #include "util/directory.h"
@@ -605,6 +606,7 @@ void unload_game()
     resetRoomStatuses();
 
     dispose_room_pathfinder();
+    dispose_room_preloads();
 
     // Free game state and game struct
     play = GamePlayState();
@@ -1221,6 +1223,17 @@ void Game_PrecacheView(int view, int first_loop, int last_loop)
     precache_view(view - 1 /* to 0-based view index */, first_loop, last_loop, true);
 }
 
+void Game_SetRepExecInterval(int interval)
+{
+    if (interval < 1)
+    {
+        debug_script_warn("Game.SetRepExecInterval: invalid interval %d, must be 1 or higher", interval);
+        interval = 1;
+    }
+    if (!SetScriptRepExecInterval(ccInstance::GetCurrentInstance(), interval))
+        debug_script_warn("Game.SetRepExecInterval: only supported in the script modules and global script");
+}
+
 void *Game_GetSaveSlots(int min_slot, int max_slot, int save_sort, int sort_dir)
 {
     if (!ValidateSaveSlotRange("Game.GetSaveSlots", min_slot, max_slot))
@@ -1299,29 +1312,76 @@ static std::unique_ptr<Common::Bitmap> create_savegame_screenshot()
     return create_game_screenshot(play.screenshot_width, play.screenshot_height, game.options[OPT_SAVESCREENSHOTLAYER]);
 }
 
+// Slot of the save written in background
+static int background_save_slot = -1;
+
+// Reports the save result to script with the "After Save" event,
+// passing the slot number, and a error code, which is 0 on success
+static void report_save_result(int slotn, const HSaveError &err, bool was_background)
+{
+    if (!err)
+    {
+        Debug::Printf(kDbgMsg_Error, "Failed to save game to slot %d: %s", slotn, err->FullMessage().GetCStr());
+        // Games made before the "After Save" event have no other way to learn of
+        // the failure, so keep displaying the message to them, unless saved in background
+        if (!was_background && (game.options[OPT_BASESCRIPTAPI] < kScriptAPI_v361))
+            Display("ERROR: Unable to save the game!\n%s", err->FullMessage().GetCStr());
+    }
+    run_on_event(kScriptEvent_GameSaved, slotn, err ? 0 : err->Code());
+}
+
 void save_game(int slotn, const String &descript, std::unique_ptr<Bitmap> &&image)
 {
+    // Complete previous background save, if there's any
+    update_background_save(true);
+
     pl_run_plugin_hooks(kPluginEvt_PreSaveGame, 0);
 
     String nametouse = get_save_game_path(slotn);
     if (!image && (game.options[OPT_SAVESCREENSHOT] != 0))
         image = create_savegame_screenshot();
 
-    HSaveError err = SaveGame(nametouse, descript, image.get(),
-             (SaveCmpSelection)(kSaveCmp_All & ~(game.options[OPT_SAVECOMPONENTSIGNORE] & kSaveCmp_ScriptIgnoreMask)),
-             usetup.CompressSaves);
-    if (!err)
+    const SaveCmpSelection select_cmp =
+        (SaveCmpSelection)(kSaveCmp_All & ~(game.options[OPT_SAVECOMPONENTSIGNORE] & kSaveCmp_ScriptIgnoreMask));
+    HSaveError err;
+    if (usetup.DeltaSaves)
     {
-        // FIXME: left this original Display call for the time being,
-        // but this is wrong. Figure out how to use event callback for this instead:
-        // either pass error code to kScriptEvent_GameSaved, or have a separate event for errors
-        Display("ERROR: Unable to open savegame file for writing!");
-        Debug::Printf(kDbgMsg_Error, "Save game failed: %s", err->FullMessage().GetCStr());
+        err = SaveGameDelta(nametouse, descript, image.get(), select_cmp, usetup.CompressSaves, usetup.BackgroundSaves);
+    }
+    else
+    {
+        // A full save replaces any previous delta save; its base file
+        // is removed only after the new save was written successfully
+        ForgetDeltaSave(nametouse);
+        if (usetup.BackgroundSaves)
+            err = SaveGameInBackground(nametouse, descript, image.get(), select_cmp, usetup.CompressSaves);
+        else
+            err = SaveGame(nametouse, descript, image.get(), select_cmp, usetup.CompressSaves);
+    }
+    // If the save is written in background, then "After Save" will be called when it's done
+    if (err && usetup.BackgroundSaves)
+    {
+        background_save_slot = slotn;
         return;
     }
 
     // call "After Save" event callback
-    run_on_event(kScriptEvent_GameSaved, slotn);
+    report_save_result(slotn, err, false);
+}
+
+void update_background_save(bool wait)
+{
+    if (!IsSavingInBackground())
+        return;
+    if (wait)
+        WaitForBackgroundSave();
+    HSaveError err;
+    if (!PollBackgroundSave(err))
+        return;
+
+    const int slotn = background_save_slot;
+    background_save_slot = -1;
+    report_save_result(slotn, err, true);
 }
 
 int gameHasBeenRestored = 0;
@@ -1478,6 +1538,8 @@ bool try_restore_save(int slot, bool startup)
 bool try_restore_save(const Common::String &path, int slot, bool startup)
 {
     bool data_overwritten;
+    // Make sure that any pending save is written before restoring
+    update_background_save(true);
     Debug::Printf(kDbgMsg_Info, "Restoring saved game '%s'", path.GetCStr());
     HSaveError err = load_game(path, slot, startup, data_overwritten);
     if (!err)
@@ -2531,6 +2593,11 @@ RuntimeScriptValue Sc_Game_PrecacheView(const RuntimeScriptValue *params, int32_
     API_SCALL_VOID_PINT3(Game_PrecacheView);
 }
 
+RuntimeScriptValue Sc_Game_SetRepExecInterval(const RuntimeScriptValue *params, int32_t param_count)
+{
+    API_SCALL_VOID_PINT(Game_SetRepExecInterval);
+}
+
 RuntimeScriptValue Sc_Game_GetSaveSlots(const RuntimeScriptValue *params, int32_t param_count)
 {
     API_SCALL_OBJ_PINT4(void, globalDynamicArray, Game_GetSaveSlots);
@@ -2612,6 +2679,7 @@ void RegisterGameAPI()
         { "Game::PrecacheView",                           API_FN_PAIR(Game_PrecacheView) },
         { "Game::ResetDoOnceOnly",                        API_FN_PAIR(Game_ResetDoOnceOnly) },
         { "Game::Resume",                                 API_FN_PAIR(Game_Resume) },
+        { "Game::SetRepExecInterval",                     API_FN_PAIR(Game_SetRepExecInterval) },
         { "Game::SimulateKeyPress^1",                     API_FN_PAIR(Game_SimulateKeyPressOld) },
         { "Game::SimulateKeyPress^2",                     API_FN_PAIR(Game_SimulateKeyPress) },
         { "Game::GetSaveSlots^4",                         API_FN_PAIR(Game_GetSaveSlots) },
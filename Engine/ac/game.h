@@ -182,6 +182,9 @@ void shutdown_game_state();
 // Free all the memory associated with the game
 void unload_game();
 void save_game(int slotn, const Common::String &descript, std::unique_ptr<Common::Bitmap> &&image = nullptr);
+// Checks if a background save has completed, and runs the "game saved" event,
+// or reports the error to the player if it failed; optionally waits for the save to complete
+void update_background_save(bool wait = false);
 std::unique_ptr<Common::Bitmap> create_game_screenshot(int width, int height, int layers);
 bool read_savedgame_description(const Common::String &filename, Common::String &description);
 std::unique_ptr<Common::Bitmap> read_savedgame_screenshot(const Common::String &filename);
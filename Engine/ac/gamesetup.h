@@ -49,6 +49,16 @@ enum ScreenRotation
     kNumScreenRotationOptions
 };
 
+// Automatic room preloading policy
+enum RoomPreloadPolicy
+{
+    kRoomPreload_Off,   // only preload rooms on script request
+    kRoomPreload_Exits, // preload rooms previously reached from the current one
+    kRoomPreload_Edges, // preload a room previously reached through a room edge,
+                        // when the player comes close to that edge
+    kNumRoomPreloadPolicies
+};
+
 using AGS::Common::String;
 
 // Accessibility options are meant to make playing the game easier, by modifying certain
@@ -91,6 +101,13 @@ struct GameConfig
     static const size_t DefTexCacheSize     = (128 * 1024); // 128 MB
     static const size_t DefSoundLoadAtOnce  = 1024; // 1 MB
     static const size_t DefSoundCache       = 1024u * 32; // 32 MB
+    static const size_t DefSoundPCMCache    = 1024u * 8; // 8 MB
+    static const int    DefSoundPCMMaxMs    = 2000; // 2 seconds
+#if AGS_PLATFORM_OS_ANDROID || AGS_PLATFORM_OS_IOS
+    static const int    DefFrameSpinTime    = 0; // don't busy-wait on battery-powered devices
+#else
+    static const int    DefFrameSpinTime    = 1000; // 1 ms
+#endif
 
     // Display configuration
     DisplayModeSetup Display;
@@ -99,6 +116,9 @@ struct GameConfig
     // Graphic options (additional)
     bool    RenderAtScreenRes    = false; // render sprites at screen resolution, as opposed to native one
     bool    AntialiasSprites     = false;  // apply AA (linear) scaling to game sprites, regardless of final filter
+    int     RenderThreads        = 1; // number of threads for drawing sprites by software renderer, 0 = all hardware threads
+    int     FrameSpinTime        = DefFrameSpinTime; // time to busy-wait before the next frame, in microseconds
+    bool    FrameSkip            = false; // skip rendering frames when the game is running late
 
     // For mobile devices
     ScreenRotation Rotation      = kScreenRotation_Unlocked; // how to display the game on mobile screen
@@ -121,6 +141,8 @@ struct GameConfig
     size_t  TextureCacheSize     = DefTexCacheSize; // in KB
     size_t  SoundCacheSize       = DefSoundCache; // sound cache limit, in KB
     size_t  SoundLoadAtOnceSize  = DefSoundLoadAtOnce; // threshold for loading sounds immediately, in KB
+    size_t  SoundPCMCacheSize    = DefSoundPCMCache; // decoded sound cache limit, in KB
+    int     SoundPCMMaxDuration  = DefSoundPCMMaxMs; // max duration of a sound kept decoded, in ms
 
     // Misc options
     String  Translation;
@@ -134,9 +156,14 @@ struct GameConfig
     // Misc engine options
     bool    LoadLatestSave       = false; // load latest saved game on launch
     bool    CompressSaves        = true;
+    bool    BackgroundSaves      = false; // write save files on a background thread
+    bool    DeltaSaves           = false; // write only changed components against a base save
     bool    ClearCacheOnRoomChange = false; // for low-end devices: clear resource caches on room change
+    RoomPreloadPolicy RoomPreload = kRoomPreload_Off; // automatic room preloading policy
+    int     RoomPreloadCount     = 2; // max number of rooms kept preloaded at once
     bool    RunInBackground      = false; // whether run on background, when game is switched out
     bool    ShowFps              = false;
+    int     ScriptFrameBudget    = 0; // time budget for non-blocking script callbacks per frame, in ms
 
     // Accessibility options
     AccessibilityGameConfig Access;
@@ -84,7 +84,7 @@ String GetRuntimeInfo()
         runtimeInfo.Append("[AUDIO.VOX enabled");
     if (play.voice_avail)
         runtimeInfo.Append("[SPEECH.VOX enabled");
-    if (get_translation_tree().size() > 0) {
+    if (has_translated_lines()) {
         runtimeInfo.Append("[Using translation ");
         runtimeInfo.Append(get_translation_name());
     }
@@ -48,6 +48,7 @@
 #include "debug/debugger.h"
 #include "debug/debug_log.h"
 #include "font/fonts.h"
+#include "game/savegame.h"
 #include "gui/guidialog.h"
 #include "main/engine.h"
 #include "main/game_start.h"
@@ -115,20 +116,35 @@ void CopySaveSlot(int old_save, int new_save)
 {
     if (old_save == new_save)
         return; // cannot copy into itself
+    // Let the pending background save complete before touching its files
+    WaitForBackgroundSave();
 
     String old_filename = get_save_game_path(old_save);
     String new_filename = get_save_game_path(new_save);
     File::CopyFile(old_filename, new_filename, true);
+    // Delta saves are accompanied by their base file
+    ForgetDeltaSave(new_filename);
+    File::DeleteFile(GetDeltaSaveBaseFilename(new_filename));
+    if (File::IsFile(GetDeltaSaveBaseFilename(old_filename)))
+        File::CopyFile(GetDeltaSaveBaseFilename(old_filename), GetDeltaSaveBaseFilename(new_filename), true);
 }
 
 void MoveSaveSlot(int old_save, int new_save)
 {
     if (old_save == new_save)
         return; // cannot move into itself
+    // Let the pending background save complete before touching its files
+    WaitForBackgroundSave();
 
     String old_filename = get_save_game_path(old_save);
     String new_filename = get_save_game_path(new_save);
     File::RenameFile(old_filename, new_filename);
+    // Delta saves are accompanied by their base file
+    ForgetDeltaSave(old_filename);
+    ForgetDeltaSave(new_filename);
+    File::DeleteFile(GetDeltaSaveBaseFilename(new_filename));
+    if (File::IsFile(GetDeltaSaveBaseFilename(old_filename)))
+        File::RenameFile(GetDeltaSaveBaseFilename(old_filename), GetDeltaSaveBaseFilename(new_filename));
 }
 
 void RestoreGameSlot(int slnum)
@@ -179,8 +195,12 @@ void SaveGameSlot2(int slnum, const char *descript)
 
 void DeleteSaveSlot(int slnum)
 {
+    // Let the pending background save complete before touching its files
+    WaitForBackgroundSave();
     String save_filename = get_save_game_path(slnum);
     File::DeleteFile(save_filename);
+    ForgetDeltaSave(save_filename);
+    File::DeleteFile(GetDeltaSaveBaseFilename(save_filename));
 
     // Pre-3.6.2 engine behavior: if the deleted save slot was from within
     // MAXSAVEGAMES range, then move the topmost found save file from the same
@@ -195,6 +215,9 @@ void DeleteSaveSlot(int slnum)
                 if (File::IsFile(top_filename))
                 {
                     File::RenameFile(top_filename, save_filename);
+                    ForgetDeltaSave(top_filename);
+                    if (File::IsFile(GetDeltaSaveBaseFilename(top_filename)))
+                        File::RenameFile(GetDeltaSaveBaseFilename(top_filename), GetDeltaSaveBaseFilename(save_filename));
                     break;
                 }
             }
@@ -30,26 +30,33 @@ const char *get_translation (const char *text) {
     if (text == nullptr)
         quit("!Null string supplied to CheckForTranslations");
 
-    source_text_length = GetTextDisplayLength(text);
     if (text[0] == 0)
+    {
+        source_text_length = 0;
         return ""; // don't try translating an empty line
+    }
 
     // check if a plugin wants to translate it - if so, return that
     const char *pl_result = reinterpret_cast<const char*>(
         pl_run_plugin_hooks(kPluginEvt_TranslateText, reinterpret_cast<intptr_t>(text)));
     if (pl_result)
+    {
+        source_text_length = GetTextDisplayLength(text);
         return pl_result;
+    }
 
-    const auto &transtree = get_translation_tree();
-    const auto it = transtree.find(String::Wrapper(text));
-    if (it != transtree.end())
-        return it->second.GetCStr();
+    // the lookup measures the text, so don't scan it again for the length
+    size_t text_len;
+    const char *tr_text = find_translated_line(text, text_len);
+    source_text_length = GetTextDisplayLength(text, text_len);
+    if (tr_text)
+        return tr_text;
     // return the original text
     return text;
 }
 
 int IsTranslationAvailable () {
-    if (get_translation_tree().size() > 0)
+    if (has_translated_lines())
         return 1;
     return 0;
 }
@@ -111,6 +111,8 @@ void MarkForTranslationUpdate()
     }
     for (auto &list : guilist)
     {
+        // Text direction may change along with translation, so reset all
+        list.InvalidateItemLayouts();
         if (list.IsTranslated())
             list.MarkChanged();
     }
@@ -137,7 +139,10 @@ void MarkForFontUpdate(int font)
     for (auto &list : guilist)
     {
         if (update_all || list.GetFont() == font)
+        {
+            list.InvalidateItemLayouts();
             list.MarkChanged();
+        }
     }
     for (auto &tb : guitext)
     {
@@ -13,6 +13,11 @@
 //=============================================================================
 
 #include <ctype.h> // for toupper
+#include <deque>
+#include <unordered_map>
+#if !defined(AGS_DISABLE_THREADS)
+#include <thread>
+#endif
 
 #include "platform/platform.h"
 #include "util/string_utils.h" //strlwr()
@@ -65,6 +70,7 @@
 #include "script/script.h"
 #include "script/script_runtime.h"
 #include "ac/spritecache.h"
+#include "util/memorystream.h"
 #include "util/stream.h"
 #include "gfx/graphicsdriver.h"
 #include "data/assetmanager.h"
@@ -231,6 +237,11 @@ bool Room_Exists(int room)
     return AssetMgr->DoesAssetExist(room_filename);
 }
 
+bool Room_Preload(int room)
+{
+    return preload_room(room);
+}
+
 ScriptUserObject *Room_NearestWalkableArea(int x, int y)
 {
     if (displayed_room < 0)
@@ -490,6 +501,18 @@ static void update_all_viewcams_with_newroom()
     }
 }
 
+// Reads the compiled room script from the stream, and assigns it to the room
+static HError ReadRoomScript(RoomStruct *room, Stream *in, const String &filename)
+{
+    PScript script(ccScript::CreateFromStream(in));
+    if (!script)
+        return new Error(String::FromFormat(
+            "Failed to load a script module: %s", filename.GetCStr()),
+            cc_get_error().ErrorString);
+    room->CompiledScript = script;
+    return HError::None();
+}
+
 // Looks up for the room script available as a separate asset.
 // This is optional, so no error is raised if one is not found.
 // If found however, it will replace room script if one had been loaded
@@ -499,14 +522,7 @@ HError LoadRoomScript(RoomStruct *room, int newnum)
     String filename = String::FromFormat("room%d.o", newnum);
     auto in = AssetMgr->OpenAsset(filename);
     if (in)
-    {
-        PScript script(ccScript::CreateFromStream(in.get()));
-        if (!script)
-            return new Error(String::FromFormat(
-                "Failed to load a script module: %s", filename.GetCStr()),
-                cc_get_error().ErrorString);
-        room->CompiledScript = script;
-    }
+        return ReadRoomScript(room, in.get(), filename);
     return HError::None();
 }
 
@@ -560,21 +576,86 @@ HError LoadRoom(const String &filename, RoomStruct *room, AssetManager *mgr, boo
     HRoomFileError err = LoadRoom(&room_data, std::move(in), game_is_hires, &sprinfos);
     if (!err)
         return new Error(*err);
-    *room = RoomStruct(room_data);
+    *room = RoomStruct(std::move(room_data));
     return HError::None();
 }
 
-// forchar = playerchar on NewRoom, or NULL if restore saved game
-void load_new_room(int newnum, CharacterInfo *forchar)
+//=============================================================================
+//
+// Room preloading.
+//
+// A room may be parsed and decoded in advance on a worker thread, by a script
+// request or an automatic policy. The resulting room data waits in a standby
+// list, which load_new_room looks up first. Only the work that does not
+// depend on the current game state is done in advance: reading the room file
+// (including decompression of backgrounds and masks) and the room script.
+//
+//=============================================================================
+
+struct RoomPreload
 {
-    debug_script_log("Loading room %d", newnum);
+    int RoomNumber = -1;
+    String Filename;
+    // Input streams are opened on the main thread, as AssetMgr is not thread-safe
+    std::unique_ptr<Stream> RoomIn;
+    std::unique_ptr<Stream> ScriptIn;
+    // A copy of sprite infos, required for fixing up legacy room data
+    std::vector<SpriteInfo> SpriteInfos;
+    bool GameIsHires = false;
+    // Results
+    RoomData Data;
+    std::vector<uint8_t> ScriptData;
+    bool HasScript = false;
+    HError Err;
+#if !defined(AGS_DISABLE_THREADS)
+    std::thread Thread;
+#endif
 
-    String room_filename;
-    done_as_error = false;
-    play.room_changes ++;
-    displayed_room=newnum;
+    RoomPreload() = default;
+    ~RoomPreload() { Wait(); }
 
-    room_filename.Format("room%d.crm", newnum);
+    void Run()
+    {
+        HRoomFileError err = LoadRoom(&Data, std::move(RoomIn), GameIsHires, &SpriteInfos);
+        if (!err)
+        {
+            Err = new Error(*err);
+            return;
+        }
+        if (ScriptIn)
+        {
+            ScriptData.resize(static_cast<size_t>(ScriptIn->GetLength()));
+            ScriptIn->Read(ScriptData.data(), ScriptData.size());
+            ScriptIn.reset();
+            HasScript = true;
+        }
+    }
+
+    void Wait()
+    {
+#if !defined(AGS_DISABLE_THREADS)
+        if (Thread.joinable())
+            Thread.join();
+#endif
+    }
+};
+
+// An exit from one room to another, learnt at runtime
+struct RoomExit
+{
+    int Room = -1;
+    int Edge = -1; // room edge which the player crossed, or -1 if none
+};
+
+// Rooms preloaded or being preloaded, in the order of requests
+static std::deque<std::unique_ptr<RoomPreload>> room_preloads;
+// Exits taken from each room during this game session, most recent first
+static std::unordered_map<int, std::vector<RoomExit>> room_exits;
+
+// Gets the room's file name, accounting for the legacy intro room
+static String get_room_filename(int newnum)
+{
+    String room_filename = String::FromFormat("room%d.crm", newnum);
     if (newnum == 0) {
         // support both room0.crm and intro.crm
         // 2.70: Renamed intro.crm to room0.crm, to stop it causing confusion
@@ -584,11 +665,174 @@ void load_new_room(int newnum, CharacterInfo *forchar)
             room_filename = "intro.crm";
         }
     }
+    return room_filename;
+}
+
+bool preload_room(int room)
+{
+    if (room < 0)
+        return false;
+    for (const auto &preload : room_preloads)
+    {
+        if (preload->RoomNumber == room)
+            return true;
+    }
+
+    const String room_filename = get_room_filename(room);
+    auto room_in = AssetMgr->OpenAsset(room_filename);
+    if (!room_in)
+        return false;
+
+    const size_t max_preloads = usetup.RoomPreloadCount;
+    while (room_preloads.size() >= max_preloads)
+        room_preloads.pop_front(); // waits for the job to finish
+
+    std::unique_ptr<RoomPreload> preload(new RoomPreload());
+    preload->RoomNumber = room;
+    preload->Filename = room_filename;
+    preload->RoomIn = std::move(room_in);
+    preload->ScriptIn = AssetMgr->OpenAsset(String::FromFormat("room%d.o", room));
+    preload->SpriteInfos = game.SpriteInfos;
+    preload->GameIsHires = game.IsLegacyHiRes();
+    debug_script_log("Preloading room %d", room);
+#if !defined(AGS_DISABLE_THREADS)
+    RoomPreload *job = preload.get();
+    preload->Thread = std::thread([job]() { job->Run(); });
+#else
+    preload->Run();
+#endif
+    room_preloads.push_back(std::move(preload));
+    return true;
+}
+
+// Takes out the preloaded room matching the filename, waiting for it
+// to complete if necessary; returns null if there's none, or it has failed.
+static std::unique_ptr<RoomPreload> take_preloaded_room(const String &room_filename)
+{
+    for (auto it = room_preloads.begin(); it != room_preloads.end(); ++it)
+    {
+        if ((*it)->Filename != room_filename)
+            continue;
+        std::unique_ptr<RoomPreload> preload = std::move(*it);
+        room_preloads.erase(it);
+        preload->Wait();
+        if (!preload->Err)
+        {
+            Debug::Printf(kDbgMsg_Warn, "WARNING: failed to preload room '%s', will retry loading now. Error: %s",
+                room_filename.GetCStr(), preload->Err->FullMessage().GetCStr());
+            return nullptr;
+        }
+        return preload;
+    }
+    return nullptr;
+}
 
-    // load the room from disk
+static HError adopt_preloaded_room(RoomPreload &preload, RoomStruct *room)
+{
+    *room = RoomStruct(std::move(preload.Data));
+    return HError::None();
+}
+
+static HError adopt_preloaded_room_script(RoomPreload &preload, RoomStruct *room)
+{
+    if (!preload.HasScript)
+        return HError::None();
+    Stream in(std::make_unique<VectorStream>(preload.ScriptData));
+    return ReadRoomScript(room, &in, String::FromFormat("room%d.o", preload.RoomNumber));
+}
+
+void dispose_room_preloads()
+{
+    room_preloads.clear(); // waits for the jobs to finish
+    room_exits.clear();
+}
+
+// Returns the room edge which the player character is beyond, or -1 if none
+static int get_player_edge()
+{
+    if (playerchar->x <= thisroom.Edges.Left)
+        return kRoomEvent_EdgeLeft;
+    if (playerchar->x >= thisroom.Edges.Right)
+        return kRoomEvent_EdgeRight;
+    if (playerchar->y >= thisroom.Edges.Bottom)
+        return kRoomEvent_EdgeBottom;
+    if (playerchar->y <= thisroom.Edges.Top)
+        return kRoomEvent_EdgeTop;
+    return -1;
+}
+
+// Remembers a room change for the automatic preloading
+static void record_room_exit(int from_room, int to_room)
+{
+    if (usetup.RoomPreload == kRoomPreload_Off || from_room < 0 || from_room == to_room)
+        return;
+    auto &exits = room_exits[from_room];
+    RoomExit exit;
+    exit.Room = to_room;
+    exit.Edge = get_player_edge();
+    exits.erase(std::remove_if(exits.begin(), exits.end(),
+        [to_room](const RoomExit &e) { return e.Room == to_room; }), exits.end());
+    exits.insert(exits.begin(), exit);
+}
+
+// Preloads known exits of the newly entered room, as allowed by the policy
+static void preload_room_exits()
+{
+    if (usetup.RoomPreload != kRoomPreload_Exits)
+        return;
+    auto it = room_exits.find(displayed_room);
+    if (it == room_exits.end())
+        return;
+    const size_t max_preloads = usetup.RoomPreloadCount;
+    for (size_t i = 0; i < it->second.size() && i < max_preloads; ++i)
+        preload_room(it->second[i].Room);
+}
+
+void update_room_preload()
+{
+    if (usetup.RoomPreload != kRoomPreload_Edges || displayed_room < 0)
+        return;
+    auto it = room_exits.find(displayed_room);
+    if (it == room_exits.end())
+        return;
+    // Begin preloading when the player comes close enough to an edge,
+    // which led to another room before
+    const int margin_x = thisroom.Width / 8;
+    const int margin_y = thisroom.Height / 8;
+    for (const auto &exit : it->second)
+    {
+        bool near_edge = false;
+        switch (exit.Edge)
+        {
+        case kRoomEvent_EdgeLeft: near_edge = playerchar->x <= thisroom.Edges.Left + margin_x; break;
+        case kRoomEvent_EdgeRight: near_edge = playerchar->x >= thisroom.Edges.Right - margin_x; break;
+        case kRoomEvent_EdgeBottom: near_edge = playerchar->y >= thisroom.Edges.Bottom - margin_y; break;
+        case kRoomEvent_EdgeTop: near_edge = playerchar->y <= thisroom.Edges.Top + margin_y; break;
+        default: break;
+        }
+        if (near_edge)
+            preload_room(exit.Room);
+    }
+}
+
+// forchar = playerchar on NewRoom, or NULL if restore saved game
+void load_new_room(int newnum, CharacterInfo *forchar)
+{
+    debug_script_log("Loading room %d", newnum);
+
+    done_as_error = false;
+    play.room_changes ++;
+    displayed_room=newnum;
+
+    const String room_filename = get_room_filename(newnum);
+
+    // load the room from disk, unless it was already preloaded
     set_our_eip(200);
     thisroom.GameID = NO_GAME_ID_IN_ROOM_FILE;
-    HError err = LoadRoom(room_filename, &thisroom, AssetMgr.get(), game.IsLegacyHiRes(), game.SpriteInfos);
+    std::unique_ptr<RoomPreload> preload = take_preloaded_room(room_filename);
+    HError err = preload ?
+        adopt_preloaded_room(*preload, &thisroom) :
+        LoadRoom(room_filename, &thisroom, AssetMgr.get(), game.IsLegacyHiRes(), game.SpriteInfos);
     if (!err)
     {
         quitprintf("Unable to load the room file '%s'. Error: %s", room_filename.GetCStr(), err->FullMessage().GetCStr());
@@ -600,7 +844,10 @@ void load_new_room(int newnum, CharacterInfo *forchar)
         quitprintf("!Unable to load '%s'. This room file is assigned to a different game.", room_filename.GetCStr());
     }
 
-    err = LoadRoomScript(&thisroom, newnum);
+    err = preload ?
+        adopt_preloaded_room_script(*preload, &thisroom) :
+        LoadRoomScript(&thisroom, newnum);
+    preload.reset();
     if (!err)
     {
         quitprintf("!Unable to load script from '%s'. Error: %s", room_filename.GetCStr(),
@@ -1011,6 +1258,7 @@ void load_new_room(int newnum, CharacterInfo *forchar)
     cursor_gstate.MarkChanged();
     GUIE::MarkAllGUIForUpdate(true, true);
     pl_run_plugin_hooks(kPluginEvt_EnterRoom, displayed_room);
+    preload_room_exits();
 }
 
 // new_room: changes the current room number, and loads the new room from disk
@@ -1032,6 +1280,7 @@ void new_room(int newnum,CharacterInfo*forchar) {
     // update the new room number if it has been altered by OnLeave scripts
     newnum = in_leaves_screen;
     in_leaves_screen = -1;
+    record_room_exit(displayed_room, newnum);
 
     CharacterExtras *player_ex = &charextra[playerchar->index_id];
     if ((player_ex->following >= 0) &&
@@ -1128,9 +1377,7 @@ void compile_room_script() {
     if (roominstFork == nullptr)
         quitprintf("Unable to create forked room instance:\n%s", cc_get_error().ErrorString.GetCStr());
 
-    repExecAlways.RoomHasFunction = true;
-    lateRepExecAlways.RoomHasFunction = true;
-    getDialogOptionsDimensionsFunc.RoomHasFunction = true;
+    FindNonBlockingFunctionsInRoom();
 }
 
 int bg_just_changed = 0;
@@ -1443,6 +1690,11 @@ RuntimeScriptValue Sc_Room_Exists(const RuntimeScriptValue *params, int32_t para
     API_SCALL_BOOL_PINT(Room_Exists);
 }
 
+RuntimeScriptValue Sc_Room_Preload(const RuntimeScriptValue *params, int32_t param_count)
+{
+    API_SCALL_BOOL_PINT(Room_Preload);
+}
+
 RuntimeScriptValue Sc_Room_NearestWalkableArea(const RuntimeScriptValue *params, int32_t param_count)
 {
     API_SCALL_OBJAUTO_PINT2(ScriptUserObject, Room_NearestWalkableArea);
@@ -1456,6 +1708,7 @@ void RegisterRoomAPI()
         { "Room::GetProperty^1",                      API_FN_PAIR(Room_GetProperty) },
         { "Room::GetTextProperty^1",                  API_FN_PAIR(Room_GetTextProperty) },
         { "Room::NearestWalkableArea^2",              API_FN_PAIR(Room_NearestWalkableArea) },
+        { "Room::Preload^1",                          API_FN_PAIR(Room_Preload) },
         { "Room::SetProperty^2",                      API_FN_PAIR(Room_SetProperty) },
         { "Room::SetTextProperty^2",                  API_FN_PAIR(Room_SetTextProperty) },
         { "Room::ProcessClick^3",                     API_FN_PAIR(RoomProcessClick) },
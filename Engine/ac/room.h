@@ -74,6 +74,13 @@ void  detach_room_bg_surfaces();
 void  on_room_bg_surface_release(int bgindex, bool modified);
 // Notifies room that its mask's drawing surface was released
 void  on_room_mask_surface_release(RoomAreaMask mask, bool modified);
+// Starts loading the given room's data in background, so that a later room
+// change does not have to; returns false if there's no such room
+bool  preload_room(int room);
+// Runs the automatic preloading policy, should be called on each game update
+void  update_room_preload();
+// Waits for all the room preloads to complete and disposes them
+void  dispose_room_preloads();
 void  init_room_pathfinder();
 void  dispose_room_pathfinder();
 // Gets current room's pathfinder object
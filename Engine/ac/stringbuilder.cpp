@@ -0,0 +1,133 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2026 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+#include <algorithm>
+#include <string.h>
+#include <allegro.h>
+#include "ac/stringbuilder.h"
+#include "ac/common.h"
+#include "ac/string.h"
+#include "ac/dynobj/dynobj_manager.h"
+#include "ac/dynobj/scriptstring.h"
+
+ScriptStringBuilder *StringBuilder_Create(int capacity) {
+    ScriptStringBuilder *sb = new ScriptStringBuilder(static_cast<size_t>(std::max(0, capacity)));
+    ccRegisterManagedObject(sb, sb);
+    return sb;
+}
+
+void StringBuilder_Append(ScriptStringBuilder *sb, const char *text) {
+    if (!text)
+        return;
+    int len, ulen;
+    ustrlen2(text, &len, &ulen);
+    sb->Append(text, len, ulen);
+}
+
+void StringBuilder_AppendChar(ScriptStringBuilder *sb, int chr) {
+    char buf[5]{};
+    size_t chw = usetc(buf, chr);
+    sb->Append(buf, chw, 1);
+}
+
+void StringBuilder_Insert(ScriptStringBuilder *sb, int index, const char *text) {
+    if ((index < 0) || (static_cast<size_t>(index) > sb->GetULength()))
+        quit("!StringBuilder.Insert: index outside range of string");
+    if (!text)
+        return;
+    int len, ulen;
+    ustrlen2(text, &len, &ulen);
+    sb->Insert(index, text, len, ulen);
+}
+
+void StringBuilder_Clear(ScriptStringBuilder *sb) {
+    sb->Clear();
+}
+
+const char *StringBuilder_ToString(ScriptStringBuilder *sb) {
+    auto buf = ScriptString::CreateBuffer(sb->GetLength(), sb->GetULength());
+    memcpy(buf.Get(), sb->GetCStr(), sb->GetLength() + 1);
+    return CreateNewScriptString(std::move(buf));
+}
+
+int StringBuilder_GetLength(ScriptStringBuilder *sb) {
+    return static_cast<int>(sb->GetULength());
+}
+
+//=============================================================================
+//
+// Script API Functions
+//
+//=============================================================================
+
+#include "debug/out.h"
+#include "script/script_api.h"
+#include "script/script_runtime.h"
+
+// ScriptStringBuilder* (int capacity)
+RuntimeScriptValue Sc_StringBuilder_Create(const RuntimeScriptValue *params, int32_t param_count)
+{
+    API_SCALL_OBJAUTO_PINT(ScriptStringBuilder, StringBuilder_Create);
+}
+
+// void (ScriptStringBuilder *sb, const char *text)
+RuntimeScriptValue Sc_StringBuilder_Append(void *self, const RuntimeScriptValue *params, int32_t param_count)
+{
+    API_OBJCALL_VOID_POBJ(ScriptStringBuilder, StringBuilder_Append, const char);
+}
+
+// void (ScriptStringBuilder *sb, int chr)
+RuntimeScriptValue Sc_StringBuilder_AppendChar(void *self, const RuntimeScriptValue *params, int32_t param_count)
+{
+    API_OBJCALL_VOID_PINT(ScriptStringBuilder, StringBuilder_AppendChar);
+}
+
+// void (ScriptStringBuilder *sb, int index, const char *text)
+RuntimeScriptValue Sc_StringBuilder_Insert(void *self, const RuntimeScriptValue *params, int32_t param_count)
+{
+    API_OBJCALL_VOID_PINT_POBJ(ScriptStringBuilder, StringBuilder_Insert, const char);
+}
+
+// void (ScriptStringBuilder *sb)
+RuntimeScriptValue Sc_StringBuilder_Clear(void *self, const RuntimeScriptValue *params, int32_t param_count)
+{
+    API_OBJCALL_VOID(ScriptStringBuilder, StringBuilder_Clear);
+}
+
+// const char* (ScriptStringBuilder *sb)
+RuntimeScriptValue Sc_StringBuilder_ToString(void *self, const RuntimeScriptValue *params, int32_t param_count)
+{
+    API_OBJCALL_OBJ(ScriptStringBuilder, const char, myScriptStringImpl, StringBuilder_ToString);
+}
+
+// int (ScriptStringBuilder *sb)
+RuntimeScriptValue Sc_StringBuilder_GetLength(void *self, const RuntimeScriptValue *params, int32_t param_count)
+{
+    API_OBJCALL_INT(ScriptStringBuilder, StringBuilder_GetLength);
+}
+
+void RegisterStringBuilderAPI()
+{
+    ScFnRegister stringbuilder_api[] = {
+        { "StringBuilder::Create^1",     API_FN_PAIR(StringBuilder_Create) },
+
+        { "StringBuilder::Append^1",     API_FN_PAIR(StringBuilder_Append) },
+        { "StringBuilder::AppendChar^1", API_FN_PAIR(StringBuilder_AppendChar) },
+        { "StringBuilder::Clear^0",      API_FN_PAIR(StringBuilder_Clear) },
+        { "StringBuilder::Insert^2",     API_FN_PAIR(StringBuilder_Insert) },
+        { "StringBuilder::ToString^0",   API_FN_PAIR(StringBuilder_ToString) },
+        { "StringBuilder::get_Length",   API_FN_PAIR(StringBuilder_GetLength) },
+    };
+
+    ccAddExternalFunctions(stringbuilder_api);
+}
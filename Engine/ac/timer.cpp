@@ -13,8 +13,11 @@
 //=============================================================================
 #include "ac/timer.h"
 #include "platform/platform.h"
+#include <algorithm>
+#include <cmath>
 #include <thread>
 #include "ac/sys_events.h"
+#include "debug/out.h"
 #include "platform/base/agsplatformdriver.h"
 #if defined(AGS_DISABLE_THREADS)
 #include "media/audio/audio_core.h"
@@ -23,6 +26,7 @@
 #include "SDL.h"
 #endif
 
+using namespace AGS::Common;
 using namespace AGS::Engine;
 
 extern volatile bool game_update_suspend;
@@ -39,6 +43,112 @@ auto framerate_maxed = false;
 auto last_tick_time = Clock::now();
 auto next_frame_timestamp = Clock::now();
 
+// Frame pacing options
+auto spin_duration = std::chrono::microseconds(0);
+auto frame_skip = false;
+auto render_due = true;
+auto skipped_in_row = 0;
+
+// Accumulates frame interval statistics
+struct FrameTimeStats
+{
+    uint64_t Count = 0u;
+    double Mean = 0.0;
+    double M2 = 0.0; // sum of squared differences from the mean
+    double Min = 0.0;
+    double Max = 0.0;
+    uint64_t Late = 0u;
+    uint64_t Skipped = 0u;
+
+    void Add(double ms)
+    {
+        // Welford's online algorithm, keeps variance numerically stable
+        Count++;
+        const double delta = ms - Mean;
+        Mean += delta / Count;
+        M2 += delta * (ms - Mean);
+        Min = (Count == 1) ? ms : std::min(Min, ms);
+        Max = (Count == 1) ? ms : std::max(Max, ms);
+    }
+
+    FramePacingStats Get() const
+    {
+        FramePacingStats stats;
+        stats.Frames = Count;
+        stats.MeanMs = static_cast<float>(Mean);
+        stats.JitterMs = (Count > 1) ? static_cast<float>(std::sqrt(M2 / (Count - 1))) : 0.f;
+        stats.MinMs = static_cast<float>(Min);
+        stats.MaxMs = static_cast<float>(Max);
+        stats.LateFrames = Late;
+        stats.SkippedRenders = Skipped;
+        return stats;
+    }
+};
+
+// Number of frames in the "recent" stats measurement period
+const uint64_t RECENT_STATS_FRAMES = 120u;
+
+FrameTimeStats total_stats;
+FrameTimeStats current_stats;
+FrameTimeStats recent_stats; // last complete period
+auto last_frame_start = Clock::time_point();
+
+}
+
+// Records the beginning of a new frame in the statistics
+static void RecordFrameStart(Clock::time_point now, Clock::duration frame_duration)
+{
+    if (last_frame_start != Clock::time_point())
+    {
+        const double ms = ToMillisecondsF(now - last_frame_start);
+        total_stats.Add(ms);
+        current_stats.Add(ms);
+        if ((frame_duration > Clock::duration::zero()) &&
+            (now - last_tick_time > frame_duration / 2))
+        {
+            total_stats.Late++;
+            current_stats.Late++;
+        }
+        if (!render_due)
+        {
+            total_stats.Skipped++;
+            current_stats.Skipped++;
+        }
+        if (current_stats.Count >= RECENT_STATS_FRAMES)
+        {
+            recent_stats = current_stats;
+            current_stats = FrameTimeStats();
+        }
+    }
+    last_frame_start = now;
+}
+
+// Resets the frame interval measurement, e.g. after the timing was
+// intentionally changed or interrupted
+static void ResetFrameMeasure()
+{
+    last_frame_start = Clock::time_point();
+    current_stats = FrameTimeStats();
+    render_due = true;
+    skipped_in_row = 0;
+}
+
+// Waits until the given time, using a system sleep for the most part,
+// and a busy loop for the remaining "spin" time
+static void WaitUntil(Clock::time_point until)
+{
+    auto remaining = until - Clock::now();
+    if (remaining <= Clock::duration::zero())
+        return;
+#if AGS_PLATFORM_OS_EMSCRIPTEN
+    // pass the time as negative in Emscripten Platform Driver
+    platform->Delay(-ToMilliseconds(remaining));
+#else
+    if (remaining > spin_duration)
+        std::this_thread::sleep_for(remaining - spin_duration);
+    while (Clock::now() < until)
+        std::this_thread::yield();
+#endif
 }
 
 std::chrono::microseconds GetFrameDuration()
@@ -60,6 +170,7 @@ int setTimerFps(int new_fps, bool max_fps_mode)
     framerate_maxed = max_fps_mode;
     // Update next frame time
     next_frame_timestamp = last_tick_time + tick_duration;
+    ResetFrameMeasure();
     return old_fps;
 }
 
@@ -82,6 +193,8 @@ void WaitForNextFrame()
     if (frameDuration <= std::chrono::milliseconds::zero()) {
         last_tick_time = next_frame_timestamp;
         next_frame_timestamp = now;
+        render_due = true;
+        RecordFrameStart(now, frameDuration);
 
         // suspend while the game is being switched out
         while (game_update_suspend && (!want_exit) && (!abort_engine)) {
@@ -96,19 +209,24 @@ void WaitForNextFrame()
         next_frame_timestamp = now;
     }
 
-    auto frame_time_remaining = next_frame_timestamp - now;
-    if (frame_time_remaining > std::chrono::milliseconds::zero()) {
-#if AGS_PLATFORM_OS_EMSCRIPTEN
-        // pass the time as negative in Emscripten Platform Driver
-        platform->Delay(-ToMilliseconds(frame_time_remaining));
-#else
-        std::this_thread::sleep_for(frame_time_remaining);
-#endif
-    }
+    WaitUntil(next_frame_timestamp);
 
     last_tick_time = next_frame_timestamp;
     next_frame_timestamp += frameDuration;
 
+    // If we are still late by a whole frame, then let the next frame
+    // skip rendering, but not too many frames in a row
+    const auto frame_start = Clock::now();
+    if (frame_skip && (frame_start >= next_frame_timestamp) &&
+        (skipped_in_row < MAXIMUM_FALL_BEHIND)) {
+        render_due = false;
+        skipped_in_row++;
+    } else {
+        render_due = true;
+        skipped_in_row = 0;
+    }
+    RecordFrameStart(frame_start, frameDuration);
+
     // suspend while the game is being switched out
     while (game_update_suspend && (!want_exit) && (!abort_engine)) {
         sys_evt_process_pending();
@@ -120,4 +238,39 @@ void skipMissedTicks()
 {
     last_tick_time = Clock::now();
     next_frame_timestamp = Clock::now();
+    ResetFrameMeasure();
+}
+
+void setFramePacing(int spin_us, bool skip_frames)
+{
+    spin_duration = std::chrono::microseconds(std::max(0, spin_us));
+    frame_skip = skip_frames;
+    ResetFrameMeasure();
+}
+
+bool isFrameRenderDue()
+{
+    return render_due;
+}
+
+FramePacingStats getFramePacingStats(bool recent)
+{
+    return recent ? recent_stats.Get() : total_stats.Get();
+}
+
+void printFramePacingStats()
+{
+    const FramePacingStats stats = total_stats.Get();
+    if (stats.Frames == 0u)
+        return;
+    Debug::Printf(kDbgMsg_Info,
+        "Frame pacing stats:\n"
+        "\tFrames measured:     %10llu\n"
+        "\tFrame interval, ms:  mean %.3f, jitter (stddev) %.3f, min %.3f, max %.3f\n"
+        "\tLate frames:         %10llu\n"
+        "\tSkipped renders:     %10llu",
+        static_cast<unsigned long long>(stats.Frames),
+        stats.MeanMs, stats.JitterMs, stats.MinMs, stats.MaxMs,
+        static_cast<unsigned long long>(stats.LateFrames),
+        static_cast<unsigned long long>(stats.SkippedRenders));
 }
@@ -18,6 +18,7 @@
 #ifndef __AGS_EE_AC__TIMER_H
 #define __AGS_EE_AC__TIMER_H
 
+#include "platform/types.h"
 #include "util/time_util.h"
 
 // Sleeps for time remaining until the next game frame, updates next frame timestamp
@@ -30,4 +31,32 @@ extern bool isTimerFpsMaxed();
 // If more than N frames, just skip all, start a fresh.
 extern void skipMissedTicks();
 
+// Frame pacing statistics: measured intervals between the game frames
+struct FramePacingStats
+{
+    uint64_t Frames = 0u;   // number of measured frame intervals
+    float MeanMs = 0.f;     // average frame interval
+    float JitterMs = 0.f;   // standard deviation of the frame intervals
+    float MinMs = 0.f;      // shortest frame interval
+    float MaxMs = 0.f;      // longest frame interval
+    uint64_t LateFrames = 0u;   // frames which started later than half a tick past due time
+    uint64_t SkippedRenders = 0u; // frames updated without rendering to catch up
+};
+
+// Configures frame pacing:
+// spin_us is the time before each frame's due time, in microseconds, during
+// which the engine waits in a busy loop rather than sleeping, as the system's
+// sleep is often not precise enough; 0 means only use sleep.
+// frame_skip lets the engine skip rendering when the game is running late,
+// so that the game logic may catch up and keep running at the game speed.
+extern void setFramePacing(int spin_us, bool frame_skip);
+// Tells whether the current game frame should be rendered; this is false if
+// the frame skip is enabled and the game is late by more than a whole frame
+extern bool isFrameRenderDue();
+// Gets frame pacing statistics; "recent" returns the stats for the last
+// completed measurement period, otherwise for the whole time since game start
+extern FramePacingStats getFramePacingStats(bool recent);
+// Prints frame pacing statistics to the log
+extern void printFramePacingStats();
+
 #endif // __AGS_EE_AC__TIMER_H
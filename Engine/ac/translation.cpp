@@ -36,6 +36,9 @@ extern GameSetupStruct game;
 String trans_name;
 String trans_filename;
 Translation trans;
+// Translation data read in advance, during engine startup
+String preloaded_trans_name;
+Translation preloaded_trans;
 
 
 void init_font_overrides(const Translation &trans)
@@ -98,10 +101,22 @@ void close_translation()
     SetTranslationTextParser(CreateTextParser(game.dict.get(), get_uformat() == U_UTF8, play.GetTextLocaleName()));
 }
 
+void set_preloaded_translation(const String &lang, Translation &&tra)
+{
+    preloaded_trans_name = lang;
+    preloaded_trans = std::move(tra);
+}
+
 bool init_translation(const String &lang, const String &fallback_lang)
 {
     if (lang.IsEmpty())
         return false;
+    // Take the preloaded data, if it's for the same translation
+    const bool use_preloaded = !preloaded_trans_name.IsEmpty() && (preloaded_trans_name == lang);
+    Translation preloaded = std::move(preloaded_trans);
+    preloaded_trans = Translation();
+    preloaded_trans_name = "";
+
     trans_name = lang;
     trans_filename = String::FromFormat("%s.tra", lang.GetCStr());
 
@@ -118,9 +133,17 @@ bool init_translation(const String &lang, const String &fallback_lang)
     HError err = TestTraGameID(game.uniqueid, game.gamename, std::move(in));
     if (err)
     {
-        // If successful, then read translation data fully
-        in = AssetMgr->OpenAsset(trans_filename);
-        err = ReadTraData(trans, std::move(in));
+        // If successful, then read translation data fully,
+        // or use the one that was read in advance
+        if (use_preloaded)
+        {
+            trans = std::move(preloaded);
+        }
+        else
+        {
+            in = AssetMgr->OpenAsset(trans_filename);
+            err = ReadTraData(trans, std::move(in));
+        }
     }
 
     // Process errors
@@ -190,12 +213,21 @@ bool init_translation(const String &lang, const String &fallback_lang)
             StringMap conv_map;
             std::vector<char> ascii; // ascii buffer
             Debug::Printf("Converting UTF-8 TRA keys to the game's encoding (%s)", key_enc.GetCStr());
+            // The precomputed index is made for the original keys, so we have to
+            // fallback to the regular dictionary here
+            const TraDictIndex &dict_index = trans.DictIndex;
+            for (size_t i = 0; i < dict_index.GetCount(); ++i)
+            {
+                StrUtil::ConvertUtf8ToAscii(dict_index.GetKey(i), key_enc.GetCStr(), ascii);
+                conv_map.insert(std::make_pair(ascii.data(), dict_index.GetValue(i)));
+            }
             for (const auto &item : trans.Dict)
             {
                 StrUtil::ConvertUtf8ToAscii(item.first.GetCStr(), key_enc.GetCStr(), ascii);
                 conv_map.insert(std::make_pair(ascii.data(), item.second));
             }
-            trans.Dict = conv_map;
+            trans.Dict = std::move(conv_map);
+            trans.DictIndex = TraDictIndex();
         }
         else
         {
@@ -231,7 +263,21 @@ String get_translation_path()
     return trans_filename;
 }
 
-const StringMap& get_translation_tree()
+bool has_translated_lines()
+{
+    return !trans.DictIndex.IsEmpty() || !trans.Dict.empty();
+}
+
+const char *find_translated_line(const char *text, size_t &text_len)
 {
-    return trans.Dict;
+    if (!trans.DictIndex.IsEmpty())
+        return trans.DictIndex.Find(text, text_len);
+    const String key = String::Wrapper(text);
+    text_len = key.GetLength();
+    if (trans.Dict.empty())
+        return nullptr;
+    const auto it = trans.Dict.find(key);
+    if (it != trans.Dict.end())
+        return it->second.GetCStr();
+    return nullptr;
 }
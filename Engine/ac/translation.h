@@ -20,16 +20,23 @@
 
 #include "util/string_types.h"
 
+namespace AGS { namespace Common { struct Translation; } }
 using AGS::Common::String;
-using AGS::Common::StringMap;
 
 void close_translation ();
 bool init_translation (const String &lang, const String &fallback_lang);
+// Assigns translation data which was read in advance; it will be used by
+// the next init_translation() call for the same language, instead of reading
+// the translation file again
+void set_preloaded_translation(const String &lang, AGS::Common::Translation &&tra);
 // Returns current translation name, or empty string if default translation is used
 String get_translation_name();
 // Returns fill path to the translation file, or empty string if default translation is used
 String get_translation_path();
-// Returns translation map for reading only
-const StringMap &get_translation_tree();
+// Tells if the current translation has any translated lines
+bool has_translated_lines();
+// Finds the translated line for the given text; returns nullptr if none found.
+// Also returns the text's length, which is calculated during the lookup.
+const char *find_translated_line(const char *text, size_t &text_len);
 
 #endif // __AGS_EE_AC__TRANSLATION_H
@@ -13,6 +13,7 @@
 //=============================================================================
 #include "ac/walkbehind.h"
 #include <algorithm>
+#include <string.h>
 #include "ac/draw.h"
 #include "ac/gamestate.h"
 #include "ac/roomstatus.h"
@@ -27,27 +28,48 @@ extern RoomStruct thisroom;
 extern IGraphicsDriver *gfxDriver;
 extern RoomStatus *croom;
 
-// An info on vertical column of walk-behind mask, which may contain WB area
-struct WalkBehindColumn
+// A horizontal run of walk-behind mask pixels belonging to the same area
+struct WalkBehindSpan
 {
-    bool Exists = false; // whether any WB area is in this column
-    int Y1 = 0, Y2 = 0; // WB top and bottom Y coords
+    int X1 = 0, X2 = 0; // first and past-the-last X coords
+    int WB = 0; // walk-behind area index
 };
 
-std::vector<WalkBehindColumn> walkBehindCols; // precalculated WB positions
+// Precalculated WB spans, stored row by row: spans of row Y are found in
+// the range [walkBehindRows[Y], walkBehindRows[Y + 1]) of walkBehindSpans.
+std::vector<WalkBehindSpan> walkBehindSpans;
+std::vector<uint32_t> walkBehindRows;
 Rect walkBehindAABB[MAX_WALK_BEHINDS]; // WB bounding box
 int walkBehindsCachedForBgNum = -1; // WB textures are for this background
 bool noWalkBehindsAtAll = false; // quick report that no WBs in this room
 bool walk_behind_baselines_changed = false;
 
 
+// Copies a range of pixels from one row to another
+static inline void CopyPixels(uint8_t *dst, const uint8_t *src, int x1, int x2, int bpp)
+{
+    memcpy(dst + x1 * bpp, src + x1 * bpp, (x2 - x1) * bpp);
+}
+
+// Fills a range of pixels in a row with the given color
+static inline void FillPixels(uint8_t *dst, int x1, int x2, int color, int bpp)
+{
+    switch (bpp)
+    {
+    case 1: memset(dst + x1, color, x2 - x1); break;
+    case 2: std::fill(reinterpret_cast<uint16_t*>(dst) + x1, reinterpret_cast<uint16_t*>(dst) + x2, static_cast<uint16_t>(color)); break;
+    case 4: std::fill(reinterpret_cast<uint32_t*>(dst) + x1, reinterpret_cast<uint32_t*>(dst) + x2, static_cast<uint32_t>(color)); break;
+    default: assert(0); break;
+    }
+}
+
 // Generates walk-behinds as separate sprites
 void walkbehinds_generate_sprites()
 {
-    const Bitmap *mask = thisroom.WalkBehindMask.get();
     const Bitmap *bg = thisroom.BgImages[play.bg_frame].get();
     
     const int coldepth = bg->GetColorDepth();
+    const int bpp = bg->GetBPP();
     Bitmap wbbmp; // temp buffer
     // Iterate through walk-behinds and generate a texture for each of them
     for (int wb = 1 /* 0 is "no area" */; wb < MAX_WALK_BEHINDS; ++wb)
@@ -57,30 +79,15 @@ void walkbehinds_generate_sprites()
         {
             wbbmp.CreateTransparent(pos.GetWidth(), pos.GetHeight(), coldepth);
             // Copy over all solid pixels belonging to this WB area
-            const int sx = pos.Left, ex = pos.Right, sy = pos.Top, ey = pos.Bottom;
-            for (int y = sy; y <= ey; ++y)
+            for (int y = pos.Top; y <= pos.Bottom; ++y)
             {
-                const uint8_t *check_line = mask->GetScanLine(y);
-                const uint8_t *src_line = bg->GetScanLine(y);
-                uint8_t *dst_line = wbbmp.GetScanLineForWriting(y - sy);
-                for (int x = sx; x <= ex; ++x)
+                const uint8_t *src_line = bg->GetScanLine(y) + pos.Left * bpp;
+                uint8_t *dst_line = wbbmp.GetScanLineForWriting(y - pos.Top);
+                for (uint32_t i = walkBehindRows[y]; i < walkBehindRows[y + 1]; ++i)
                 {
-                    if (check_line[x] != wb) continue;
-                    switch (coldepth)
-                    {
-                    case 8:
-                        dst_line[(x - sx)] = src_line[x];
-                        break;
-                    case 16:
-                        reinterpret_cast<uint16_t*>(dst_line)[(x - sx)] =
-                            reinterpret_cast<const uint16_t*>(src_line)[x];
-                        break;
-                    case 32:
-                        reinterpret_cast<uint32_t*>(dst_line)[(x - sx)] =
-                            reinterpret_cast<const uint32_t*>(src_line)[x];
-                        break;
-                    default: assert(0); break;
-                    }
+                    const auto &span = walkBehindSpans[i];
+                    if (span.WB == wb)
+                        CopyPixels(dst_line, src_line, span.X1 - pos.Left, span.X2 - pos.Left, bpp);
                 }
             }
             // Add to walk-behinds image list
@@ -99,47 +106,28 @@ bool walkbehinds_cropout(Bitmap *sprit, int sprx, int spry, int basel)
         return false;
 
     const int maskcol = sprit->GetMaskColor();
-    const int spcoldep = sprit->GetColorDepth();
+    const int bpp = sprit->GetBPP();
+    // only check the sprite's part which lies within the mask
+    const int x1 = std::max(0, sprx);
+    const int x2 = std::min(sprx + sprit->GetWidth(), thisroom.WalkBehindMask->GetWidth());
+    const int y1 = std::max(0, spry);
+    const int y2 = std::min(spry + sprit->GetHeight(), thisroom.WalkBehindMask->GetHeight());
 
     bool pixels_changed = false;
-    // pass along the sprite's pixels, but skip those that lie outside the mask
-    for (int x = std::max(0, 0 - sprx);
-        (x < sprit->GetWidth()) && (x + sprx < thisroom.WalkBehindMask->GetWidth()); ++x)
+    for (int y = y1; y < y2; ++y)
     {
-        // select the WB column at this x
-        const auto &wbcol = walkBehindCols[x + sprx];
-        // skip if no area, or sprite lies outside of all areas in this column
-        if ((!wbcol.Exists) ||
-            (wbcol.Y2 <= spry) ||
-            (wbcol.Y1 > spry + sprit->GetHeight()))
-            continue;
-
-        // ensure we only check within the valid areas (between Y1 and Y2)
-        // we assume that Y1 and Y2 are always within the mask
-        for (int y = std::max(0, wbcol.Y1 - spry);
-            (y < sprit->GetHeight()) && (y + spry < wbcol.Y2); ++y)
+        uint8_t *dst_line = nullptr;
+        for (uint32_t i = walkBehindRows[y]; i < walkBehindRows[y + 1]; ++i)
         {
-            const int wb = thisroom.WalkBehindMask->GetScanLine(y + spry)[x + sprx];
-            if (wb < 1) continue; // "no area"
-            if (croom->walkbehind_base[wb] <= basel) continue;
-
+            const auto &span = walkBehindSpans[i];
+            if (span.X2 <= x1) continue;
+            if (span.X1 >= x2) break; // spans are sorted by X
+            if (croom->walkbehind_base[span.WB] <= basel) continue;
+
+            if (!dst_line)
+                dst_line = sprit->GetScanLineForWriting(y - spry);
+            FillPixels(dst_line, std::max(span.X1, x1) - sprx, std::min(span.X2, x2) - sprx, maskcol, bpp);
             pixels_changed = true;
-            uint8_t *dst_line = sprit->GetScanLineForWriting(y);
-            switch (spcoldep)
-            {
-            case 8:
-                dst_line[x] = maskcol;
-                break;
-            case 16:
-                reinterpret_cast<uint16_t*>(dst_line)[x] = maskcol;
-                break;
-            case 32:
-                reinterpret_cast<uint32_t*>(dst_line)[x] = maskcol;
-                break;
-            default:
-                assert(0);
-                break;
-            }
         }
     }
     return pixels_changed;
@@ -148,40 +136,43 @@ bool walkbehinds_cropout(Bitmap *sprit, int sprx, int spry, int basel)
 void walkbehinds_recalc()
 {
     // Reset all data
-    walkBehindCols.clear();
+    walkBehindSpans.clear();
+    walkBehindRows.clear();
     for (int wb = 0; wb < MAX_WALK_BEHINDS; ++wb)
     {
         walkBehindAABB[wb] = Rect(INT32_MAX, INT32_MAX, INT32_MIN, INT32_MIN);
     }
-    noWalkBehindsAtAll = true;
 
     // Recalculate everything; note that mask is always 8-bit
     const Bitmap *mask = thisroom.WalkBehindMask.get();
-    walkBehindCols.resize(mask->GetWidth());
-    for (int col = 0; col < mask->GetWidth(); ++col)
+    walkBehindRows.resize(mask->GetHeight() + 1);
+    for (int y = 0; y < mask->GetHeight(); ++y)
     {
-        auto &wbcol = walkBehindCols[col];
-        for (int y = 0; y < mask->GetHeight(); ++y)
+        walkBehindRows[y] = static_cast<uint32_t>(walkBehindSpans.size());
+        const uint8_t *line = mask->GetScanLine(y);
+        for (int x = 0; x < mask->GetWidth();)
         {
-            int wb = mask->GetScanLine(y)[col];
+            const int wb = line[x];
+            const int span_x1 = x;
+            for (++x; (x < mask->GetWidth()) && (line[x] == wb); ++x);
             // Valid areas start with index 1, 0 = no area
             if ((wb >= 1) && (wb < MAX_WALK_BEHINDS))
             {
-                if (!wbcol.Exists)
-                {
-                    wbcol.Y1 = y;
-                    wbcol.Exists = true;
-                    noWalkBehindsAtAll = false;
-                }
-                wbcol.Y2 = y + 1; // +1 to allow bottom line of screen to work (CHECKME??)
+                WalkBehindSpan span;
+                span.X1 = span_x1;
+                span.X2 = x;
+                span.WB = wb;
+                walkBehindSpans.push_back(span);
                 // resize the bounding rect
-                walkBehindAABB[wb].Left = std::min(col, walkBehindAABB[wb].Left);
+                walkBehindAABB[wb].Left = std::min(span_x1, walkBehindAABB[wb].Left);
                 walkBehindAABB[wb].Top = std::min(y, walkBehindAABB[wb].Top);
-                walkBehindAABB[wb].Right = std::max(col, walkBehindAABB[wb].Right);
+                walkBehindAABB[wb].Right = std::max(x - 1, walkBehindAABB[wb].Right);
                 walkBehindAABB[wb].Bottom = std::max(y, walkBehindAABB[wb].Bottom);
             }
         }
     }
+    walkBehindRows[mask->GetHeight()] = static_cast<uint32_t>(walkBehindSpans.size());
+    noWalkBehindsAtAll = walkBehindSpans.empty();
 
     walkBehindsCachedForBgNum = -1;
 }
@@ -23,6 +23,7 @@
 #include "ac/common.h"
 #include "ac/gamesetupstruct.h"
 #include "ac/gamestate.h"
+#include "ac/path_helper.h"
 #include "ac/runtime_defines.h"
 #include "debug/agseditordebugger.h"
 #include "debug/debug_log.h"
@@ -30,6 +31,7 @@
 #include "debug/debugmanager.h"
 #include "debug/out.h"
 #include "debug/logfile.h"
+#include "debug/profiler.h"
 #include "debug/messagebuffer.h"
 #include "main/config.h"
 #include "main/game_run.h"
@@ -669,6 +671,21 @@ void scriptDebugHook (ccInstance *ccinst, int linenum) {
 
 int scrlockWasDown = 0;
 
+#if AGS_PROFILER
+int pauseWasDown = 0;
+
+// Writes the timeline recorded by the profiler into the game's user data dir
+static void write_profiler_trace()
+{
+    const String path = PreparePathForWriting(GetGameUserDataDir(),
+        String::FromFormat("trace_%u.json", get_loop_counter()));
+    if (!path.IsEmpty() && Profiler::WriteChromeTrace(path))
+        Debug::Printf(kDbgMsg_Info, "Profiler trace written to: %s", path.GetCStr());
+    else
+        Debug::Printf(kDbgMsg_Error, "Failed to write profiler trace to: %s", path.GetCStr());
+}
+#endif
+
 void check_debug_keys() {
     if (play.debug_mode) {
         // do the run-time script debugging
@@ -684,4 +701,15 @@ void check_debug_keys() {
 
     }
 
+#if AGS_PROFILER
+    // Pause key writes the profiler trace; not tied to the debug mode,
+    // as the profiler is only compiled into the development builds
+    const Uint8 *ks = SDL_GetKeyboardState(nullptr);
+    if ((!ks[SDL_SCANCODE_PAUSE]) && (pauseWasDown))
+        pauseWasDown = 0;
+    else if ((ks[SDL_SCANCODE_PAUSE]) && (!pauseWasDown)) {
+        write_profiler_trace();
+        pauseWasDown = 1;
+    }
+#endif
 }
@@ -54,6 +54,7 @@ void check_debug_keys();
 #define DBG_DEBUGMODE 0x100
 #define DBG_REGONLY   0x200
 #define DBG_NOVIDEO   0x400
+#define DBG_GUIDAMAGE 0x800
 
 enum FPSDisplayMode
 {
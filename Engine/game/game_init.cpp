@@ -40,6 +40,7 @@
 #include "gfx/ddb.h"
 #include "gui/guilabel.h"
 #include "gui/guiinv.h"
+#include "main/engine.h"
 #include "media/audio/audio_system.h"
 #include "platform/base/agsplatformdriver.h"
 #include "plugin/plugin_engine.h"
@@ -540,6 +541,8 @@ HGameInitError InitGameState(const LoadedGameEntities &ents, GameDataVersion dat
     //
     // 7. Start up plugins
     //
+    // NOTE: plugins may use audio, so audio system must be ready by now
+    engine_wait_audio_init();
     pl_register_plugins(ents.PluginInfos, !usetup.Override.NoPlugins);
     pl_startup_plugins();
 
@@ -59,6 +59,9 @@
 #include "script/script.h"
 #include "script/cc_common.h"
 #include "script/script_runtime.h"
+#include <mutex>
+#include <thread>
+#include <unordered_map>
 #include "util/compress.h"
 #include "util/file.h"
 #include "util/memory_compat.h"
@@ -170,6 +173,8 @@ String GetSavegameErrorText(SavegameErrorType err)
         return "Game object initialization failed after save restoration.";
     case kSvgErr_ComponentUncompressedSizeMismatch:
         return "Uncompressed component data size mismatch.";
+    case kSvgErr_DeltaBaseMismatch:
+        return "Delta save does not match its base save.";
     case kSvgErr_InternalError:
         return "Internal program error.";
     default:
@@ -1271,9 +1276,339 @@ HSaveError SaveGame(const String &filename, const String &user_text, const Bitma
 
     // Finalize the save file, write composed file format
     WriteFileFormat(out.get(), format);
+    out.reset();
+    // A full save replaces any previous delta save, so its base is no longer needed
+    File::DeleteFile(GetDeltaSaveBaseFilename(filename));
     return HSaveError::None();
 }
 
+// BackgroundSaveJob contains all the data prepared for writing a save file
+struct BackgroundSaveJob
+{
+    String Filename;
+    // Save signature and description, with the finalized file format
+    std::vector<uint8_t> Header;
+    SavegameComponents::ComponentSnapshots Components;
+    bool Compress = false;
+    // Base save which has to be written along with this one (for delta saves)
+    std::unique_ptr<BackgroundSaveJob> BaseJob;
+    // Remove the base of a previous delta save, once this save is written
+    bool RemoveDeltaBase = false;
+};
+
+// State of the save written on a background thread
+static struct
+{
+    std::thread Thread;
+    std::mutex Mutex;
+    bool Active = false; // a save was started and its result not polled yet
+    bool Done = false; // a save has completed
+    String Filename; // the file being written
+    HSaveError Result;
+} BgSave;
+
+// Remembered state of a delta save's base, one per save file
+struct DeltaSaveRecord
+{
+    uint32_t BaseID = 0u;
+    SaveCmpSelection Selection = kSaveCmp_None;
+    // Content hashes of the components stored in the base save
+    std::unordered_map<String, uint64_t> Hashes;
+};
+
+static std::unordered_map<String, DeltaSaveRecord> DeltaSaves;
+
+// Writes save's signature and description into the memory buffer,
+// with the finalized file format
+static void WriteSaveHeader(std::vector<uint8_t> &buf, const String &user_text, const Bitmap *user_image,
+    uint32_t format_flags)
+{
+    SavegameFileFormat format;
+    format.Flags = format_flags;
+    Stream mem_out(std::make_unique<VectorStream>(buf, kStream_Write));
+    mem_out.Write(SavegameSource::Signature.GetCStr(), SavegameSource::Signature.GetLength());
+    WriteDescription(&mem_out, user_text, user_image, format);
+    format.GameDataOffset = mem_out.GetPosition();
+    WriteFileFormat(&mem_out, format);
+}
+
+// Writes prepared save data into the given file
+static HSaveError WriteSaveFile(const BackgroundSaveJob &job, const String &filename)
+{
+    std::unique_ptr<Stream> out(File::CreateFile(filename));
+    if (!out)
+        return new SavegameError(kSvgErr_FileOpenFailed, String::FromFormat("Requested filename: %s.", filename.GetCStr()));
+    out->Write(job.Header.data(), job.Header.size());
+    HSaveError err = SavegameComponents::WriteAllSnapshot(out.get(), job.Components, job.Compress);
+    const bool io_error = out->GetError();
+    out.reset();
+    if (!err || io_error)
+    {
+        File::DeleteFile(filename);
+        if (!err)
+            return err;
+        return new SavegameError(kSvgErr_InternalError, "Failed to write the file.");
+    }
+    return HSaveError::None();
+}
+
+// Replaces the target file with the written temporary file
+static HSaveError CommitSaveFile(const String &tmp_filename, const String &filename)
+{
+    if (!File::ReplaceFile(tmp_filename, filename))
+    {
+        return new SavegameError(kSvgErr_FileOpenFailed, String::FromFormat("Failed to rename %s to %s.",
+            tmp_filename.GetCStr(), filename.GetCStr()));
+    }
+    return HSaveError::None();
+}
+
+// Writes prepared save data into a temporary file, then replaces the target file.
+// A delta save and its new base are both written under temporary names first,
+// then the delta is replaced before the base. If interrupted in between, the
+// restoration finds the matching base under its temporary name; otherwise
+// the previous pair of files is kept intact.
+static HSaveError WriteSaveJob(const BackgroundSaveJob &job)
+{
+    String base_tmp_filename;
+    if (job.BaseJob)
+    {
+        base_tmp_filename = GetSaveTempFilename(job.BaseJob->Filename);
+        HSaveError err = WriteSaveFile(*job.BaseJob, base_tmp_filename);
+        if (!err)
+            return err;
+    }
+
+    const String tmp_filename = GetSaveTempFilename(job.Filename);
+    HSaveError err = WriteSaveFile(job, tmp_filename);
+    if (err)
+    {
+        err = CommitSaveFile(tmp_filename, job.Filename);
+        if (!err)
+            File::DeleteFile(tmp_filename);
+    }
+    if (!err)
+    {
+        if (job.BaseJob)
+            File::DeleteFile(base_tmp_filename);
+        return err;
+    }
+
+    // Delta save is in place now; if its base fails to replace the old one,
+    // then the temporary base file is kept, as the delta refers to it
+    if (job.BaseJob)
+        return CommitSaveFile(base_tmp_filename, job.BaseJob->Filename);
+    if (job.RemoveDeltaBase)
+        File::DeleteFile(GetDeltaSaveBaseFilename(job.Filename));
+    return HSaveError::None();
+}
+
+static void BackgroundSaveEntry(std::unique_ptr<BackgroundSaveJob> job)
+{
+    HSaveError err = WriteSaveJob(*job);
+    std::lock_guard<std::mutex> lk(BgSave.Mutex);
+    BgSave.Result = err;
+    BgSave.Done = true;
+}
+
+// Completes the previous background save, if there's one, discarding its result
+static void EndPreviousBackgroundSave()
+{
+    WaitForBackgroundSave();
+    if (BgSave.Active)
+    {
+        HSaveError prev_result;
+        PollBackgroundSave(prev_result);
+    }
+}
+
+// Starts writing the prepared save on a background thread
+static void StartBackgroundSave(std::unique_ptr<BackgroundSaveJob> job)
+{
+    BgSave.Active = true;
+    BgSave.Done = false;
+    BgSave.Filename = job->Filename;
+    BgSave.Result = HSaveError::None();
+#if !defined(AGS_DISABLE_THREADS)
+    BgSave.Thread = std::thread(BackgroundSaveEntry, std::move(job));
+#else
+    BackgroundSaveEntry(std::move(job));
+#endif
+}
+
+HSaveError SaveGameInBackground(const String &filename, const String &user_text, const Bitmap *user_image,
+                    SaveCmpSelection select_cmp, bool compress_data)
+{
+    EndPreviousBackgroundSave();
+
+    std::unique_ptr<BackgroundSaveJob> job(new BackgroundSaveJob());
+    job->Filename = filename;
+    job->Compress = compress_data;
+    // A full save replaces any previous delta save, so its base is no longer needed
+    job->RemoveDeltaBase = true;
+
+    // Write the save's description into memory
+    WriteSaveHeader(job->Header, user_text, user_image, kSvgFmt_DeflateComponents * compress_data);
+
+    // Serialize game state into memory
+    select_cmp = FixupCmpSelection(select_cmp);
+    DoBeforeSave();
+    HSaveError err = SavegameComponents::SnapshotAllCommon(select_cmp, job->Components);
+    if (!err)
+        return err;
+
+    StartBackgroundSave(std::move(job));
+    return HSaveError::None();
+}
+
+bool IsSavingInBackground()
+{
+    return BgSave.Active;
+}
+
+bool PollBackgroundSave(HSaveError &result)
+{
+    if (!BgSave.Active)
+        return false;
+    {
+        std::lock_guard<std::mutex> lk(BgSave.Mutex);
+        if (!BgSave.Done)
+            return false;
+        result = BgSave.Result;
+    }
+    if (BgSave.Thread.joinable())
+        BgSave.Thread.join();
+    BgSave.Active = false;
+    BgSave.Done = false;
+    // If a delta save has failed, then its base cannot be relied on anymore
+    if (!result)
+        ForgetDeltaSave(BgSave.Filename);
+    return true;
+}
+
+void WaitForBackgroundSave()
+{
+    if (BgSave.Thread.joinable())
+        BgSave.Thread.join();
+}
+
+// Calculates 64-bit FNV-1a hash of the data
+static uint64_t HashComponentData(const std::vector<uint8_t> &data)
+{
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (uint8_t b : data)
+    {
+        hash ^= b;
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+HSaveError SaveGameDelta(const String &filename, const String &user_text, const Bitmap *user_image,
+                    SaveCmpSelection select_cmp, bool compress_data, bool in_background)
+{
+    EndPreviousBackgroundSave();
+
+    // Serialize game state into memory
+    select_cmp = FixupCmpSelection(select_cmp);
+    DoBeforeSave();
+    SavegameComponents::ComponentSnapshots components;
+    HSaveError err = SavegameComponents::SnapshotAllCommon(select_cmp, components);
+    if (!err)
+        return err;
+
+    // Find out which components have changed since the base save
+    const String base_filename = GetDeltaSaveBaseFilename(filename);
+    auto rec_it = DeltaSaves.find(filename);
+    bool rebase = (rec_it == DeltaSaves.end()) || (rec_it->second.Selection != select_cmp) ||
+        !File::IsFile(base_filename);
+    std::vector<uint64_t> hashes(components.size());
+    size_t total_size = 0u, changed_size = 0u;
+    for (size_t i = 0; i < components.size(); ++i)
+    {
+        const auto &cmp = components[i];
+        hashes[i] = HashComponentData(cmp.Data);
+        total_size += cmp.Data.size();
+        if (rebase)
+            continue;
+        auto hash_it = rec_it->second.Hashes.find(cmp.Name);
+        if ((hash_it == rec_it->second.Hashes.end()) || (hash_it->second != hashes[i]))
+            changed_size += cmp.Data.size();
+    }
+    // Compact the delta into a new base save when it grows too large
+    rebase |= (changed_size > total_size / 2);
+
+    std::unique_ptr<BackgroundSaveJob> job(new BackgroundSaveJob());
+    job->Filename = filename;
+    job->Compress = compress_data;
+    WriteSaveHeader(job->Header, user_text, user_image,
+        (kSvgFmt_DeflateComponents * compress_data) | kSvgFmt_Delta);
+
+    if (rebase)
+    {
+        // The base's ID is derived from its contents
+        DeltaSaveRecord rec;
+        rec.Selection = select_cmp;
+        uint64_t base_hash = 0xcbf29ce484222325ULL;
+        for (size_t i = 0; i < components.size(); ++i)
+        {
+            rec.Hashes[components[i].Name] = hashes[i];
+            base_hash = (base_hash ^ hashes[i]) * 0x100000001b3ULL;
+        }
+        rec.BaseID = static_cast<uint32_t>(base_hash ^ (base_hash >> 32));
+
+        std::unique_ptr<BackgroundSaveJob> base_job(new BackgroundSaveJob());
+        base_job->Filename = base_filename;
+        base_job->Compress = compress_data;
+        WriteSaveHeader(base_job->Header, user_text, user_image, kSvgFmt_DeflateComponents * compress_data);
+        base_job->Components.push_back(SavegameComponents::MakeDeltaBaseSnapshot(rec.BaseID));
+        for (auto &cmp : components)
+            base_job->Components.push_back(std::move(cmp));
+        job->Components.push_back(SavegameComponents::MakeDeltaBaseSnapshot(rec.BaseID));
+        job->BaseJob = std::move(base_job);
+        DeltaSaves[filename] = std::move(rec);
+        Debug::Printf(kDbgMsg_Info, "Delta save: writing new base save, %zu bytes of game data", total_size);
+    }
+    else
+    {
+        const auto &rec = rec_it->second;
+        job->Components.push_back(SavegameComponents::MakeDeltaBaseSnapshot(rec.BaseID));
+        for (size_t i = 0; i < components.size(); ++i)
+        {
+            auto hash_it = rec.Hashes.find(components[i].Name);
+            if ((hash_it == rec.Hashes.end()) || (hash_it->second != hashes[i]))
+                job->Components.push_back(std::move(components[i]));
+        }
+        Debug::Printf(kDbgMsg_Info, "Delta save: %zu of %zu bytes of game data changed", changed_size, total_size);
+    }
+
+    if (in_background)
+    {
+        StartBackgroundSave(std::move(job));
+        return HSaveError::None();
+    }
+
+    err = WriteSaveJob(*job);
+    if (!err)
+        ForgetDeltaSave(filename);
+    return err;
+}
+
+String GetDeltaSaveBaseFilename(const String &filename)
+{
+    return String::FromFormat("%s.base", filename.GetCStr());
+}
+
+String GetSaveTempFilename(const String &filename)
+{
+    return String::FromFormat("%s.tmp", filename.GetCStr());
+}
+
+void ForgetDeltaSave(const String &filename)
+{
+    DeltaSaves.erase(filename);
+}
+
 //=============================================================================
 //
 // RestoredSaveInfo API
@@ -89,6 +89,7 @@ enum SavegameErrorType
     kSvgErr_DifferentColorDepth,
     kSvgErr_GameObjectInitFailed,
     kSvgErr_ComponentUncompressedSizeMismatch,
+    kSvgErr_DeltaBaseMismatch,
     kSvgErr_InternalError,
     kNumSavegameError
 };
@@ -103,7 +104,10 @@ enum SaveFileFormatFlags
     // Compress save components (whenever applicable);
     // note that the save's meta-data is never compressed, only game data
     // and user appendages, such as screenshots
-    kSvgFmt_DeflateComponents = 0x0001
+    kSvgFmt_DeflateComponents = 0x0001,
+    // The save contains only components changed since the base save,
+    // which is stored in a separate file (see GetDeltaSaveBaseFilename)
+    kSvgFmt_Delta             = 0x0002
 };
 
 // File content info
@@ -288,6 +292,34 @@ HSaveError     RestoreSavegame(const String &filename, const RestoreGameStateOpt
 // Write a save file, using user description, and optionally restricting game data to selected components
 HSaveError     SaveGame(const String &filename, const String &user_text, const Bitmap *user_image,
                         SaveCmpSelection select_cmp, bool compress_data = false);
+// Write a save file in background: game data is serialized into memory right away,
+// but compressed and written to disk on a separate thread. The file is written under
+// a temporary name, and renamed to the requested one when complete.
+// Only one background save may be active at a time: if there's one, this waits for it first.
+HSaveError     SaveGameInBackground(const String &filename, const String &user_text, const Bitmap *user_image,
+                        SaveCmpSelection select_cmp, bool compress_data = false);
+// Tells whether there's a background save which result was not polled yet
+bool           IsSavingInBackground();
+// Checks if the background save has completed; returns true once per completed save,
+// and assigns its result
+bool           PollBackgroundSave(HSaveError &result);
+// Blocks until the active background save is complete; does not reset its result
+void           WaitForBackgroundSave();
+// Write a delta save file: only the components which changed since the last full save
+// into the same file are written, while the full save is kept in a separate base file.
+// The base file is rewritten (compacted) if it's missing, was not written in this session,
+// or if the changes make up more than a half of the game data.
+// Optionally writes the file(s) in background, same as SaveGameInBackground.
+HSaveError     SaveGameDelta(const String &filename, const String &user_text, const Bitmap *user_image,
+                        SaveCmpSelection select_cmp, bool compress_data, bool in_background);
+// Gets the name of a base file which goes along with the given delta save
+String         GetDeltaSaveBaseFilename(const String &filename);
+// Gets the name under which a save file is written before replacing the target file;
+// a delta save's new base may be left under such name if the save was interrupted
+String         GetSaveTempFilename(const String &filename);
+// Drops any remembered delta save state for the given file; this should be
+// called whenever the save file is modified, moved or deleted by other means
+void           ForgetDeltaSave(const String &filename);
 
 } // namespace Engine
 } // namespace AGS
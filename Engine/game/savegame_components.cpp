@@ -11,7 +11,11 @@
 // https://opensource.org/license/artistic-2-0/
 //
 //=============================================================================
+#include <algorithm>
+#include <atomic>
+#include <functional>
 #include <map>
+#include <thread>
 #include "game/savegame_components.h"
 #include "ac/audiocliptype.h"
 #include "ac/button.h"
@@ -51,7 +55,9 @@
 #include "script/cc_common.h"
 #include "script/script.h"
 #include "util/deflatestream.h"
+#include "util/file.h"
 #include "util/memory_compat.h"
+#include "util/memorystream.h"
 #include "util/string_utils.h"
 
 using namespace Common;
@@ -81,6 +87,8 @@ namespace SavegameComponents
 
 // Tag used to mark the beginning of a save component list
 const String ComponentListTag = "Components";
+// Name of a component which links delta save to its base save
+const String DeltaBaseTag = "Delta Base";
 
 // Writes a opening or closing tag for a save component
 void WriteFormatTag(Stream *out, const String &tag, bool open = true)
@@ -2008,9 +2016,9 @@ struct ComponentInfo
     ComponentInfo() = default;
 };
 
-HSaveError ReadComponent(Stream *in, SvgCmpReadHelper &hlp, ComponentInfo &info)
+// Reads component's header, fills ComponentInfo
+static HSaveError ReadComponentInfo(Stream *in, SvgCmpReadHelper &hlp, ComponentInfo &info)
 {
-    // Read component info
     info = ComponentInfo();
     info.TagOffset = in->GetPosition();
     if (!ReadFormatTag(in, info.Name, true))
@@ -2037,9 +2045,15 @@ HSaveError ReadComponent(Stream *in, SvgCmpReadHelper &hlp, ComponentInfo &info)
     }
     // Assume that component data begins right after the header
     info.DataOffset = in->GetPosition();
+    return HSaveError::None();
+}
 
-    // Find component's handler(s)
-    const ComponentHandler *handler = nullptr;
+// Finds a handler for the given component, which is not disabled by ComponentSelection;
+// returns error if the component type is not supported at all
+static HSaveError FindComponentHandler(SvgCmpReadHelper &hlp, const ComponentInfo &info,
+    const ComponentHandler *&handler)
+{
+    handler = nullptr;
     auto it_hdr = hlp.Handlers.equal_range(info.Name);
     const bool found_any = it_hdr.first != it_hdr.second;
     if (!found_any)
@@ -2053,6 +2067,21 @@ HSaveError ReadComponent(Stream *in, SvgCmpReadHelper &hlp, ComponentInfo &info)
             handler = &it->second;
         }
     }
+    return HSaveError::None();
+}
+
+HSaveError ReadComponent(Stream *in, SvgCmpReadHelper &hlp, ComponentInfo &info)
+{
+    // Read component info
+    HSaveError err = ReadComponentInfo(in, hlp, info);
+    if (!err)
+        return err;
+
+    // Find component's handler(s)
+    const ComponentHandler *handler = nullptr;
+    err = FindComponentHandler(hlp, info, handler);
+    if (!err)
+        return err;
 
     const bool prescan = (hlp.RData.Result.RestoreFlags & kSaveRestore_Prescan) != 0;
     auto pfn_read = prescan ? handler->Prescan : handler->Unserialize;
@@ -2144,29 +2173,356 @@ HSaveError ReadAllImpl(Stream *in, SavegameVersion svg_version, SaveCmpSelection
     return new SavegameError(kSvgErr_ComponentListClosingTagMissing);
 }
 
+// ComponentBlock is a component's data read from the save stream,
+// and prepared for decompression and unserialization
+struct ComponentBlock
+{
+    ComponentInfo Info;
+    const ComponentHandler *Handler = nullptr;
+    std::vector<uint8_t> Data; // component data, uncompressed after decompression
+    HSaveError Error;
+    bool FromBase = false; // component comes from the delta save's base
+};
+
+// Reads the list of components into memory, without unserializing them;
+// the data of components which are skipped by selection is not kept.
+// If load_data is false, then only the component headers are read.
+// Delta base reference is always kept with its data, and has no handler.
+static HSaveError IndexComponents(Stream *in, SvgCmpReadHelper &hlp, std::vector<ComponentBlock> &blocks,
+    bool load_data = true)
+{
+    const bool prescan = (hlp.RData.Result.RestoreFlags & kSaveRestore_Prescan) != 0;
+    if (!AssertFormatTag(in, ComponentListTag, true))
+        return new SavegameError(kSvgErr_ComponentListOpeningTagFormat);
+    do
+    {
+        // Look out for the end of the component list
+        soff_t off = in->GetPosition();
+        if (AssertFormatTag(in, ComponentListTag, false))
+            return HSaveError::None();
+        in->Seek(off, kSeekBegin);
+
+        ComponentBlock block;
+        ComponentInfo &info = block.Info;
+        HSaveError err = ReadComponentInfo(in, hlp, info);
+        const bool is_delta_base = err && (info.Name == DeltaBaseTag);
+        if (err && !is_delta_base)
+            err = FindComponentHandler(hlp, info, block.Handler);
+        if (err && block.Handler && !(prescan ? block.Handler->Prescan : block.Handler->Unserialize))
+            block.Handler = nullptr;
+        if (err && ((block.Handler && load_data) || is_delta_base))
+        {
+            const auto *handler = block.Handler;
+            if (handler && (info.Version > handler->Version || info.Version < handler->LowestVersion))
+                err = new SavegameError(kSvgErr_UnsupportedComponentVersion, String::FromFormat("Saved version: %d, supported: %d - %d", info.Version, handler->LowestVersion, handler->Version));
+            else
+                block.Data.resize(info.DataSize);
+            if (err && in->Read(block.Data.data(), info.DataSize) != info.DataSize)
+                err = new SavegameError(kSvgErr_ComponentSizeMismatch, String::FromFormat("Expected: %jd, reached end of stream.",
+                    static_cast<intmax_t>(info.DataSize)));
+        }
+        else if (err)
+        {
+            in->Seek(info.DataSize);
+        }
+        if (err && !AssertFormatTag(in, info.Name, false))
+            err = new SavegameError(kSvgErr_ComponentClosingTagFormat);
+        if (!err)
+        {
+            return new SavegameError(kSvgErr_ComponentUnserialization,
+                String::FromFormat("(#%zu) %s, version %i, at offset %u.",
+                blocks.size(), info.Name.IsEmpty() ? "unknown" : info.Name.GetCStr(), info.Version, info.TagOffset),
+                err);
+        }
+        blocks.push_back(std::move(block));
+    }
+    while (!in->EOS());
+    return new SavegameError(kSvgErr_ComponentListClosingTagMissing);
+}
+
+// Decompresses the component's data in place
+static void DecompressComponent(ComponentBlock &block)
+{
+    const auto &info = block.Info;
+    std::vector<uint8_t> uncomp_data(info.UncompressedDataSize);
+    DeflateStream deflate_s(std::make_unique<MemoryStream>(block.Data.data(), block.Data.size()),
+        0, block.Data.size());
+    const size_t uncomp_data_sz = deflate_s.Read(uncomp_data.data(), uncomp_data.size());
+    if (uncomp_data_sz != info.UncompressedDataSize)
+    {
+        block.Error = new SavegameError(kSvgErr_ComponentUncompressedSizeMismatch,
+            String::FromFormat("Expected: %u, actual: %zu", info.UncompressedDataSize, uncomp_data_sz));
+        return;
+    }
+    block.Data = std::move(uncomp_data);
+}
+
+// Decompresses all the compressed components, distributing them among worker threads
+static void DecompressComponents(std::vector<ComponentBlock> &blocks)
+{
+    std::vector<ComponentBlock*> work;
+    for (auto &block : blocks)
+    {
+        if (block.Handler && ((block.Info.Flags & kSvgCmp_Deflate) != 0))
+            work.push_back(&block);
+    }
+    if (work.empty())
+        return;
+
+#if !defined(AGS_DISABLE_THREADS)
+    const size_t num_threads = std::min<size_t>(work.size(), std::max(1u, std::thread::hardware_concurrency()));
+    if (num_threads > 1)
+    {
+        // Each worker picks the next block from the common list until none remain
+        std::atomic<size_t> next_block(0u);
+        auto worker = [&work, &next_block]()
+        {
+            for (size_t i = next_block++; i < work.size(); i = next_block++)
+                DecompressComponent(*work[i]);
+        };
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < num_threads - 1; ++i)
+            threads.emplace_back(worker);
+        worker();
+        for (auto &t : threads)
+            t.join();
+        return;
+    }
+#endif
+    for (auto *block : work)
+        DecompressComponent(*block);
+}
+
+// Reads the ID of the base save from the delta base reference component
+static bool ReadDeltaBaseID(ComponentBlock &block, uint32_t &base_id)
+{
+    if ((block.Info.Flags & kSvgCmp_Deflate) != 0)
+    {
+        DecompressComponent(block);
+        block.Info.Flags &= ~kSvgCmp_Deflate;
+    }
+    if (!block.Error || block.Data.size() < sizeof(uint32_t))
+        return false;
+    Stream mem_in(std::make_unique<MemoryStream>(block.Data.data(), block.Data.size()));
+    base_id = mem_in.ReadInt32();
+    return true;
+}
+
+// Opens the given base save file, and indexes its components;
+// fails if the base's ID does not match the one which delta save refers to
+static HSaveError OpenDeltaBaseFile(const String &base_filename, uint32_t base_id, SvgCmpReadHelper &hlp,
+    bool load_data, SavegameSource &src, std::vector<ComponentBlock> &base_blocks)
+{
+    SavegameDescription desc;
+    HSaveError err = OpenSavegame(base_filename, src, desc, kSvgDesc_None);
+    if (!err)
+        return new SavegameError(kSvgErr_DeltaBaseMismatch, String::FromFormat("Failed to open base save: %s.", base_filename.GetCStr()), err);
+    if (src.Version < kSvgVersion_363)
+        return new SavegameError(kSvgErr_DeltaBaseMismatch, String::FromFormat("Unsupported base save version: %d.", src.Version));
+
+    // Base save may be written by a different engine version, so index it using its own version
+    base_blocks.clear();
+    const SavegameVersion delta_version = hlp.Version;
+    hlp.Version = src.Version;
+    err = IndexComponents(src.InputStream.get(), hlp, base_blocks, load_data);
+    hlp.Version = delta_version;
+    if (!err)
+        return new SavegameError(kSvgErr_DeltaBaseMismatch, String::FromFormat("Failed to read base save: %s.", base_filename.GetCStr()), err);
+    uint32_t saved_base_id = 0u;
+    if (base_blocks.empty() || (base_blocks[0].Info.Name != DeltaBaseTag) ||
+        !ReadDeltaBaseID(base_blocks[0], saved_base_id) || (saved_base_id != base_id))
+        return new SavegameError(kSvgErr_DeltaBaseMismatch, String::FromFormat("Base save ID mismatch: %s.", base_filename.GetCStr()));
+    return HSaveError::None();
+}
+
+// Loads the components of a base save which the delta save refers to,
+// and merges them with the delta's components: the components found in delta
+// replace the ones from the base, while keeping the order of the base save.
+// The base save's stream is kept open in the base_src.
+static HSaveError MergeDeltaBase(Stream *in, SvgCmpReadHelper &hlp, std::vector<ComponentBlock> &blocks,
+    bool load_data, SavegameSource &base_src)
+{
+    uint32_t base_id = 0u;
+    if (!ReadDeltaBaseID(blocks[0], base_id))
+        return new SavegameError(kSvgErr_DeltaBaseMismatch, "Invalid base save reference.");
+
+    const String base_filename = GetDeltaSaveBaseFilename(in->GetPath());
+    std::vector<ComponentBlock> base_blocks;
+    HSaveError err = OpenDeltaBaseFile(base_filename, base_id, hlp, load_data, base_src, base_blocks);
+    if (!err)
+    {
+        // The delta save is replaced before its base, so if that save was interrupted,
+        // then the matching base may be found under a temporary name
+        const String tmp_filename = GetSaveTempFilename(base_filename);
+        if (!File::IsFile(tmp_filename))
+            return err;
+        base_src = SavegameSource();
+        if (!OpenDeltaBaseFile(tmp_filename, base_id, hlp, load_data, base_src, base_blocks))
+            return err;
+        Debug::Printf(kDbgMsg_Warn, "Delta save: using the base left by an interrupted save: %s", tmp_filename.GetCStr());
+    }
+
+    std::vector<ComponentBlock> merged;
+    std::vector<bool> delta_used(blocks.size());
+    for (size_t i = 1; i < base_blocks.size(); ++i)
+    {
+        const String &name = base_blocks[i].Info.Name;
+        auto it = std::find_if(blocks.begin() + 1, blocks.end(),
+            [&name](const ComponentBlock &block) { return block.Info.Name == name; });
+        if (it != blocks.end())
+        {
+            delta_used[it - blocks.begin()] = true;
+            merged.push_back(std::move(*it));
+        }
+        else
+        {
+            base_blocks[i].FromBase = true;
+            merged.push_back(std::move(base_blocks[i]));
+        }
+    }
+    for (size_t i = 1; i < blocks.size(); ++i)
+    {
+        if (!delta_used[i])
+            merged.push_back(std::move(blocks[i]));
+    }
+    blocks = std::move(merged);
+    return HSaveError::None();
+}
+
+// Reads all components, first loading them into memory and decompressing
+// in parallel, then unserializing (or prescanning) them one by one in the order
+// of appearance. If the save is a delta save, then its base save is loaded too.
+// This method requires the save format which declares uncompressed data size.
+static HSaveError ReadAllIndexed(Stream *in, SavegameVersion svg_version, SaveCmpSelection select_cmp,
+    const PreservedParams &pp, RestoredData &r_data)
+{
+    const bool prescan = (r_data.Result.RestoreFlags & kSaveRestore_Prescan) != 0;
+    SvgCmpReadHelper hlp(svg_version, select_cmp, pp, r_data);
+    GenerateHandlersMap(hlp.Handlers);
+
+    std::vector<ComponentBlock> blocks;
+    HSaveError err = IndexComponents(in, hlp, blocks);
+    if (!err)
+        return err;
+    if (!blocks.empty() && (blocks[0].Info.Name == DeltaBaseTag))
+    {
+        SavegameSource base_src;
+        err = MergeDeltaBase(in, hlp, blocks, true, base_src);
+        if (!err)
+            return err;
+    }
+
+    DecompressComponents(blocks);
+
+    // Unserialize the components strictly in order
+    for (size_t idx = 0; idx < blocks.size(); ++idx)
+    {
+        auto &block = blocks[idx];
+        const auto &info = block.Info;
+        if (!block.Handler)
+            continue; // skipped
+        err = block.Error;
+        if (err)
+        {
+            Stream mem_in(std::make_unique<MemoryStream>(block.Data.data(), block.Data.size()));
+            auto pfn_read = prescan ? block.Handler->Prescan : block.Handler->Unserialize;
+            err = pfn_read(&mem_in, info.Version, block.Data.size(), hlp.PP, hlp.RData);
+            // Prescan is allowed to stop reading anywhere
+            if (err && !prescan && (static_cast<size_t>(mem_in.GetPosition()) != block.Data.size()))
+                err = new SavegameError(kSvgErr_ComponentSizeMismatch, String::FromFormat("Expected: %zu, actual: %jd",
+                    block.Data.size(), static_cast<intmax_t>(mem_in.GetPosition())));
+        }
+        if (!err)
+        {
+            return new SavegameError(kSvgErr_ComponentUnserialization,
+                String::FromFormat("(#%zu) %s, version %i, at offset %u.",
+                idx, info.Name.GetCStr(), info.Version, info.TagOffset),
+                err);
+        }
+        // Release the data as soon as it's not needed anymore
+        std::vector<uint8_t>().swap(block.Data);
+    }
+    return HSaveError::None();
+}
+
 HSaveError ReadAll(Stream *in, SavegameVersion svg_version, SaveCmpSelection select_cmp,
     const PreservedParams &pp, RestoredData &r_data)
 {
+    // Saves since 3.6.3 have component headers with the uncompressed data size,
+    // which lets decompress their data in advance
+    if (svg_version >= kSvgVersion_363)
+        return ReadAllIndexed(in, svg_version, select_cmp, pp, r_data);
     return ReadAllImpl(in, svg_version, select_cmp, pp, r_data);
 }
 
+// Prescans the components, reading only the list of component headers first,
+// and then streaming the data of those components which have a prescan handler.
+// If the save is a delta save, then the components which are not found in it
+// are prescanned from its base save.
+static HSaveError PrescanIndexed(Stream *in, SavegameVersion svg_version, SaveCmpSelection select_cmp,
+    const PreservedParams &pp, RestoredData &r_data)
+{
+    SvgCmpReadHelper hlp(svg_version, select_cmp, pp, r_data);
+    GenerateHandlersMap(hlp.Handlers);
+
+    std::vector<ComponentBlock> blocks;
+    HSaveError err = IndexComponents(in, hlp, blocks, false);
+    if (!err)
+        return err;
+    SavegameSource base_src;
+    if (!blocks.empty() && (blocks[0].Info.Name == DeltaBaseTag))
+    {
+        err = MergeDeltaBase(in, hlp, blocks, false, base_src);
+        if (!err)
+            return err;
+    }
+
+    for (size_t idx = 0; idx < blocks.size(); ++idx)
+    {
+        const auto &block = blocks[idx];
+        if (!block.Handler)
+            continue; // skipped
+        Stream *block_in = block.FromBase ? base_src.InputStream.get() : in;
+        const SavegameVersion delta_version = hlp.Version;
+        if (block.FromBase)
+            hlp.Version = base_src.Version;
+        block_in->Seek(block.Info.TagOffset, kSeekBegin);
+        ComponentInfo info;
+        err = ReadComponent(block_in, hlp, info);
+        hlp.Version = delta_version;
+        if (!err)
+        {
+            return new SavegameError(kSvgErr_ComponentUnserialization,
+                String::FromFormat("(#%zu) %s, version %i, at offset %u.",
+                idx, block.Info.Name.GetCStr(), block.Info.Version, block.Info.TagOffset),
+                err);
+        }
+    }
+    return HSaveError::None();
+}
+
 HSaveError PrescanAll(Stream *in, SavegameVersion svg_version, SaveCmpSelection select_cmp,
     const PreservedParams &pp, RestoredData &r_data)
 {
     r_data.Result.RestoreFlags = (SaveRestorationFlags)(r_data.Result.RestoreFlags
         | kSaveRestore_Prescan);
+    // Saves since 3.6.3 may be delta saves, which require their base save to be merged in
+    if (svg_version >= kSvgVersion_363)
+        return PrescanIndexed(in, svg_version, select_cmp, pp, r_data);
     return ReadAllImpl(in, svg_version, select_cmp, pp, r_data);
 }
 
-HSaveError WriteComponent(Stream *out, ComponentHandler &hdlr, bool compress)
+// Writes a component's header and data, calling the provided serialization function
+static HSaveError WriteComponentImpl(Stream *out, const String &name, int32_t version, bool compress,
+    std::function<HSaveError(Stream*)> serialize)
 {
     uint32_t flags = kSvgCmp_Deflate * compress;
 
-    WriteFormatTag(out, hdlr.Name, true);
+    WriteFormatTag(out, name, true);
     soff_t header_pos = out->GetPosition();
     out->WriteInt32(0); // header size placeholder
     out->WriteInt32(flags); // flags
-    out->WriteInt32(hdlr.Version);
+    out->WriteInt32(version);
     soff_t data_sz_pos = out->GetPosition();
     out->WriteInt32(0); // component size placeholder
     out->WriteInt32(0); // uncompressed size
@@ -2179,7 +2535,7 @@ HSaveError WriteComponent(Stream *out, ComponentHandler &hdlr, bool compress)
     {
         auto deflate_s = std::make_unique<DeflateStream>(out->ReleaseStreamBase(), kStream_Write);
         auto deflate_out = std::make_unique<Stream>(std::move(deflate_s));
-        HSaveError err = hdlr.Serialize(deflate_out.get());
+        HSaveError err = serialize(deflate_out.get());
         if (!err)
             return err;
 
@@ -2191,7 +2547,7 @@ HSaveError WriteComponent(Stream *out, ComponentHandler &hdlr, bool compress)
     }
     else
     {
-        HSaveError err = hdlr.Serialize(out);
+        HSaveError err = serialize(out);
         if (!err)
             return err;
     }
@@ -2205,10 +2561,15 @@ HSaveError WriteComponent(Stream *out, ComponentHandler &hdlr, bool compress)
     out->WriteInt32(compress ? uncomp_data_sz : (data_end_pos - data_begin_pos)); // uncompressed size
     out->WriteInt32(0); // checksum (?)
     out->Seek(data_end_pos, kSeekBegin);
-    WriteFormatTag(out, hdlr.Name, false);
+    WriteFormatTag(out, name, false);
     return HSaveError::None();
 }
 
+HSaveError WriteComponent(Stream *out, ComponentHandler &hdlr, bool compress)
+{
+    return WriteComponentImpl(out, hdlr.Name, hdlr.Version, compress, hdlr.Serialize);
+}
+
 HSaveError WriteAllCommon(Stream *out, SaveCmpSelection select_cmp, bool compress)
 {
     WriteFormatTag(out, ComponentListTag, true);
@@ -2229,6 +2590,63 @@ HSaveError WriteAllCommon(Stream *out, SaveCmpSelection select_cmp, bool compres
     return HSaveError::None();
 }
 
+HSaveError SnapshotAllCommon(SaveCmpSelection select_cmp, ComponentSnapshots &snapshot)
+{
+    snapshot.clear();
+    for (int type = 0; !ComponentHandlers[type].Name.IsEmpty(); ++type)
+    {
+        if ((ComponentHandlers[type].Selection & select_cmp) == 0)
+            continue; // skip this component
+
+        ComponentSnapshot cmp;
+        cmp.Name = ComponentHandlers[type].Name;
+        cmp.Version = ComponentHandlers[type].Version;
+        Stream mem_out(std::make_unique<VectorStream>(cmp.Data, kStream_Write));
+        HSaveError err = ComponentHandlers[type].Serialize(&mem_out);
+        if (!err)
+        {
+            return new SavegameError(kSvgErr_ComponentSerialization,
+                String::FromFormat("Component: (#%d) %s", type, ComponentHandlers[type].Name.GetCStr()),
+                err);
+        }
+        mem_out.Close();
+        snapshot.push_back(std::move(cmp));
+    }
+    return HSaveError::None();
+}
+
+HSaveError WriteAllSnapshot(Stream *out, const ComponentSnapshots &snapshot, bool compress)
+{
+    WriteFormatTag(out, ComponentListTag, true);
+    for (const auto &cmp : snapshot)
+    {
+        HSaveError err = WriteComponentImpl(out, cmp.Name, cmp.Version, compress,
+            [&cmp](Stream *cmp_out)
+            {
+                cmp_out->Write(cmp.Data.data(), cmp.Data.size());
+                return HSaveError::None();
+            });
+        if (!err)
+        {
+            return new SavegameError(kSvgErr_ComponentSerialization,
+                String::FromFormat("Component: %s", cmp.Name.GetCStr()), err);
+        }
+    }
+    WriteFormatTag(out, ComponentListTag, false);
+    return HSaveError::None();
+}
+
+ComponentSnapshot MakeDeltaBaseSnapshot(uint32_t base_id)
+{
+    ComponentSnapshot cmp;
+    cmp.Name = DeltaBaseTag;
+    cmp.Version = 0;
+    Stream mem_out(std::make_unique<VectorStream>(cmp.Data, kStream_Write));
+    mem_out.WriteInt32(base_id);
+    mem_out.Close();
+    return cmp;
+}
+
 } // namespace SavegameBlocks
 } // namespace Engine
 } // namespace AGS
@@ -14,6 +14,7 @@
 #ifndef __AGS_EE_GAME__SAVEGAMECOMPONENTS_H
 #define __AGS_EE_GAME__SAVEGAMECOMPONENTS_H
 
+#include <vector>
 #include "game/savegame.h"
 #include "util/stream.h"
 
@@ -33,6 +34,15 @@ struct RestoredData;
 
 namespace SavegameComponents
 {
+    // ComponentSnapshot is a single component serialized into memory
+    struct ComponentSnapshot
+    {
+        String               Name;
+        int32_t              Version = 0;
+        std::vector<uint8_t> Data; // uncompressed component data
+    };
+    typedef std::vector<ComponentSnapshot> ComponentSnapshots;
+
     // Reads all available components from the stream
     HSaveError    ReadAll(Stream *in, SavegameVersion svg_version, SaveCmpSelection select_cmp,
         const PreservedParams &pp, RestoredData &r_data);
@@ -42,6 +52,15 @@ namespace SavegameComponents
         const PreservedParams &pp, RestoredData &r_data);
     // Writes a full list of common components to the stream
     HSaveError    WriteAllCommon(Stream *out, SaveCmpSelection select_cmp, bool compress);
+    // Serializes a list of common components into memory buffers
+    HSaveError    SnapshotAllCommon(SaveCmpSelection select_cmp, ComponentSnapshots &snapshot);
+    // Writes previously made components snapshot to the stream, optionally compressing;
+    // this does not access any game state, and may be called from another thread
+    HSaveError    WriteAllSnapshot(Stream *out, const ComponentSnapshots &snapshot, bool compress);
+    // Makes a special component which links a delta save to its base save;
+    // this component is put first in both delta and base saves, and
+    // the base ID must match for the delta to be applied
+    ComponentSnapshot MakeDeltaBaseSnapshot(uint32_t base_id);
 
     // Utility functions for reading and writing legacy interactions,
     // or their "times run" counters separately.
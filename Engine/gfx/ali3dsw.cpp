@@ -36,6 +36,15 @@ using namespace Common;
 
 static uint32_t _trans_alpha_blender32(uint32_t x, uint32_t y, uint32_t n);
 
+// Blenders used when drawing sprites, tracked for the tile compositor
+enum SpriteBlender
+{
+    kSprBlender_None,
+    kSprBlender_Alpha,      // set_alpha_blender
+    kSprBlender_TransAlpha, // _trans_alpha_blender32 with global alpha
+    kSprBlender_Trans       // set_trans_blender with global alpha
+};
+
 
 // ----------------------------------------------------------------------------
 // SDLRendererGraphicsDriver
@@ -578,9 +587,15 @@ void SDLRendererGraphicsDriver::RenderToBackBuffer()
 
 size_t SDLRendererGraphicsDriver::RenderSpriteBatch(const ALSpriteBatch &batch, size_t from, Bitmap *surface, int surf_offx, int surf_offy)
 {
+  const bool use_tiles = _tileCompositor.IsEnabled();
   for (; (from < _spriteList.size()) && (_spriteList[from].node == batch.ID); ++from)
   {
     const auto &sprite = _spriteList[from];
+    // Render events and screen tint work on the whole surface,
+    // so the sprites scheduled earlier must be drawn first
+    if ((sprite.ddb == nullptr) || (sprite.ddb == reinterpret_cast<ALSoftwareBitmap*>(DRAWENTRY_TINT)))
+      _tileCompositor.Flush(surface);
+
     if (sprite.ddb == nullptr)
     {
       if (_spriteEvtCallback)
@@ -609,6 +624,7 @@ size_t SDLRendererGraphicsDriver::RenderSpriteBatch(const ALSpriteBatch &batch,
 
     if (alpha == 0) {} // fully transparent, do nothing
     else if (is_opaque && (native_bmp == surface) && (alpha == 255)) {}
+    else if (use_tiles && AddTiledSprite(surface, native_bmp, drawAtX, drawAtY, alpha, is_opaque, has_alpha)) {}
     else if (is_opaque)
     {
         surface->Blit(native_bmp, 0, 0, drawAtX, drawAtY, native_bmp->GetWidth(), native_bmp->GetHeight());
@@ -632,9 +648,73 @@ size_t SDLRendererGraphicsDriver::RenderSpriteBatch(const ALSpriteBatch &batch,
           alpha);
     }
   }
+  _tileCompositor.Flush(surface);
   return from;
 }
 
+bool SDLRendererGraphicsDriver::AddTiledSprite(Bitmap *surface, const Bitmap *bmp, int x, int y,
+    int alpha, bool is_opaque, bool has_alpha)
+{
+    // Conversion between formats, or drawing the surface's own pixels
+    // cannot be split into tiles; draw the pending sprites before these
+    if ((bmp->GetColorDepth() != surface->GetColorDepth()) ||
+        bmp->IsSameBitmap(surface))
+    {
+        _tileCompositor.Flush(surface);
+        return false;
+    }
+
+    // Choose the same drawing operation and blender as RenderSpriteBatch
+    // and GfxUtil::DrawSpriteWithTransparency would do
+    TileDrawOpKind op_kind;
+    SpriteBlender blender = kSprBlender_None;
+    int blend_alpha = 0;
+    if (is_opaque)
+    {
+        op_kind = kTileOp_Copy;
+    }
+    else if (has_alpha)
+    {
+        op_kind = kTileOp_Blend;
+        blender = (alpha == 255) ? kSprBlender_Alpha : kSprBlender_TransAlpha;
+        blend_alpha = (alpha == 255) ? 0 : alpha;
+    }
+    else if ((alpha < 255) && (surface->GetColorDepth() > 8))
+    {
+        op_kind = kTileOp_Blend;
+        blender = kSprBlender_Trans;
+        blend_alpha = alpha;
+    }
+    else
+    {
+        op_kind = kTileOp_Masked;
+    }
+
+    // Blender is a global state, so the pending sprites which use
+    // a different one must be drawn before changing it
+    if ((op_kind == kTileOp_Blend) &&
+        (!_tileCompositor.HasPendingBlend() || (blender != _tileBlender) || (blend_alpha != _tileBlendAlpha)))
+    {
+        if (_tileCompositor.HasPendingBlend())
+            _tileCompositor.Flush(surface);
+        switch (blender)
+        {
+        case kSprBlender_Alpha:
+            set_alpha_blender(); break;
+        case kSprBlender_TransAlpha:
+            set_blender_mode(nullptr, nullptr, _trans_alpha_blender32, 0, 0, 0, blend_alpha); break;
+        case kSprBlender_Trans:
+            set_trans_blender(0, 0, 0, blend_alpha); break;
+        default: break;
+        }
+        _tileBlender = blender;
+        _tileBlendAlpha = blend_alpha;
+    }
+
+    _tileCompositor.Add(TileDrawOp(bmp, x, y, op_kind));
+    return true;
+}
+
 void SDLRendererGraphicsDriver::BlitToTexture()
 {
     void *pixels = nullptr;
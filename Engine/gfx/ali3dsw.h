@@ -30,6 +30,7 @@
 #include "gfx/ddb.h"
 #include "gfx/gfxdriverfactorybase.h"
 #include "gfx/gfxdriverbase.h"
+#include "gfx/tilecompositor.h"
 
 namespace AGS
 {
@@ -207,6 +208,9 @@ public:
     void RenderSpritesAtScreenResolution(bool /*enabled*/) override { }
     // Enables or disables a smooth sprite scaling mode
     void UseSmoothScaling(bool /*enabled*/) override { }
+    // Sets the number of threads for drawing sprites; when more than one,
+    // sprites are drawn by the tile compositor
+    void SetRenderThreads(int threads) override { _tileCompositor.SetThreadCount(threads); }
     // Tells if driver supports gamma control
     bool SupportsGammaControl() override;
     // Sets gamma level
@@ -322,6 +326,11 @@ private:
     //
     // Renders single sprite batch on the precreated surface
     size_t RenderSpriteBatch(const ALSpriteBatch &batch, size_t from, Common::Bitmap *surface, int surf_offx, int surf_offy);
+    // Schedules sprite for the tiled drawing, if it's supported for this sprite;
+    // otherwise draws all the pending sprites and returns false, telling that
+    // the sprite must be drawn directly
+    bool AddTiledSprite(Common::Bitmap *surface, const Common::Bitmap *bmp, int x, int y,
+        int alpha, bool is_opaque, bool has_alpha);
     // Copy raw screen bitmap pixels to the SDL texture
     void BlitToTexture();
     // Render SDL texture on screen
@@ -361,6 +370,11 @@ private:
     ALSpriteBatches _spriteBatches;
     // List of sprites to render
     std::vector<ALDrawListEntry> _spriteList;
+    // Draws sprites in parallel, if enabled
+    TileCompositor _tileCompositor;
+    // Blender set for the tile compositor's pending sprites
+    int _tileBlender = 0;
+    int _tileBlendAlpha = 0;
 };
 
 
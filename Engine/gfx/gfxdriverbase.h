@@ -366,6 +366,8 @@ public:
     // only plugin handling are allowed to request our mem buffer
     // for compatibility reasons.
     bool UsesMemoryBackBuffer() override { return false; }
+    // Sprites are drawn by GPU, so no render threads are used
+    void SetRenderThreads(int /*threads*/) override { }
 
     ///////////////////////////////////////////////////////
     // Texture management
@@ -165,6 +165,9 @@ public:
     virtual void RenderSpritesAtScreenResolution(bool enabled) = 0;
     // Enables or disables a smooth sprite scaling mode
     virtual void UseSmoothScaling(bool enabled) = 0;
+    // Sets the number of threads which the renderer may use for drawing
+    // sprites, including the calling one; 0 means "use all hardware threads".
+    virtual void SetRenderThreads(int threads) = 0;
     // Tells if driver supports gamma control
     virtual bool SupportsGammaControl() = 0;
     // Sets gamma level
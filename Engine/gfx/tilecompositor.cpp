@@ -0,0 +1,214 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2026 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+#include "gfx/tilecompositor.h"
+#include <algorithm>
+
+namespace AGS
+{
+namespace Engine
+{
+
+using namespace Common;
+
+TileCompositor::~TileCompositor()
+{
+#if !defined(AGS_DISABLE_THREADS)
+    StopWorkers();
+#endif
+}
+
+void TileCompositor::SetThreadCount(int threads)
+{
+#if !defined(AGS_DISABLE_THREADS)
+    if (threads <= 0)
+        threads = static_cast<int>(std::thread::hardware_concurrency());
+    threads = std::max(1, threads);
+    if (threads == _threadCount)
+        return;
+    StopWorkers();
+    _threadCount = threads;
+    if (_threadCount > 1)
+        StartWorkers(_threadCount - 1);
+#else
+    (void)threads;
+#endif
+}
+
+void TileCompositor::Add(const TileDrawOp &op)
+{
+    _ops.push_back(op);
+    _pendingBlend |= (op.Kind == kTileOp_Blend);
+}
+
+void TileCompositor::Flush(Bitmap *surface)
+{
+    if (_ops.empty())
+        return;
+
+    const Rect clip = surface->GetClip();
+    const size_t work_pixels = IsEnabled() ? BinOps(clip) : 0u;
+    if ((work_pixels < static_cast<size_t>(MinParallelPixels)) || (_activeTiles.size() < 2))
+    {
+        // Not worth splitting, draw everything right away
+        for (const auto &op : _ops)
+            DrawOp(surface, op);
+    }
+#if !defined(AGS_DISABLE_THREADS)
+    else
+    {
+        // Sub-bitmaps are created on this thread, as Allegro's bitmap
+        // management is not meant to be used concurrently
+        _views.resize(_threadCount);
+        for (auto &view : _views)
+            view.reset(new Bitmap(surface, RectWH(surface->GetSize())));
+
+        {
+            std::lock_guard<std::mutex> lk(_mutex);
+            _nextTile = 0u;
+            _busyWorkers = static_cast<int>(_workers.size());
+            ++_jobID;
+        }
+        _cvWork.notify_all();
+        DrawTiles(0);
+        {
+            std::unique_lock<std::mutex> lk(_mutex);
+            _cvDone.wait(lk, [this]() { return _busyWorkers == 0; });
+        }
+
+        for (auto &view : _views)
+            view.reset();
+    }
+#endif
+
+    _ops.clear();
+    _pendingBlend = false;
+}
+
+void TileCompositor::DrawOp(Bitmap *surface, const TileDrawOp &op)
+{
+    switch (op.Kind)
+    {
+    case kTileOp_Copy:
+        surface->Blit(op.Src, 0, 0, op.X, op.Y, op.Src->GetWidth(), op.Src->GetHeight());
+        break;
+    case kTileOp_Masked:
+        surface->Blit(op.Src, op.X, op.Y, kBitmap_Transparency);
+        break;
+    case kTileOp_Blend:
+        surface->TransBlendBlt(op.Src, op.X, op.Y);
+        break;
+    }
+}
+
+size_t TileCompositor::BinOps(const Rect &clip)
+{
+    for (auto tile : _activeTiles)
+        _tileOps[tile].clear();
+    _activeTiles.clear();
+    if (clip.IsEmpty())
+        return 0u;
+
+    _gridRect = clip;
+    _gridCols = (clip.GetWidth() + TileSize - 1) / TileSize;
+    const int grid_rows = (clip.GetHeight() + TileSize - 1) / TileSize;
+    if (_tileOps.size() < static_cast<size_t>(_gridCols * grid_rows))
+        _tileOps.resize(_gridCols * grid_rows);
+
+    size_t work_pixels = 0u;
+    for (size_t i = 0; i < _ops.size(); ++i)
+    {
+        const auto &op = _ops[i];
+        const Rect rc = IntersectRects(RectWH(op.X, op.Y, op.Src->GetWidth(), op.Src->GetHeight()), clip);
+        if (rc.IsEmpty())
+            continue;
+        work_pixels += static_cast<size_t>(rc.GetWidth()) * rc.GetHeight();
+        const int col_first = (rc.Left - clip.Left) / TileSize;
+        const int col_last = (rc.Right - clip.Left) / TileSize;
+        const int row_first = (rc.Top - clip.Top) / TileSize;
+        const int row_last = (rc.Bottom - clip.Top) / TileSize;
+        for (int row = row_first; row <= row_last; ++row)
+        {
+            for (int col = col_first; col <= col_last; ++col)
+            {
+                const uint32_t tile = row * _gridCols + col;
+                if (_tileOps[tile].empty())
+                    _activeTiles.push_back(tile);
+                _tileOps[tile].push_back(static_cast<uint32_t>(i));
+            }
+        }
+    }
+    return work_pixels;
+}
+
+void TileCompositor::DrawTiles(size_t view_index)
+{
+#if !defined(AGS_DISABLE_THREADS)
+    Bitmap *view = _views[view_index].get();
+    for (size_t next = _nextTile++; next < _activeTiles.size(); next = _nextTile++)
+    {
+        const uint32_t tile = _activeTiles[next];
+        const int x = _gridRect.Left + (tile % _gridCols) * TileSize;
+        const int y = _gridRect.Top + (tile / _gridCols) * TileSize;
+        view->SetClip(IntersectRects(RectWH(x, y, TileSize, TileSize), _gridRect));
+        for (auto op_index : _tileOps[tile])
+            DrawOp(view, _ops[op_index]);
+    }
+#else
+    (void)view_index;
+#endif
+}
+
+#if !defined(AGS_DISABLE_THREADS)
+void TileCompositor::StartWorkers(int count)
+{
+    _quit = false;
+    for (int i = 0; i < count; ++i)
+        _workers.emplace_back(&TileCompositor::WorkerProc, this, static_cast<size_t>(i + 1), _jobID);
+}
+
+void TileCompositor::StopWorkers()
+{
+    {
+        std::lock_guard<std::mutex> lk(_mutex);
+        _quit = true;
+    }
+    _cvWork.notify_all();
+    for (auto &t : _workers)
+        t.join();
+    _workers.clear();
+}
+
+void TileCompositor::WorkerProc(size_t view_index, uint32_t last_job)
+{
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lk(_mutex);
+            _cvWork.wait(lk, [this, last_job]() { return _quit || (_jobID != last_job); });
+            if (_quit)
+                return;
+            last_job = _jobID;
+        }
+        DrawTiles(view_index);
+        {
+            std::lock_guard<std::mutex> lk(_mutex);
+            if (--_busyWorkers == 0)
+                _cvDone.notify_one();
+        }
+    }
+}
+#endif
+
+} // namespace Engine
+} // namespace AGS
@@ -0,0 +1,139 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2026 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+//
+// TileCompositor draws a list of sprites onto a surface split into square
+// tiles, which are rendered in parallel on a pool of worker threads.
+//
+// Every sprite is binned into the tiles it overlaps, and each tile draws
+// its sprites in the order they were added, clipped to the tile's rectangle.
+// Since every supported operation calculates a destination pixel only from
+// the corresponding source and destination pixels, the result is exactly
+// same as if the sprites were drawn one by one on the whole surface.
+//
+// Operations which use blending rely on the current Allegro's blender
+// settings; these are global, so the caller must set them up before adding
+// blended sprites, and not change them until the pending list is flushed.
+//
+//=============================================================================
+#ifndef __AGS_EE_GFX__TILECOMPOSITOR_H
+#define __AGS_EE_GFX__TILECOMPOSITOR_H
+
+#include <memory>
+#include <vector>
+#if !defined(AGS_DISABLE_THREADS)
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+#include "gfx/bitmap.h"
+
+namespace AGS
+{
+namespace Engine
+{
+
+using Common::Bitmap;
+
+enum TileDrawOpKind
+{
+    kTileOp_Copy,   // plain blit
+    kTileOp_Masked, // blit skipping the mask color pixels
+    kTileOp_Blend   // draw using current blender
+};
+
+struct TileDrawOp
+{
+    const Bitmap *Src = nullptr;
+    int X = 0;
+    int Y = 0;
+    TileDrawOpKind Kind = kTileOp_Copy;
+
+    TileDrawOp() = default;
+    TileDrawOp(const Bitmap *src, int x, int y, TileDrawOpKind kind)
+        : Src(src), X(x), Y(y), Kind(kind) {}
+};
+
+class TileCompositor
+{
+public:
+    // Width and height of a single tile, in pixels
+    static const int TileSize = 64;
+    // Minimal total area of the pending sprites, for which the drawing
+    // is split among threads
+    static const int MinParallelPixels = 128 * 128;
+
+    TileCompositor() = default;
+    ~TileCompositor();
+
+    // Sets the number of threads used for drawing, including the calling one:
+    // 0 stands for the number of hardware threads, and 1 disables compositor.
+    void SetThreadCount(int threads);
+    // Tells if the compositor is going to draw in parallel
+    bool IsEnabled() const { return _threadCount > 1; }
+    // Tells if there are any sprites waiting to be drawn
+    bool HasPending() const { return !_ops.empty(); }
+    // Tells if there are any pending sprites which use the blender
+    bool HasPendingBlend() const { return _pendingBlend; }
+    // Schedules the sprite for drawing; the sprite's color depth must match
+    // the surface's, and it must not share pixels with the surface
+    void Add(const TileDrawOp &op);
+    // Draws all the pending sprites on the surface, and clears the list
+    void Flush(Bitmap *surface);
+
+private:
+    // Draws the given operation on the surface, respecting surface's clip
+    static void DrawOp(Bitmap *surface, const TileDrawOp &op);
+    // Bins pending operations into tiles covering the surface's clip rect;
+    // returns the total area covered by the sprites
+    size_t BinOps(const Rect &clip);
+    // Draws the binned tiles, taking them one by one until none are left;
+    // run simultaneously by all the threads, each using its own view
+    void DrawTiles(size_t view_index);
+#if !defined(AGS_DISABLE_THREADS)
+    void StartWorkers(int count);
+    void StopWorkers();
+    void WorkerProc(size_t view_index, uint32_t last_job);
+#endif
+
+    int _threadCount = 1;
+    // Pending operations
+    std::vector<TileDrawOp> _ops;
+    bool _pendingBlend = false;
+    // Tile grid, covering the clip rect of the current surface
+    Rect _gridRect;
+    int _gridCols = 0;
+    // Indexes of operations per each tile, and the list of non-empty tiles
+    std::vector<std::vector<uint32_t>> _tileOps;
+    std::vector<uint32_t> _activeTiles;
+    // Per-thread sub-bitmaps of the current surface, each is clipped
+    // to the tile being drawn by the respective thread
+    std::vector<std::unique_ptr<Bitmap>> _views;
+
+#if !defined(AGS_DISABLE_THREADS)
+    std::vector<std::thread> _workers;
+    std::mutex _mutex;
+    std::condition_variable _cvWork;
+    std::condition_variable _cvDone;
+    uint32_t _jobID = 0u;
+    int _busyWorkers = 0;
+    bool _quit = false;
+    std::atomic<size_t> _nextTile{0u};
+#endif
+};
+
+} // namespace Engine
+} // namespace AGS
+
+#endif // __AGS_EE_GFX__TILECOMPOSITOR_H
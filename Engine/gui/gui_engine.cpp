@@ -123,13 +123,13 @@ void GUIObject::MarkChanged()
 {
     _hasChanged = true;
     if (_parentID >= 0)
-        guis[_parentID].MarkControlChanged();
+        guis[_parentID].MarkControlChanged(_id);
 }
 
 void GUIObject::MarkParentChanged()
 {
     if (_parentID >= 0)
-        guis[_parentID].MarkControlChanged();
+        guis[_parentID].MarkControlChanged(_id);
 }
 
 void GUIObject::MarkPositionChanged(bool self_changed)
@@ -406,6 +406,9 @@ void load_common_config(const ConfigTree &cfg, GameConfig &setup)
     setup.RenderAtScreenRes = CfgReadBoolInt(cfg, "graphics", "render_at_screenres");
     setup.AntialiasSprites = CfgReadBoolInt(cfg, "graphics", "antialias", setup.AntialiasSprites);
     setup.SoftwareRenderDriver = CfgReadString(cfg, "graphics", "software_driver");
+    setup.RenderThreads = std::max(0, CfgReadInt(cfg, "graphics", "render_threads", setup.RenderThreads));
+    setup.FrameSpinTime = std::max(0, CfgReadInt(cfg, "graphics", "frame_spin_time", setup.FrameSpinTime));
+    setup.FrameSkip = CfgReadBoolInt(cfg, "graphics", "frame_skip", setup.FrameSkip);
 
     String rotation_str = CfgReadString(cfg, "graphics", "rotation", "unlocked");
     setup.Rotation = StrUtil::ParseEnum<ScreenRotation>(
@@ -451,13 +454,27 @@ void load_common_config(const ConfigTree &cfg, GameConfig &setup)
     setup.SoundLoadAtOnceSize = std::min<uint64_t>(
         CfgReadUInt64(cfg, "sound", "stream_threshold", setup.SoundLoadAtOnceSize),
         SIZE_MAX / 1024);
+    setup.SoundPCMCacheSize = std::min<uint64_t>(
+        CfgReadUInt64(cfg, "sound", "pcm_cache_size", setup.SoundPCMCacheSize),
+        SIZE_MAX / 1024);
+    setup.SoundPCMMaxDuration = std::max(0,
+        CfgReadInt(cfg, "sound", "pcm_max_duration", setup.SoundPCMMaxDuration));
 
     // Various system options
     setup.LoadLatestSave = CfgReadBoolInt(cfg, "misc", "load_latest_save", setup.LoadLatestSave);
     setup.CompressSaves = CfgReadBoolInt(cfg, "misc", "compress_saves", setup.CompressSaves);
+    setup.BackgroundSaves = CfgReadBoolInt(cfg, "misc", "background_save", setup.BackgroundSaves);
+    setup.DeltaSaves = CfgReadBoolInt(cfg, "misc", "delta_save", setup.DeltaSaves);
     setup.RunInBackground = CfgReadInt(cfg, "misc", "background", 0) != 0;
     setup.ShowFps = CfgReadBoolInt(cfg, "misc", "show_fps");
+    setup.ScriptFrameBudget = std::max(0, CfgReadInt(cfg, "misc", "script_frame_budget", setup.ScriptFrameBudget));
     setup.ClearCacheOnRoomChange = CfgReadBoolInt(cfg, "misc", "clear_cache_on_room_change", setup.ClearCacheOnRoomChange);
+    setup.RoomPreload = StrUtil::ParseEnum<RoomPreloadPolicy>(
+        CfgReadString(cfg, "misc", "room_preload", "off"),
+        CstrArr<kNumRoomPreloadPolicies>{ "off", "exits", "edges" }, setup.RoomPreload);
+    setup.RoomPreloadCount = CfgReadInt(cfg, "misc", "room_preload_count", setup.RoomPreloadCount);
+    if (setup.RoomPreloadCount < 1)
+        setup.RoomPreloadCount = 1;
 
     // Accessibility settings
     setup.Access.SpeechSkipStyle = parse_speechskip_style(CfgReadString(cfg, "access", "speechskip"));
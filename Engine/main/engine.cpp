@@ -20,7 +20,11 @@
 
 #include <errno.h>
 #include <stdio.h>
+#include <functional>
 #include <stdexcept>
+#if !defined(AGS_DISABLE_THREADS)
+#include <thread>
+#endif
 #if AGS_PLATFORM_OS_WINDOWS
 #include <process.h>  // _spawnl
 #endif
@@ -43,6 +47,7 @@
 #include "ac/path_helper.h"
 #include "ac/route_finder.h"
 #include "ac/sys_events.h"
+#include "ac/timer.h"
 #include "ac/roomstatus.h"
 #include "ac/speech.h"
 #include "ac/spritecache.h"
@@ -51,9 +56,11 @@
 #include "ac/dynobj/scriptobject.h"
 #include "ac/dynobj/scriptsystem.h"
 #include "data/assetmanager.h"
+#include "data/tra_file.h"
 #include "debug/debug_log.h"
 #include "debug/debugger.h"
 #include "debug/out.h"
+#include "debug/profiler.h"
 #include "device/mousew32.h"
 #include "font/agsfontrenderer.h"
 #include "font/fonts.h"
@@ -73,11 +80,13 @@
 #include "media/audio/audio_core.h"
 #include "platform/base/sys_main.h"
 #include "platform/base/agsplatformdriver.h"
+#include "script/script.h"
 #include "script/script_runtime.h"
 #include "util/directory.h"
 #include "util/error.h"
 #include "util/path.h"
 #include "util/string_utils.h"
+#include "util/time_util.h"
 
 using namespace AGS::Common;
 using namespace AGS::Engine;
@@ -103,6 +112,88 @@ ResourcePaths ResPaths;
 
 t_engine_pre_init_callback engine_pre_init_callback = nullptr;
 
+// StartupTask runs one of the engine initialization stages on a separate
+// thread, while the main thread proceeds with the other stages.
+// The task's results must not be accessed before Wait() is called.
+class StartupTask
+{
+public:
+    ~StartupTask() { Wait(); }
+
+    bool IsStarted() const { return _started; }
+
+    // Starts the task; the given name must be a static string
+    void Run(const char *name, std::function<void()> &&fn)
+    {
+        Wait();
+        _name = name;
+        _fn = std::move(fn);
+        _started = true;
+#if !defined(AGS_DISABLE_THREADS)
+        _thread = std::thread(&StartupTask::Execute, this);
+#else
+        Execute();
+#endif
+    }
+
+    // Waits for the task to complete, if it was started
+    void Wait()
+    {
+        if (!_started)
+            return;
+        Stopwatch sw;
+#if !defined(AGS_DISABLE_THREADS)
+        _thread.join();
+#endif
+        _started = false;
+        _fn = nullptr;
+        Debug::Printf(kDbgMsg_Info, "Startup stage '%s' took %.2f ms (waited for %.2f ms)",
+            _name, ToMillisecondsF(_duration), ToMillisecondsF(sw.Check()));
+    }
+
+private:
+    void Execute()
+    {
+        AGS_PROFILE_ZONE(_name);
+        Stopwatch sw;
+        _fn();
+        _duration = sw.Check();
+    }
+
+    const char *_name = "";
+    std::function<void()> _fn;
+    bool _started = false;
+    Stopwatch::Duration _duration {};
+#if !defined(AGS_DISABLE_THREADS)
+    std::thread _thread;
+#endif
+};
+
+// Audio system initialization, run in parallel with the game data loading
+static StartupTask AudioInitTask;
+// Sprite index, read in parallel with the gfx mode init
+static struct
+{
+    StartupTask Task;
+    std::unique_ptr<Stream> SpriteIn, IndexIn;
+    SpriteFile File;
+    std::vector<Size> Metrics;
+    HError Result = HError::None();
+} SpriteIndexPreload;
+// Translation file, read in parallel with the game data loading
+static struct
+{
+    StartupTask Task;
+    std::unique_ptr<Stream> In;
+    Translation Data;
+    HError Result = HError::None();
+} TranslationPreload;
+
+static void log_startup_stage(const char *name, const Stopwatch &sw)
+{
+    Debug::Printf(kDbgMsg_Info, "Startup stage '%s' took %.2f ms", name, ToMillisecondsF(sw.Check()));
+}
+
 bool engine_init_backend()
 {
     set_our_eip(-199);
@@ -412,7 +503,8 @@ void engine_init_audio()
     
     if (usetup.AudioEnabled)
     {
-        soundcache_set_rules(usetup.SoundLoadAtOnceSize * 1024, usetup.SoundCacheSize * 1024);
+        soundcache_set_rules(usetup.SoundLoadAtOnceSize * 1024, usetup.SoundCacheSize * 1024,
+            usetup.SoundPCMMaxDuration, usetup.SoundPCMCacheSize * 1024);
     }
     else
     {
@@ -425,7 +517,7 @@ void engine_init_debug()
 {
     if (usetup.ShowFps)
         display_fps = kFPS_Forced;
-    if ((debug_flags & (~(DBG_DEBUGMODE | DBG_DBGSCRIPT))) > 0)
+    if ((debug_flags & (~(DBG_DEBUGMODE | DBG_DBGSCRIPT | DBG_GUIDAMAGE))) > 0)
     {
         platform->DisplayAlert("Engine debugging mode enabled.\n"
             "\nNOTE: You have selected to enable one or more engine debugging options. "
@@ -592,21 +684,68 @@ void show_preload()
     }
 }
 
+// Returns the location of the sprite index cache, which is used if the game
+// does not have a valid sprite index file. The game data must be loaded,
+// as the location depends on the game's folder name; the cache file is also
+// named after the game ID, in case the folder is shared with other games.
+static String get_sprite_index_cache_path()
+{
+    return PreparePathForWriting(GetGameUserDataDir(),
+        String::FromFormat("sprindex_%08x.cache", static_cast<uint32_t>(game.uniqueid)));
+}
+
+// Opens the sprite file and begins reading sprite index on a separate thread;
+// the results are picked up by engine_init_sprites()
+static void engine_start_sprite_index_preload()
+{
+    // NOTE: streams are opened on the main thread, because asset manager is not thread-safe
+    SpriteIndexPreload.SpriteIn = AssetMgr->OpenAsset(SpriteFile::DefaultSpriteFileName);
+    if (!SpriteIndexPreload.SpriteIn)
+        return; // let engine_init_sprites() report the error
+    SpriteIndexPreload.IndexIn = AssetMgr->OpenAsset(SpriteFile::DefaultSpriteIndexName);
+    SpriteIndexPreload.File.SetIndexCacheFile(get_sprite_index_cache_path());
+    SpriteIndexPreload.Task.Run("sprite index", []()
+    {
+        SpriteIndexPreload.Result = SpriteIndexPreload.File.OpenFile(
+            std::move(SpriteIndexPreload.SpriteIn), std::move(SpriteIndexPreload.IndexIn),
+            SpriteIndexPreload.Metrics);
+    });
+}
+
 HError engine_init_sprites()
 {
     spriteset.Reset();
     Debug::Printf(kDbgMsg_Info, "Initialize sprites");
-    auto sprite_file = AssetMgr->OpenAsset(SpriteFile::DefaultSpriteFileName);
-    if (!sprite_file)
+    if (SpriteIndexPreload.Task.IsStarted())
     {
-        return new Error(String::FromFormat("Failed to open spriteset file '%s'.",
-            SpriteFile::DefaultSpriteFileName.GetCStr()));
+        SpriteIndexPreload.Task.Wait();
+        HError err = SpriteIndexPreload.Result;
+        if (err)
+            spriteset.InitFile(std::move(SpriteIndexPreload.File), SpriteIndexPreload.Metrics);
+        SpriteIndexPreload.File = SpriteFile();
+        SpriteIndexPreload.Metrics = std::vector<Size>();
+        SpriteIndexPreload.Result = HError::None();
+        if (!err)
+            return err;
     }
-    auto index_file = AssetMgr->OpenAsset(SpriteFile::DefaultSpriteIndexName);
-    HError err = spriteset.InitFile(std::move(sprite_file), std::move(index_file));
-    if (!err)
+    else
     {
-        return err;
+        auto sprite_file = AssetMgr->OpenAsset(SpriteFile::DefaultSpriteFileName);
+        if (!sprite_file)
+        {
+            return new Error(String::FromFormat("Failed to open spriteset file '%s'.",
+                SpriteFile::DefaultSpriteFileName.GetCStr()));
+        }
+        auto index_file = AssetMgr->OpenAsset(SpriteFile::DefaultSpriteIndexName);
+        SpriteFile file;
+        std::vector<Size> metrics;
+        file.SetIndexCacheFile(get_sprite_index_cache_path());
+        HError err = file.OpenFile(std::move(sprite_file), std::move(index_file), metrics);
+        if (!err)
+        {
+            return err;
+        }
+        spriteset.InitFile(std::move(file), metrics);
     }
 
     const char *compress_desc = StrUtil::SelectCStr<kNumSprCompressTypes>(
@@ -620,6 +759,47 @@ HError engine_init_sprites()
     return HError::None();
 }
 
+// Opens the configured translation and begins reading it on a separate thread;
+// the results are picked up by engine_finish_translation_preload()
+static void engine_start_translation_preload()
+{
+    if (usetup.Translation.IsEmpty())
+        return;
+    TranslationPreload.In = AssetMgr->OpenAsset(String::FromFormat("%s.tra", usetup.Translation.GetCStr()));
+    if (!TranslationPreload.In)
+        return; // let init_translation() report the error
+    TranslationPreload.Task.Run("translation", []()
+    {
+        TranslationPreload.Result = ReadTraData(TranslationPreload.Data, std::move(TranslationPreload.In));
+    });
+}
+
+// Passes the preloaded translation to be used when the game's translation is set;
+// if reading failed, then the translation will be read again and report the error
+static void engine_finish_translation_preload()
+{
+    if (!TranslationPreload.Task.IsStarted())
+        return;
+    TranslationPreload.Task.Wait();
+    if (TranslationPreload.Result)
+        set_preloaded_translation(usetup.Translation, std::move(TranslationPreload.Data));
+    TranslationPreload.Data = Translation();
+    TranslationPreload.Result = HError::None();
+}
+
+void engine_wait_audio_init()
+{
+    AudioInitTask.Wait();
+}
+
+// Waits for all the startup tasks to complete
+static void engine_wait_startup_tasks()
+{
+    AudioInitTask.Wait();
+    SpriteIndexPreload.Task.Wait();
+    TranslationPreload.Task.Wait();
+}
+
 // TODO: this should not be a part of "engine_" function group,
 // move this elsewhere (InitGameState?).
 void engine_init_game_settings()
@@ -923,6 +1103,9 @@ void engine_prepare_to_start_game()
 
     engine_setup_scsystem_auxiliary();
 
+    setFramePacing(usetup.FrameSpinTime, usetup.FrameSkip);
+    SetScriptRepExecBudget(usetup.ScriptFrameBudget);
+
     if (usetup.LoadLatestSave)
     {
         int slot = GetLastSaveSlot();
@@ -1218,6 +1401,14 @@ void engine_init_editor_debugging(const ConfigTree &cfg)
 // data init into either InitGameState() or other game method as appropriate.
 int initialize_engine(const ConfigTree &startup_opts)
 {
+    // Make sure that no startup tasks are left running, whatever way we leave this function
+    struct StartupTasksWaiter
+    {
+        ~StartupTasksWaiter() { engine_wait_startup_tasks(); }
+    } tasks_waiter;
+    Stopwatch startup_sw;
+    AGS_PROFILE_THREAD("Main");
+
     if (engine_pre_init_callback) {
         engine_pre_init_callback();
     }
@@ -1285,6 +1476,9 @@ int initialize_engine(const ConfigTree &startup_opts)
 
     engine_assign_assetpaths();
 
+    // Begin reading the data which does not depend on the game's setup
+    engine_start_translation_preload();
+
     //-----------------------------------------------------
     // Begin setting up systems
 
@@ -1302,7 +1496,8 @@ int initialize_engine(const ConfigTree &startup_opts)
 
     set_our_eip(-198);
 
-    engine_init_audio();
+    // NOTE: audio init is waited for prior to plugins startup and gfx mode init
+    AudioInitTask.Run("audio", engine_init_audio);
 
     set_our_eip(-199);
 
@@ -1315,9 +1510,14 @@ int initialize_engine(const ConfigTree &startup_opts)
     set_our_eip(-20);
     set_our_eip(-19);
 
+    Stopwatch stage_sw;
     int res = engine_load_game_data();
     if (res != 0)
         return res;
+    log_startup_stage("game data", stage_sw);
+
+    // Begin reading sprite index, now that its cache location is known
+    engine_start_sprite_index_preload();
 
     set_our_eip(-189);
 
@@ -1336,9 +1536,13 @@ int initialize_engine(const ConfigTree &startup_opts)
 
     engine_adjust_for_rotation_settings();
 
-    // Attempt to initialize graphics mode
+    // Attempt to initialize graphics mode;
+    // NOTE: SDL subsystems must not be initialized concurrently
+    engine_wait_audio_init();
+    stage_sw.Start();
     if (!engine_try_set_gfxmode_any(usetup.Display))
         return EXIT_ERROR;
+    log_startup_stage("graphics mode", stage_sw);
 
     // Configure game window after renderer was initialized
     engine_setup_window();
@@ -1348,19 +1552,25 @@ int initialize_engine(const ConfigTree &startup_opts)
     sys_window_show_cursor(false); // hide the system cursor
 
     show_preload();
+    stage_sw.Start();
     HError err = engine_init_sprites();
     if (!err)
     {
         platform->DisplayAlert("Could not load sprite set file:\n%s", err->FullMessage().GetCStr());
         return EXIT_ERROR;
     }
+    log_startup_stage("sprites", stage_sw);
 
     if ((debug_flags & DBG_DBGSCRIPT) != 0)
         ccSetDebugLogging(true);
 
     // TODO: move *init_game_settings to game init code unit
+    engine_finish_translation_preload();
+    stage_sw.Start();
     engine_init_game_settings();
+    log_startup_stage("game settings", stage_sw);
     engine_prepare_to_start_game();
+    log_startup_stage("engine startup (total)", startup_sw);
 
     initialize_start_and_play_game(override_start_room, loadSaveGameOnStartup);
 
@@ -23,6 +23,8 @@ AGS::Common::String get_engine_version_and_build();
 void        show_preload();
 void        engine_init_game_settings();
 AGS::Common::HError engine_init_sprites();
+// Waits for the audio system initialization, if it is run in the background
+void        engine_wait_audio_init();
 int         initialize_engine(const AGS::Common::ConfigTree &startup_opts);
 
 struct DisplayModeSetup;
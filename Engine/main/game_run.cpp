@@ -51,6 +51,7 @@
 #include "ac/walkbehind.h"
 #include "debug/debugger.h"
 #include "debug/debug_log.h"
+#include "debug/profiler.h"
 #include "device/mousew32.h"
 #include "gui/animatingguibutton.h"
 #include "gui/guiinv.h"
@@ -1219,6 +1220,7 @@ uint32_t get_runtime_ms()
 //
 void UpdateGameOnce(bool do_controls, IDriverDependantBitmap *extra_ddb, int extra_x, int extra_y)
 {
+    AGS_PROFILE_ZONE("UpdateGameOnce");
     set_our_eip(1000);
 
     sys_evt_process_pending();
@@ -1273,6 +1275,8 @@ void UpdateGameOnce(bool do_controls, IDriverDependantBitmap *extra_ddb, int ext
     // do the overall game state update
     GameUpdateGameState();
     GameUpdatePersistentAnimations();
+    // Let the automatic room preloading follow the player's movement
+    update_room_preload();
 
     set_our_eip(1007);
 
@@ -1294,8 +1298,8 @@ void UpdateGameOnce(bool do_controls, IDriverDependantBitmap *extra_ddb, int ext
 
     // Record necessary values for the GUI rendering
     update_gui_context(mwasatx, mwasaty);
-    // Only render if we are not skipping a cutscene
-    if (!play.fast_forward)
+    // Only render if we are not skipping a cutscene, or a frame to catch up
+    if (!play.fast_forward && isFrameRenderDue())
     {
         update_gui_disabled_status(); // in case they changed it in the late script update
         render_graphics(extra_ddb, extra_x, extra_y);
@@ -1303,6 +1307,8 @@ void UpdateGameOnce(bool do_controls, IDriverDependantBitmap *extra_ddb, int ext
 
     set_our_eip(1011);
 
+    // Check if the background save has completed, this may queue an event
+    update_background_save();
     // Then process all the accumulated events for this game tick
     GameUpdateProcessEvents();
 
@@ -189,6 +189,7 @@ void main_print_help() {
            "  --setup                      Run setup application\n"
 #endif
            "  --shared-data-dir DIR        Set the shared game data directory\n"
+           "  --show-gui-damage            Outline parts of GUI redrawn each frame\n"
            "  --startr <room_number>       Start game by loading certain room.\n"
            "  --tell                       Print various information concerning engine\n"
            "                                 and the game; for selected output use:\n"
@@ -356,6 +357,7 @@ static int main_process_cmdline(ConfigTree &cfg, int argc, char *argv[])
         else if (ags_stricmp(arg, "--nomusic") == 0) debug_flags |= DBG_NOMUSIC;
         else if (ags_stricmp(arg, "--noscript") == 0) debug_flags |= DBG_NOSCRIPT;
         else if (ags_stricmp(arg, "--novideo") == 0) debug_flags |= DBG_NOVIDEO;
+        else if (ags_stricmp(arg, "--show-gui-damage") == 0) debug_flags |= DBG_GUIDAMAGE;
         else if (ags_stricmp(arg, "--rotation") == 0 && (argc > ee + 1))
             cfg["graphics"]["rotation"] = argv[++ee];
         else if (ags_strnicmp(arg, "--log-", 6) == 0 && arg[6] != 0)
@@ -26,6 +26,7 @@
 #include "ac/gamestate.h"
 #include "ac/roomstatus.h"
 #include "ac/route_finder.h"
+#include "ac/timer.h"
 #include "ac/translation.h"
 #include "ac/dynobj/dynobj_manager.h"
 #include "debug/agseditordebugger.h"
@@ -33,6 +34,7 @@
 #include "debug/debugger.h"
 #include "debug/out.h"
 #include "font/fonts.h"
+#include "game/savegame.h"
 #include "main/config.h"
 #include "main/engine.h"
 #include "main/main.h"
@@ -195,6 +197,11 @@ void quit(const char *quitmsg)
 
     quit_tell_editor_debugger(errmsg, qreason);
 
+    // Let the pending save complete writing
+    WaitForBackgroundSave();
+
+    printFramePacingStats();
+
     set_our_eip(9900);
 
     quit_stop_cd();
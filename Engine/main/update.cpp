@@ -53,6 +53,7 @@ extern RoomStruct thisroom;
 extern RoomObject*objs;
 extern std::vector<ViewStruct> views;
 extern CharacterInfo*playerchar;
+extern int displayed_room;
 extern CharacterInfo *facetalkchar;
 extern int face_talking,facetalkview,facetalkwait,facetalkframe;
 extern int facetalkloop, facetalkrepeat, facetalkAllowBlink;
@@ -309,10 +310,14 @@ void update_character_move_and_anim(std::vector<int> &followingAsSheep)
 {
 	// move & animate characters
   for (int aa=0;aa<game.numcharacters;aa++) {
-    if (game.chars[aa].on != 1) continue;
-
     CharacterInfo*chi    = &game.chars[aa];
 	CharacterExtras*chex = &charextra[aa];
+    // Skip characters in other rooms which have nothing to update;
+    // games with many characters have most of them elsewhere.
+    // The room is tested first, as it's near the other tested fields,
+    // while "on" is stored at the end of a large struct.
+    if ((chi->room != displayed_room) && !IsCharacterActiveOffRoom(chi, chex)) continue;
+    if (chi->on != 1) continue;
 
 	UpdateCharacterMoveAndAnim(chi, chex, followingAsSheep);
   }
@@ -19,6 +19,7 @@
 #include <thread>
 #include <unordered_map>
 #include "debug/out.h"
+#include "debug/profiler.h"
 #include "media/audio/audioplayer.h"
 #include "media/audio/sdldecoder.h"
 #include "media/audio/openalsource.h"
@@ -113,6 +114,7 @@ void audio_core_shutdown()
 
     // dispose all the active slots
     g_acore.slots_.clear();
+    OpenAlStaticBuffer::DeleteReleased();
 
     // SDL_Sound
     Sound_Quit();
@@ -161,9 +163,20 @@ static int audio_core_slot_init(std::unique_ptr<SDLDecoder> decoder)
     return handle;
 }
 
-int audio_core_slot_init(std::shared_ptr<std::vector<uint8_t>> &data, const String &extension_hint, bool repeat)
+int audio_core_slot_init(std::shared_ptr<std::vector<uint8_t>> &data, const String &extension_hint, bool repeat,
+    std::shared_ptr<SoundPCMData> capture)
 {
     auto decoder = std::make_unique<SDLDecoder>(data, extension_hint, repeat);
+    if (capture)
+        decoder->SetCapture(capture);
+    if (!decoder->Open())
+        return -1;
+    return audio_core_slot_init(std::move(decoder));
+}
+
+int audio_core_slot_init(std::shared_ptr<SoundPCMData> &pcm, bool repeat)
+{
+    auto decoder = std::make_unique<SDLDecoder>(pcm, repeat);
     if (!decoder->Open())
         return -1;
     return audio_core_slot_init(std::move(decoder));
@@ -203,8 +216,10 @@ void audio_core_slot_stop(int slot_handle)
 
 void audio_core_entry_poll()
 {
+    AGS_PROFILE_ZONE("audio_core_entry_poll");
     // burn off any errors for new loop
     dump_al_errors();
+    OpenAlStaticBuffer::DeleteReleased();
 
     for (auto &entry : g_acore.slots_) {
         auto &slot = entry.second;
@@ -220,6 +235,7 @@ void audio_core_entry_poll()
 #if !defined(AGS_DISABLE_THREADS)
 static void audio_core_entry()
 {
+    AGS_PROFILE_THREAD("Audio");
     std::unique_lock<std::mutex> lk(g_acore.mixer_mutex_m);
 
     while (g_acore.audio_core_thread_running) {
@@ -84,7 +84,11 @@ void audio_core_set_master_volume(float newvol);
 //
 // Initializes playback on a free playback slot (reuses spare one or allocates new if there's none).
 // Data array must contain full wave data to play.
-int audio_core_slot_init(std::shared_ptr<std::vector<uint8_t>> &data, const AGS::Common::String &extension_hint, bool repeat);
+// Optional capture object receives the decoded sound, if it fits in its limits.
+int audio_core_slot_init(std::shared_ptr<std::vector<uint8_t>> &data, const AGS::Common::String &extension_hint, bool repeat,
+    std::shared_ptr<AGS::Engine::SoundPCMData> capture = nullptr);
+// Initializes playback of the fully decoded PCM data.
+int audio_core_slot_init(std::shared_ptr<AGS::Engine::SoundPCMData> &pcm, bool repeat);
 // Initializes playback streaming
 int audio_core_slot_init(std::unique_ptr<AGS::Common::Stream> in, const AGS::Common::String &extension_hint, bool repeat);
 // Returns a AudioPlayer from the given slot, wrapped in a auto-locking struct.
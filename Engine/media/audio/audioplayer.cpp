@@ -54,7 +54,7 @@ void AudioPlayer::Poll()
     }
     if (_bufferPending.Data() && (_bufferPending.Size() > 0))
     { // if having a buffer already, then try to put into source
-        if (_source->PutData(_bufferPending) > 0)
+        if (PutPendingData() > 0)
             _bufferPending = SoundBufferPtr(); // clear buffer on success
     }
     _source->Poll();
@@ -65,6 +65,16 @@ void AudioPlayer::Poll()
     }
 }
 
+size_t AudioPlayer::PutPendingData()
+{
+    // The whole decoded sound is queued using a prefilled static buffer
+    const auto &pcm = _decoder->GetPCM();
+    if (pcm && (_bufferPending.Data() == pcm->Data.data()) &&
+        (_bufferPending.Size() == pcm->Data.size()))
+        return _source->PutStaticData(*pcm, _bufferPending.Timestamp());
+    return _source->PutData(_bufferPending);
+}
+
 void AudioPlayer::Play()
 {
     switch (_playState)
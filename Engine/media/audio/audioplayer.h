@@ -72,6 +72,8 @@ public:
 private:
     // Opens decoder and sets up playback state
     void Init();
+    // Passes the pending buffer to the source, returns the accepted size
+    size_t PutPendingData();
 
     const int handle_ = -1; // for diagnostic purposes only
     std::unique_ptr<SDLDecoder> _decoder;
@@ -14,6 +14,7 @@
 #include "media/audio/openalsource.h"
 #include <algorithm>
 #include <cmath>
+#include <mutex>
 #include "debug/out.h"
 
 using namespace AGS::Common;
@@ -88,9 +89,35 @@ static struct
 {
     // A record of available al buffers
     std::vector<ALuint> freeBuffers;
+    // Static buffers which are no longer referenced, and must be deleted;
+    // guarded by its own mutex, as they may be released on any thread
+    std::mutex releasedMutex;
+    std::vector<ALuint> releasedBuffers;
 } g_oalint;
 
 
+//-----------------------------------------------------------------------------
+// OpenAlStaticBuffer
+//-----------------------------------------------------------------------------
+
+OpenAlStaticBuffer::~OpenAlStaticBuffer()
+{
+    std::lock_guard<std::mutex> lk(g_oalint.releasedMutex);
+    g_oalint.releasedBuffers.push_back(_bufID);
+}
+
+void OpenAlStaticBuffer::DeleteReleased()
+{
+    std::lock_guard<std::mutex> lk(g_oalint.releasedMutex);
+    if (g_oalint.releasedBuffers.empty())
+        return;
+    alDeleteBuffers(static_cast<ALsizei>(g_oalint.releasedBuffers.size()),
+        g_oalint.releasedBuffers.data());
+    dump_al_errors();
+    g_oalint.releasedBuffers.clear();
+}
+
+
 //-----------------------------------------------------------------------------
 // OpenAlSource
 //-----------------------------------------------------------------------------
@@ -198,6 +225,41 @@ size_t OpenAlSource::PutData(const SoundBufferPtr &data)
     return data.Size();
 }
 
+size_t OpenAlSource::PutStaticData(SoundPCMData &pcm, float timestamp)
+{
+    // Static buffer is only valid for the normal playback speed,
+    // otherwise queue the data as usual, for the on the go resampling
+    if (_speed != 1.f)
+        return PutData(SoundBufferPtr(pcm.Data.data(), pcm.Data.size(), timestamp));
+
+    Unqueue();
+    // If queue is full, bail out
+    if (_queued >= MaxQueue) { return 0u; }
+    if (pcm.Data.empty()) { return 0u; }
+    if (!pcm.OutputBuffer)
+    { // Convert and upload the sound on the first use
+        size_t conv_sz;
+        const void *conv = _resampler.Convert(pcm.Data.data(), pcm.Data.size(), conv_sz);
+        if (!conv)
+            return PutData(SoundBufferPtr(pcm.Data.data(), pcm.Data.size(), timestamp));
+        ALuint buf_id = 0;
+        alGenBuffers(1, &buf_id);
+        dump_al_errors();
+        alBufferData(buf_id, _alFormat, conv, conv_sz, _recvFmt.rate);
+        dump_al_errors();
+        pcm.OutputBuffer = std::make_shared<OpenAlStaticBuffer>(buf_id);
+    }
+
+    const ALuint buf_id = pcm.OutputBuffer->GetID();
+    const float use_ts = timestamp >= 0.f ? timestamp : _predictTs;
+    alSourceQueueBuffers(_source, 1, &buf_id);
+    dump_al_errors();
+    _queued++;
+    _predictTs = use_ts + pcm.DurationMs;
+    _bufferRecords.push_back(BufferRecord(use_ts, pcm.DurationMs, _speed, pcm.OutputBuffer));
+    return pcm.Data.size();
+}
+
 void OpenAlSource::Unqueue()
 {
     for (;;)
@@ -213,9 +275,9 @@ void OpenAlSource::Unqueue()
 
         _queued--;
         assert(_bufferRecords.size() > 0);
+        if (!_bufferRecords.front().Static)
+            g_oalint.freeBuffers.push_back(buf_id);
         _bufferRecords.pop_front();
-
-        g_oalint.freeBuffers.push_back(buf_id);
     }
 }
 
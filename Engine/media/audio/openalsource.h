@@ -21,6 +21,7 @@
 #ifndef __AGS_EE_MEDIA__OPENALSOURCE_H
 #define __AGS_EE_MEDIA__OPENALSOURCE_H
 #include <deque>
+#include <memory>
 #include "media/audio/audiodefines.h"
 #include "media/audio/openal.h"
 #include "media/audio/sdldecoder.h"
@@ -30,6 +31,29 @@ namespace AGS
 namespace Engine
 {
 
+// OpenAlStaticBuffer is an Al buffer prefilled with a whole sound;
+// it is never refilled, and may be queued to any number of sources at once.
+class OpenAlStaticBuffer
+{
+public:
+    OpenAlStaticBuffer(ALuint buf_id) : _bufID(buf_id) {}
+    // Schedules the Al buffer for deletion, because the last reference
+    // may be released outside of the audio lock (e.g. by a sound cache)
+    ~OpenAlStaticBuffer();
+
+    ALuint GetID() const { return _bufID; }
+
+    // Deletes Al buffers released since the last call;
+    // must be called under the audio lock
+    static void DeleteReleased();
+
+private:
+    OpenAlStaticBuffer(const OpenAlStaticBuffer&) = delete;
+    OpenAlStaticBuffer &operator=(const OpenAlStaticBuffer&) = delete;
+
+    const ALuint _bufID;
+};
+
 class OpenAlSource
 {
 public:
@@ -54,6 +78,10 @@ public:
     // Try putting data into the queue; returns amount of data copied,
     // or 0 if data cannot be accepted at the moment.
     size_t PutData(const SoundBufferPtr &data);
+    // Try putting the whole decoded sound into the queue, using its static
+    // buffer which is prefilled on the first use; returns amount of data
+    // accepted, or 0 if data cannot be accepted at the moment.
+    size_t PutStaticData(SoundPCMData &pcm, float timestamp);
     // Updates the state, processes the sound queue
     ALuint Poll();
 
@@ -97,8 +125,12 @@ private:
         float Timestamp = 0.f;
         float Duration = 0.f;
         float Speed = 0.f; // associated playback speed
+        // static buffer, which must not be returned to the free buffers list
+        std::shared_ptr<OpenAlStaticBuffer> Static;
         BufferRecord() = default;
-        BufferRecord(float ts, float dur, float sp) : Timestamp(ts), Duration(dur), Speed(sp) {}
+        BufferRecord(float ts, float dur, float sp,
+            std::shared_ptr<OpenAlStaticBuffer> static_buf = nullptr)
+            : Timestamp(ts), Duration(dur), Speed(sp), Static(static_buf) {}
     };
     // Playback parameters related to the queued buffers
     std::deque<BufferRecord> _bufferRecords;
@@ -12,6 +12,7 @@
 //
 //=============================================================================
 #include "media/audio/sdldecoder.h"
+#include <algorithm>
 #include "util/sdl2_util.h"
 
 namespace AGS
@@ -73,17 +74,84 @@ SDLDecoder::SDLDecoder(std::unique_ptr<Stream> in,
 {
 }
 
+SDLDecoder::SDLDecoder(std::shared_ptr<SoundPCMData> &pcm, bool repeat)
+    : _pcmData(pcm)
+    , _durationMs(pcm->DurationMs)
+    , _repeat(repeat)
+{
+}
+
 SDLDecoder::SDLDecoder(SDLDecoder &&dec)
 {
     _sampleData = (std::move(dec._sampleData));
+    _pcmData = std::move(dec._pcmData);
+    _capture = std::move(dec._capture);
+    _durationMs = dec._durationMs;
     _rwops = std::move(dec._rwops);
     dec._rwops = nullptr;
     _sampleExt = std::move(dec._sampleExt);
     _repeat = dec._repeat;
 }
 
+SDLDecoder::~SDLDecoder()
+{
+    // Decoder was destroyed before finishing the sound, so allow to retry later
+    EndCapture(SoundPCMData::kPCM_Cancelled);
+}
+
+void SDLDecoder::SetCapture(std::shared_ptr<SoundPCMData> pcm)
+{
+    assert(!_sample && !_pcmData);
+    _capture = pcm;
+}
+
+void SDLDecoder::CaptureData(const void *data, size_t sz)
+{
+    if (!_capture || sz == 0)
+        return;
+    if ((_capture->MaxSize > 0) && (_capture->Data.size() + sz > _capture->MaxSize))
+    {
+        EndCapture(SoundPCMData::kPCM_Failed);
+        return;
+    }
+    const uint8_t *buf = static_cast<const uint8_t*>(data);
+    _capture->Data.insert(_capture->Data.end(), buf, buf + sz);
+}
+
+void SDLDecoder::EndCapture(SoundPCMData::DataStatus status)
+{
+    if (!_capture)
+        return;
+    if (status == SoundPCMData::kPCM_Ready)
+    {
+        const auto &fmt = _sample->desired;
+        _capture->Format = fmt.format;
+        _capture->Channels = fmt.channels;
+        _capture->Freq = fmt.rate;
+        _capture->DurationMs = SoundHelper::MillisecondsFromBytes(
+            _capture->Data.size(), fmt.format, fmt.channels, fmt.rate);
+        if (_capture->Data.empty() || (_capture->DurationMs > _capture->MaxDurationMs))
+            status = SoundPCMData::kPCM_Failed;
+    }
+    if (status != SoundPCMData::kPCM_Ready)
+        _capture->Data = std::vector<uint8_t>();
+    // Data must be complete before the status is published
+    _capture->Status.store(status, std::memory_order_release);
+    _capture = nullptr;
+}
+
 bool SDLDecoder::Open(float pos_ms)
 {
+    if (_pcmData)
+    { // PCM data is always ready, only reset the position
+        _EOS = false;
+        _posBytes = 0u;
+        _posMs = 0.f;
+        if (pos_ms > 0.f)
+            Seek(pos_ms);
+        return true;
+    }
+
     // Prevent from "reopening" twice
     assert(!_sample);
     if (_sample && pos_ms > 0.f)
@@ -107,12 +175,17 @@ bool SDLDecoder::Open(float pos_ms)
     {
         _rwops = nullptr; // rwops was closed by the Sound_NewSample
         _sampleData = nullptr;
+        if (_capture)
+            EndCapture(SoundPCMData::kPCM_Failed);
         return false;
     }
 
     _sample = std::move(sample);
     int dur = Sound_GetDuration(_sample.get()); // may return -1 for unknown
     _durationMs = dur > 0 ? static_cast<float>(dur) : 0.f;
+    // If the duration is known beforehand, then test it prior to decoding
+    if (_capture && (_durationMs > _capture->MaxDurationMs))
+        EndCapture(SoundPCMData::kPCM_Failed);
     _posBytes = 0u;
     _posMs = 0.f;
     if (pos_ms > 0.f) {
@@ -124,24 +197,70 @@ bool SDLDecoder::Open(float pos_ms)
 void SDLDecoder::Close()
 {
     _sample.reset();
+    _pcmData = nullptr;
     _rwops = nullptr; // rwops was closed by the Sound_NewSample
     _sampleData = nullptr;
 }
 
 float SDLDecoder::Seek(float pos_ms)
 {
+    if (_pcmData && pos_ms >= 0.f)
+    {
+        const size_t frame_sz = SoundHelper::BytesPerSample(_pcmData->Format) * _pcmData->Channels;
+        size_t pos_bytes = SoundHelper::BytesPerMs(pos_ms, _pcmData->Format, _pcmData->Channels, _pcmData->Freq);
+        pos_bytes = std::min(pos_bytes - pos_bytes % frame_sz, _pcmData->Data.size());
+        _posBytes = pos_bytes;
+        _posMs = SoundHelper::MillisecondsFromBytes(_posBytes,
+            _pcmData->Format, _pcmData->Channels, _pcmData->Freq);
+        _EOS = false;
+        return _posMs;
+    }
     if (!_sample || pos_ms < 0.f)
         return _posMs;
     if (Sound_Seek(_sample.get(), static_cast<uint32_t>(pos_ms)) == 0)
         return _posMs; // old pos on failure (CHECKME?)
+    // Captured sound must be contiguous: restart capturing if rewinding
+    // to the beginning, otherwise give it up for this playback
+    if (_capture)
+    {
+        if (pos_ms == 0.f)
+            _capture->Data.clear();
+        else
+            EndCapture(SoundPCMData::kPCM_Cancelled);
+    }
     _posMs = pos_ms;
     _posBytes = SoundHelper::BytesPerMs(_posMs,
         _sample->desired.format, _sample->desired.channels, _sample->desired.rate);
     return pos_ms; // new pos on success
 }
 
+SoundBufferPtr SDLDecoder::GetPCMChunk()
+{
+    if (_EOS)
+        return SoundBufferPtr();
+    const auto &pcm = *_pcmData;
+    const float old_pos = _posMs;
+    const size_t sz = pcm.Data.size() - _posBytes;
+    const void *data = pcm.Data.data() + _posBytes;
+    if (_repeat)
+    { // next time return the whole sound from the start
+        _posBytes = 0u;
+        _posMs = 0.f;
+    }
+    else
+    {
+        _posBytes = pcm.Data.size();
+        _posMs = pcm.DurationMs;
+        _EOS = true;
+    }
+    return SoundBufferPtr(data, sz, old_pos,
+        SoundHelper::MillisecondsFromBytes(sz, pcm.Format, pcm.Channels, pcm.Freq));
+}
+
 SoundBufferPtr SDLDecoder::GetData()
 {
+    if (_pcmData)
+        return GetPCMChunk();
     if (!_sample || _EOS)
         return SoundBufferPtr();
     float old_pos = _posMs;
@@ -152,15 +271,20 @@ SoundBufferPtr SDLDecoder::GetData()
         _posBytes += sz;
         _posMs = SoundHelper::MillisecondsFromBytes(_posBytes,
             _sample->desired.format, _sample->desired.channels, _sample->desired.rate);
+        CaptureData(_sample->buffer, sz);
         // If we reached end of stream, or read less than the buffer size
         // (in which case it may also be decode error), then finish playing
         if ((_sample->flags & SOUND_SAMPLEFLAG_EOF) || (sz < _sample->buffer_size))
         {
             _EOS = true;
             if ((_sample->flags & SOUND_SAMPLEFLAG_ERROR) != 0)
+            {
+                EndCapture(SoundPCMData::kPCM_Failed);
                 return SoundBufferPtr();
+            }
+            EndCapture(SoundPCMData::kPCM_Ready);
             // if repeat, then seek to start.
-            else if (_repeat) {
+            if (_repeat) {
                 _EOS = Sound_Rewind(_sample.get()) == 0;
                 _posBytes = 0u;
                 _posMs = 0.f;
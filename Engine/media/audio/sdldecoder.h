@@ -17,6 +17,7 @@
 //=============================================================================
 #ifndef __AGS_EE_MEDIA__SDLDECODER_H
 #define __AGS_EE_MEDIA__SDLDECODER_H
+#include <atomic>
 #include <memory>
 #include <vector>
 #include <SDL_sound.h>
@@ -144,6 +145,34 @@ private:
     std::vector<uint8_t> _buf;
 };
 
+class OpenAlStaticBuffer;
+
+// SoundPCMData holds a complete sound, fully decoded into raw PCM samples
+struct SoundPCMData
+{
+    enum DataStatus
+    {
+        kPCM_Pending,   // being captured by a decoder
+        kPCM_Ready,     // complete and may be used
+        kPCM_Failed,    // sound cannot be captured (decode error, or too large)
+        kPCM_Cancelled  // capture was interrupted, and may be retried later
+    };
+
+    SDL_AudioFormat Format = 0;
+    int Channels = 0;
+    int Freq = 0;
+    float DurationMs = 0.f;
+    std::vector<uint8_t> Data;
+    // Limits which the captured sound must fit into
+    float MaxDurationMs = 0.f;
+    size_t MaxSize = 0u;
+    // Data status; the data is written by the audio thread while pending,
+    // and may be read by other threads only after it becomes ready
+    std::atomic<int> Status{kPCM_Ready};
+    // Output buffer prefilled with the whole data, created on the first playback
+    std::shared_ptr<OpenAlStaticBuffer> OutputBuffer;
+};
+
 // RAII wrapper over SDL resampling filter;
 // initialized by passing input and desired sound format;
 // tells whether conversion is necessary and performs one on command.
@@ -184,17 +213,30 @@ public:
     SDLDecoder(std::shared_ptr<std::vector<uint8_t>> &data, const String &ext_hint, bool repeat);
     // Initializes decoder with an input stream
     SDLDecoder(const std::unique_ptr<Stream> in, const String &ext_hint, bool repeat);
+    // Initializes decoder with an already decoded PCM data;
+    // such decoder does not do any actual decoding, but returns whole data at once
+    SDLDecoder(std::shared_ptr<SoundPCMData> &pcm, bool repeat);
     SDLDecoder(SDLDecoder&& dec);
-    ~SDLDecoder() = default;
+    ~SDLDecoder();
+
+    // Makes decoder also collect the decoded sound into the given PCM object,
+    // which becomes ready once the whole sound was decoded in one pass.
+    // Must be called before Open.
+    void SetCapture(std::shared_ptr<SoundPCMData> pcm);
 
     // Tells if the decoder is in a valid state, ready to work
-    bool IsValid() const { return _sample != nullptr; }
+    bool IsValid() const { return _sample != nullptr || _pcmData != nullptr; }
+    // Gets the pre-decoded PCM data this decoder is serving, if any
+    const std::shared_ptr<SoundPCMData> &GetPCM() const { return _pcmData; }
     // Gets the audio format
-    SDL_AudioFormat GetFormat() const { return _sample ? _sample->desired.format : 0; }
+    SDL_AudioFormat GetFormat() const
+        { return _pcmData ? _pcmData->Format : (_sample ? _sample->desired.format : 0); }
     // Gets the number of channels
-    int GetChannels() const { return _sample ? _sample->desired.channels : 0; }
+    int GetChannels() const
+        { return _pcmData ? _pcmData->Channels : (_sample ? _sample->desired.channels : 0); }
     // Gets the audio rate (frequency)
-    int GetFreq() const { return _sample ? _sample->desired.rate : 0; }
+    int GetFreq() const
+        { return _pcmData ? _pcmData->Freq : (_sample ? _sample->desired.rate : 0); }
     // Tells if the data reading has reached EOS
     bool EOS() const { return _EOS; }
     // Gets current reading position, in ms
@@ -212,8 +254,17 @@ public:
     SoundBufferPtr GetData();
 
 private:
+    // Returns the remaining PCM data in one chunk
+    SoundBufferPtr GetPCMChunk();
+    // Appends decoded data to the captured sound
+    void CaptureData(const void *data, size_t sz);
+    // Finalizes the sound capture with the given status
+    void EndCapture(SoundPCMData::DataStatus status);
+
     SDL_RWops *_rwops = nullptr;
     std::shared_ptr<std::vector<uint8_t>> _sampleData{};
+    std::shared_ptr<SoundPCMData> _pcmData{};
+    std::shared_ptr<SoundPCMData> _capture{};
     String _sampleExt = "";
     SoundSampleUniquePtr _sample = nullptr;
     float _durationMs = 0.f;
@@ -14,6 +14,7 @@
 #include "media/audio/sound.h"
 #include <list>
 #include <unordered_map>
+#include <unordered_set>
 #include "ac/game.h"
 #include "data/assetmanager.h"
 #include "debug/out.h"
@@ -65,22 +66,103 @@ private:
     }
 };
 
+// Decoded sound cache, stores short sounds fully decoded into PCM,
+// which lets play them without running a decoder.
+class PCMSoundCache final :
+    public ResourceCache<String, std::shared_ptr<SoundPCMData>>
+{
+public:
+    typedef std::shared_ptr<SoundPCMData> DataRef;
+
+    PCMSoundCache() : ResourceCache(DEFAULT_PCMCACHESIZE_KB)
+    {
+    }
+
+private:
+    size_t CalcSize(const DataRef &item) override
+    {
+        assert(item);
+        return item ? item->Data.size() : 0u;
+    }
+};
+
 
 // Maximal sound asset size which is allowed to be loaded at once;
 // anything larger will be streamed
 static size_t MaxLoadAtOnce = DEFAULT_SOUNDLOADATONCE_KB;
 static SoundCache SndCache;
+// Maximal sound duration which is allowed to be stored fully decoded
+static size_t MaxPCMDurationMs = DEFAULT_PCMCACHE_MAXMS;
+static PCMSoundCache PCMCache;
+// Sounds which failed to get into the decoded cache, remembered in order
+// to not try decoding them again
+static std::unordered_set<String> PCMRejected;
+// Sounds which are being captured by the audio players during their
+// first playback, to be put into the decoded cache once complete
+static std::unordered_map<String, std::shared_ptr<SoundPCMData>> PCMPending;
 
-void soundcache_set_rules(size_t max_loadatonce, size_t max_cachesize)
+void soundcache_set_rules(size_t max_loadatonce, size_t max_cachesize,
+    size_t pcm_max_ms, size_t pcm_cachesize)
 {
     MaxLoadAtOnce = max_loadatonce;
     SndCache.SetMaxCacheSize(max_cachesize);
+    MaxPCMDurationMs = pcm_max_ms;
+    PCMCache.SetMaxCacheSize(pcm_cachesize);
     Debug::Printf("Sound cache set: %zu KB", max_cachesize / 1024);
+    Debug::Printf("Decoded sound cache set: %zu KB, for sounds up to %zu ms",
+        pcm_cachesize / 1024, pcm_max_ms);
 }
 
 void soundcache_clear()
 {
     SndCache.Clear();
+    PCMCache.Clear();
+    PCMRejected.clear();
+    PCMPending.clear();
+}
+
+// Moves the completely captured sounds into the PCM cache
+static void pcmcache_update_pending()
+{
+    for (auto it = PCMPending.begin(); it != PCMPending.end();)
+    {
+        switch (it->second->Status.load(std::memory_order_acquire))
+        {
+        case SoundPCMData::kPCM_Ready:
+            PCMCache.Put(it->first, it->second);
+            break;
+        case SoundPCMData::kPCM_Failed:
+            PCMRejected.insert(it->first);
+            break;
+        case SoundPCMData::kPCM_Cancelled:
+            break; // may try again on the next playback
+        default:
+            ++it;
+            continue; // still decoding
+        }
+        it = PCMPending.erase(it);
+    }
+}
+
+// Creates a capture object for the sound, if it should be put into the PCM cache
+static std::shared_ptr<SoundPCMData> pcmcache_request(const String &name)
+{
+    if (PCMCache.GetMaxCacheSize() == 0 || MaxPCMDurationMs == 0)
+        return nullptr; // cache is disabled
+    if (PCMRejected.count(name) > 0 || PCMPending.count(name) > 0)
+        return nullptr; // was already tested, or is being captured
+    auto pcm = std::make_shared<SoundPCMData>();
+    pcm->MaxDurationMs = static_cast<float>(MaxPCMDurationMs);
+    pcm->MaxSize = PCMCache.GetMaxCacheSize();
+    pcm->Status = SoundPCMData::kPCM_Pending;
+    PCMPending[name] = pcm;
+    return pcm;
+}
+
+static String get_sound_ext_hint(const AssetPath &apath, const char *extension_hint)
+{
+    const auto asset_ext = AGS::Common::Path::GetFileExtension(apath.Name);
+    return asset_ext.IsEmpty() ? String(extension_hint) : asset_ext;
 }
 
 void soundcache_precache(const AssetPath &apath)
@@ -103,6 +185,19 @@ void soundcache_precache(const AssetPath &apath)
 
 std::unique_ptr<SoundClip> load_sound_clip(const AssetPath &apath, const char *extension_hint, bool loop)
 {
+    const auto ext_hint = get_sound_ext_hint(apath, extension_hint);
+    const auto sound_type = GetLegacySoundTypeFromExt(ext_hint.GetCStr());
+
+    // If a decoded sound is found in cache, then play it straight away
+    pcmcache_update_pending();
+    auto pcmdata = PCMCache.Get(apath.Name);
+    if (pcmdata)
+    {
+        const int slot = audio_core_slot_init(pcmdata, loop);
+        if (slot < 0) { return nullptr; }
+        return std::unique_ptr<SoundClip>(new SoundClip(slot, sound_type, loop));
+    }
+
     size_t asset_size;
     std::unique_ptr<Stream> s_in;
     auto sounddata = SndCache.Get(apath.Name);
@@ -118,9 +213,6 @@ std::unique_ptr<SoundClip> load_sound_clip(const AssetPath &apath, const char *e
         asset_size = static_cast<size_t>(s_in->GetLength());
     }
 
-    const auto asset_ext = AGS::Common::Path::GetFileExtension(apath.Name);
-    const auto ext_hint = asset_ext.IsEmpty() ? String(extension_hint) : asset_ext;
-
     int slot{};
     // If sound data was cached, or asset's size is small enough to load at once,
     // then load/use it and update the cache if necessary
@@ -132,7 +224,9 @@ std::unique_ptr<SoundClip> load_sound_clip(const AssetPath &apath, const char *e
             s_in->Read(sounddata->data(), asset_size);
             SndCache.Put(apath.Name, sounddata);
         }
-        slot = audio_core_slot_init(sounddata, ext_hint, loop);
+        // Short sounds are captured by the decoder during this playback,
+        // and will be played from the decoded cache next time
+        slot = audio_core_slot_init(sounddata, ext_hint, loop, pcmcache_request(apath.Name));
     }
     // Otherwise, if asset's size is too large, start streaming
     else
@@ -141,7 +235,5 @@ std::unique_ptr<SoundClip> load_sound_clip(const AssetPath &apath, const char *e
     }
 
     if (slot < 0) { return nullptr; }
-
-    const auto sound_type = GetLegacySoundTypeFromExt(ext_hint.GetCStr());
     return std::unique_ptr<SoundClip>(new SoundClip(slot, sound_type, loop));
 }
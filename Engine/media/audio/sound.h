@@ -26,11 +26,18 @@
 const size_t DEFAULT_SOUNDLOADATONCE_KB = 1024u;
 // Sound cache limit, in KB
 const size_t DEFAULT_SOUNDCACHESIZE_KB = 1024u * 32; // 32 MB
+// Decoded (PCM) sound cache limit, in KB
+const size_t DEFAULT_PCMCACHESIZE_KB = 1024u * 8; // 8 MB
+// Max duration of a sound which may be stored in decoded cache, in ms
+const size_t DEFAULT_PCMCACHE_MAXMS = 2000u;
 
 // Sets sound loading and caching rules:
 // * max_loadatonce - threshold in bytes for loading sounds immediately, vs streaming
 // * max_cachesize - sound cache limit, in bytes
-void soundcache_set_rules(size_t max_loadatonce, size_t max_cachesize);
+// * pcm_max_ms - max duration of a sound which may be kept fully decoded, in ms
+// * pcm_cachesize - decoded sound cache limit, in bytes
+void soundcache_set_rules(size_t max_loadatonce, size_t max_cachesize,
+    size_t pcm_max_ms, size_t pcm_cachesize);
 void soundcache_clear();
 void soundcache_precache(const AssetPath &apath);
 
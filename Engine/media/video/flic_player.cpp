@@ -59,6 +59,9 @@ HError FlicPlayer::OpenImpl(std::unique_ptr<Common::Stream> data_stream,
     _durationMs = fli_frame_count * fli_speed;
     // FLIC must accumulate frame image because its frames contain diff since the last frame
     flags |= kVideo_AccumFrame;
+    // FLIC sets the global palette when decoding frames, which must be done
+    // on the main thread and in the order of display, so cannot decode ahead
+    flags &= ~kVideo_DecodeAhead;
     _videoFramesDecoded = 0u;
     return HError::None();
 }
@@ -17,6 +17,7 @@
 
 #include <inttypes.h>
 #include "debug/out.h"
+#include "media/video/yuv_convert.h"
 
 namespace AGS
 {
@@ -27,6 +28,8 @@ using namespace Common;
 
 TheoraPlayer::~TheoraPlayer()
 {
+    // Decoder thread must be stopped while the player is still whole
+    Stop();
     CloseImpl();
 }
 
@@ -87,7 +90,13 @@ HError TheoraPlayer::OpenAPEGStream(Stream *data_stream, const Common::String &n
     apeg_disable_length_detection(TRUE);
     apeg_ignore_audio((flags & kVideo_EnableAudio) == 0);
 
+    _usedFlags = flags;
+    _usedDepth = target_depth;
+    _directConvert = false;
+    // NOTE: display callbacks are only used during stream's initialization
+    apeg_set_display_callbacks(InitDisplay, DisplayFrame, this);
     APEG_STREAM* apeg_stream = apeg_open_stream_ex(data_stream);
+    apeg_set_display_callbacks(NULL, NULL, NULL);
     if (!apeg_stream)
     {
         return new Error(String::FromFormat("Failed to open theora video '%s'; could be an invalid or unsupported format", name.GetCStr()));
@@ -99,8 +108,6 @@ HError TheoraPlayer::OpenAPEGStream(Stream *data_stream, const Common::String &n
     }
 
     _apegStream = apeg_stream;
-    _usedFlags = flags;
-    _usedDepth = target_depth;
 
     _frameDepth = target_depth;
     _frameSize = Size(video_w, video_h);
@@ -113,7 +120,12 @@ HError TheoraPlayer::OpenAPEGStream(Stream *data_stream, const Common::String &n
     // Which means that the original content may end up positioned on a larger frame.
     // In such case we store this surface in a separate wrapper for the reference,
     // while the actual video frame is assigned a sub-bitmap (a portion of the full frame).
-    if (((flags & kVideo_LegacyFrameSize) == 0) &&
+    if (_directConvert)
+    {
+        _theoraFullFrame.reset();
+        _theoraSrcFrame.reset();
+    }
+    else if (((flags & kVideo_LegacyFrameSize) == 0) &&
         Size(_apegStream->bitmap->w, _apegStream->bitmap->h) != _frameSize)
     {
         _theoraFullFrame.reset(BitmapHelper::CreateRawBitmapWrapper(_apegStream->bitmap));
@@ -144,6 +156,33 @@ HError TheoraPlayer::OpenAPEGStream(Stream *data_stream, const Common::String &n
     return HError::None();
 }
 
+int TheoraPlayer::InitDisplay(APEG_STREAM *stream, int coded_w, int coded_h, void *arg)
+{
+    TheoraPlayer *player = static_cast<TheoraPlayer*>(arg);
+    player->_codedSize = Size(coded_w, coded_h);
+    // Only 32-bit frames of YUV 4:2:0 format are supported by our converter;
+    // in the legacy frame size mode the full coded frame is returned to the
+    // caller, so let APEG create its bitmap.
+    player->_directConvert = (player->_usedDepth == 32)
+        && (stream->pixel_format == APEG_STREAM::APEG_420)
+        && ((player->_usedFlags & kVideo_LegacyFrameSize) == 0);
+    return player->_directConvert ? 0 : 1; // 1 means use APEG's own converter
+}
+
+void TheoraPlayer::DisplayFrame(APEG_STREAM *stream, unsigned char **src, void *arg)
+{
+    TheoraPlayer *player = static_cast<TheoraPlayer*>(arg);
+    if (!player->_convertDst)
+        return;
+    YUV420Planes planes;
+    planes.Y = src[0];
+    planes.U = src[1];
+    planes.V = src[2];
+    planes.YStride = player->_codedSize.Width;
+    planes.UVStride = player->_codedSize.Width / 2;
+    ConvertYUV420ToRGB32(planes, stream->w, stream->h, player->_convertDst);
+}
+
 void TheoraPlayer::CloseImpl()
 {
     if (_apegStream)
@@ -181,17 +220,18 @@ bool TheoraPlayer::NextVideoFrame(Bitmap *dst, float &ts)
     if (ret == APEG_ERROR)
         return false;
 
-    // Update the display frame (decode to RGB)
+    // Update the display frame (decode to RGB);
+    // if direct conversion is on, then the image is written right into dst
+    _convertDst = dst;
     ret = apeg_display_video_frame(_apegStream);
+    _convertDst = nullptr;
     if (ret == APEG_ERROR || ret == APEG_EOF)
         return false; // NOTE: apeg_display_video_frame returns EOF when picture is NULL
 
     _videoFramesDecoded++;
     _videoFramesDecodedTotal++;
-    // TODO: investigate if it's possible to optimize this by providing our own src bitmap directly;
-    // but in theory the frame image may be composed of multiple frames which contain partial image,
-    // in which case we probably cannot do this...
-    dst->Blit(_theoraSrcFrame.get());
+    if (!_directConvert)
+        dst->Blit(_theoraSrcFrame.get());
     ts = _nextFrameTs;
     _nextFrameTs = _apegStream->pos * 1000.f; // to milliseconds (FIXME: should we keep ours in seconds?)
     return true;
@@ -49,6 +49,10 @@ private:
     void DropVideoFrame() override;
 
     Common::HError OpenAPEGStream(Stream *data_stream, const String &name, int flags, int target_depth);
+    // APEG display callbacks: these let convert decoded YUV image directly
+    // into the destination frame, skipping APEG's own buffer bitmap
+    static int InitDisplay(APEG_STREAM *stream, int coded_w, int coded_h, void *arg);
+    static void DisplayFrame(APEG_STREAM *stream, unsigned char **src, void *arg);
 
     std::unique_ptr<Stream> _dataStream;
     int _usedFlags = 0;
@@ -58,6 +62,11 @@ private:
     std::unique_ptr<Common::Bitmap> _theoraFullFrame;
     // Wrapper over portion of theora frame which we want to use
     std::unique_ptr<Common::Bitmap> _theoraSrcFrame;
+    // Whether the decoded image is converted right into the destination
+    // frame by our own converter, in which case APEG has no buffer bitmap
+    bool _directConvert = false;
+    Size _codedSize; // size of the decoded YUV image
+    Common::Bitmap *_convertDst = nullptr; // frame being converted into
     uint64_t _videoFramesDecodedTotal = 0u; // how many frames loaded and decoded total (includes rewinds!)
     uint64_t _videoFramesDecoded = 0u; // sequential count of video frames since the video beginning
     float _nextFrameTs = 0.f; // next frame presentation time
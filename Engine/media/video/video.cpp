@@ -25,6 +25,7 @@
 #include "ac/global_audio.h"
 #include "ac/sys_events.h"
 #include "debug/debug_log.h"
+#include "debug/profiler.h"
 #include "gfx/graphicsdriver.h"
 #include "main/game_run.h"
 #include "media/audio/audio.h"
@@ -403,6 +404,7 @@ void BlockingVideoPlayer::PrintStats()
     if (!self || !self->_player.get())
         return;
 
+    AGS_PROFILE_THREAD("Video");
     bool do_run = true;
     while (do_run)
     {
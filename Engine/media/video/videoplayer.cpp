@@ -14,6 +14,7 @@
 #ifndef AGS_NO_VIDEO_PLAYER
 #include "media/video/videoplayer.h"
 #include "debug/out.h"
+#include "debug/profiler.h"
 #include "util/memory_compat.h"
 
 #define VIDEO_DEBUG_VERBOSE     (0)
@@ -46,9 +47,13 @@ HError VideoPlayer::Open(std::unique_ptr<Common::Stream> data_stream,
     HError err = OpenImpl(std::move(data_stream), name, flags, target_depth);
     if (!err)
         return err;
+#if defined(AGS_DISABLE_THREADS)
+    flags &= ~kVideo_DecodeAhead;
+#endif
 
     _name = name;
     _flags = flags;
+    _decodeAhead = (flags & kVideo_DecodeAhead) != 0;
     _targetFPS = target_fps > 0.f ? target_fps : _frameRate;
     // Start the audio stream
     if (HasAudio())
@@ -69,12 +74,33 @@ HError VideoPlayer::Open(std::unique_ptr<Common::Stream> data_stream,
     _targetFrameTime = 1000.f / _targetFPS;
     _queueTimeMax = _queueMax * _targetFrameTime;
     _resetStartTime = true;
+
+#if !defined(AGS_DISABLE_THREADS)
+    if (IsDecodingAhead())
+    {
+        _decodedVideo.Reset(DecodeAheadVideoFrames);
+        _decodedAudio.Reset(DecodeAheadAudioFrames);
+        // all the frames in use may be released back at once
+        _freeVideo.Reset(_queueMax + DecodeAheadVideoFrames + 2);
+        _freeAudio.Reset(_queueMax * 4 + DecodeAheadAudioFrames);
+    }
+#endif
     return HError::None();
 }
 
 void VideoPlayer::SetTargetFrame(const Size &target_sz)
 {
+#if !defined(AGS_DISABLE_THREADS)
+    // Decoder uses target frame and helper buffers, and already decoded
+    // frames may be of the old size; decoding restarts on the next poll
+    StopDecoder();
+    ResetDecoderQueues();
+#endif
+
     _targetSize = target_sz.IsNull() ? _frameSize : target_sz;
+    // Only decode ahead if frames are not stretched, as bitmap stretching
+    // uses a global state, and must be done on the same thread as rendering
+    _decodeAhead = ((_flags & kVideo_DecodeAhead) != 0) && (_targetSize == _frameSize);
 
     // Create helper bitmaps in case of stretching or color depth conversion
     if ((_targetSize != _frameSize) || (_targetDepth != _frameDepth)
@@ -110,6 +136,12 @@ void VideoPlayer::Stop()
         _playState = PlayStateStopped;
     }
 
+#if !defined(AGS_DISABLE_THREADS)
+    // Decoder thread must be stopped before closing the decoder
+    StopDecoder();
+    ResetDecoderQueues();
+#endif
+
     // Shutdown openal source
     _audioOut.reset();
     // Close video decoder and free resources
@@ -192,7 +224,7 @@ std::unique_ptr<Bitmap> VideoPlayer::NextFrame()
     if (_playState != PlaybackState::PlayStatePaused)
         Pause();
 
-    BufferVideo();
+    BufferVideoOrWait();
 
     auto frame = NextFrameFromQueue();
     if (!frame)
@@ -201,6 +233,7 @@ std::unique_ptr<Bitmap> VideoPlayer::NextFrame()
         // see how AudioPlayer does this
         if (IsLooping() && Rewind())
         {
+            BufferVideoOrWait();
             frame = NextFrameFromQueue();
         }
         else
@@ -291,11 +324,12 @@ std::unique_ptr<Common::Bitmap> VideoPlayer::GetReadyFrame()
 
 void VideoPlayer::ReleaseFrame(std::unique_ptr<Common::Bitmap> frame)
 {
-    _videoFramePool.push(std::move(frame));
+    ReleaseVideoFrame(std::move(frame));
 }
 
 bool VideoPlayer::Poll()
 {
+    AGS_PROFILE_ZONE("VideoPlayer::Poll");
     if (!IsPlaybackReady(_playState))
         return false;
 
@@ -307,6 +341,11 @@ bool VideoPlayer::Poll()
 
 bool VideoPlayer::PollImpl()
 {
+#if !defined(AGS_DISABLE_THREADS)
+    if (IsDecodingAhead())
+        StartDecoder();
+#endif
+
     // Buffer always when ready, even if we are paused
     if (HasVideo())
         BufferVideo();
@@ -348,9 +387,28 @@ bool VideoPlayer::PollImpl()
 
 bool VideoPlayer::Rewind()
 {
+#if !defined(AGS_DISABLE_THREADS)
+    // Decoder is restarted on the next poll; frames it already decoded
+    // belong to the old position and must be discarded
+    StopDecoder();
+    ResetDecoderQueues();
+#endif
     if (!RewindImpl())
         return false;
 
+    // Dispose any buffered frames from the old position
+    while (!_videoFrameQueue.empty())
+    {
+        ReleaseVideoFrame(_videoFrameQueue.front()->Retrieve());
+        _videoFrameQueue.pop_front();
+    }
+    while (!_audioFrameQueue.empty())
+    {
+        ReleaseAudioFrame(std::move(_audioFrameQueue.front()));
+        _audioFrameQueue.pop_front();
+    }
+    _audioQueueDurMs = 0.f;
+
     // TODO: this cannot be done on Rewind itself if we rewind not after
     // everything is played, but after everything is buffered!
     // See how this is implemented in the AudioPlayer!
@@ -386,10 +444,33 @@ void VideoPlayer::BufferVideo()
         return; // queue limit reached
 
     // Optionally drop late frames, but have at least 1 for display
-    if (((_flags & kVideo_DropFrames) != 0) && ((_flags & kVideo_DropFramesUndecoded) != 0)
-        && _videoFrameQueue.size() > 0)
+    const bool drop_undecoded = ((_flags & kVideo_DropFrames) != 0) && ((_flags & kVideo_DropFramesUndecoded) != 0)
+        && _videoFrameQueue.size() > 0;
+    const float drop_time = _playbackDurationMs - _targetFrameTime;
+
+#if !defined(AGS_DISABLE_THREADS)
+    if (IsDecodingAhead())
+    {
+        // Let decoder know which frames are late, convert to the video's own time
+        _decoderDropTs = drop_undecoded ? (drop_time * _frameTime / _targetFrameTime) : -1.f;
+        _stats.VideoIn.Dropped += _decoderDropped.exchange(0u);
+        // Take as many decoded frames as the queue allows
+        VideoFrame vframe;
+        bool got_frames = false;
+        while ((_videoFrameQueue.size() < _queueMax) && _decodedVideo.Pop(vframe))
+        {
+            RecordVideoInput(vframe.Bitmap(), vframe.InputTimeMs());
+            QueueVideoFrame(vframe.Retrieve(), vframe.Timestamp());
+            got_frames = true;
+        }
+        if (got_frames)
+            WakeDecoder();
+        return;
+    }
+#endif
+
+    if (drop_undecoded)
     {
-        const float drop_time = _playbackDurationMs - _targetFrameTime;
         float frame_ts = PeekVideoFrame();
 
         if ((frame_ts >= 0.f && frame_ts < drop_time))
@@ -415,28 +496,47 @@ void VideoPlayer::BufferVideo()
         _videoFramePool.pop();
     }
 
-    const auto input_start = Clock::now();
-
     // Try to retrieve one video frame from decoder
-    const bool must_conv = (_targetSize != _frameSize || _targetDepth != _frameDepth
-        || ((_flags & kVideo_AccumFrame) != 0));
-    Bitmap *usebuf = must_conv ? _vframeBuf.get() : target_frame.get();
     float frame_ts = -1.f;
-    if (!NextVideoFrame(usebuf, frame_ts))
+    float input_ms = 0.f;
+    if (!DecodeVideoFrame(target_frame.get(), frame_ts, input_ms))
     {
         // failed to get frame, so move prepared target frame into the pool for now
         _videoFramePool.push(std::move(target_frame));
         return;
     }
 
-    const auto decoded_frame_sz = usebuf->GetDataSize();
-    // Convert frame_ts to our playback speed
-    frame_ts = frame_ts * _targetFrameTime / _frameTime;
-#if (VIDEO_DEBUG_VERBOSE)
-    const float expect_frame_ts = _inputFrameCount * _targetFrameTime;
-    Debug::Printf("INPUT VIDEO FRAME: expect ts = %.2f, given ts = %.2f, diff = %.2f", expect_frame_ts, frame_ts, expect_frame_ts - frame_ts);
+    RecordVideoInput(target_frame.get(), input_ms);
+    QueueVideoFrame(std::move(target_frame), frame_ts);
+}
+
+void VideoPlayer::BufferVideoOrWait()
+{
+    BufferVideo();
+#if !defined(AGS_DISABLE_THREADS)
+    if (IsDecodingAhead())
+    {
+        StartDecoder();
+        while (_videoFrameQueue.empty() && !IsVideoInputOver())
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            BufferVideo();
+        }
+    }
 #endif
-    _inputFrameCount++;
+}
+
+bool VideoPlayer::DecodeVideoFrame(Bitmap *target_frame, float &frame_ts, float &input_ms)
+{
+    const auto input_start = Clock::now();
+
+    // Try to retrieve one video frame from decoder
+    const bool must_conv = (_targetSize != _frameSize || _targetDepth != _frameDepth
+        || ((_flags & kVideo_AccumFrame) != 0));
+    Bitmap *usebuf = must_conv ? _vframeBuf.get() : target_frame;
+    frame_ts = -1.f;
+    if (!NextVideoFrame(usebuf, frame_ts))
+        return false;
 
     // Convert frame if necessary
     if (must_conv)
@@ -454,24 +554,63 @@ void VideoPlayer::BufferVideo()
             target_frame->StretchBlt(usebuf, RectWH(_targetSize));
     }
 
-    const auto input_dur_ms = ToMillisecondsF(Clock::now() - input_start);
+    input_ms = ToMillisecondsF(Clock::now() - input_start);
+    return true;
+}
 
-    // Stats
-    assert(target_frame);
+void VideoPlayer::RecordVideoInput(const Bitmap *frame, float input_ms)
+{
     _stats.VideoIn.Frames++;
-    _stats.VideoIn.TotalDataSz += target_frame->GetDataSize();
+    _stats.VideoIn.TotalDataSz += frame->GetDataSize();
     _stats.VideoIn.TotalDurMs += _frameTime;
-    _stats.VideoIn.TotalTime += static_cast<uint64_t>(input_dur_ms);
-    _stats.VideoIn.RawDecodedDataSz = decoded_frame_sz;
-    _stats.VideoIn.RawDecodedConvDataSz = target_frame->GetDataSize();
+    _stats.VideoIn.TotalTime += static_cast<uint64_t>(input_ms);
+    _stats.VideoIn.RawDecodedDataSz = _vframeBuf ? _vframeBuf->GetDataSize() : frame->GetDataSize();
+    _stats.VideoIn.RawDecodedConvDataSz = frame->GetDataSize();
     _stats.VideoIn.AvgTimePerFrame = static_cast<double>(_stats.VideoIn.TotalTime) / _stats.VideoIn.Frames;
-    _stats.VideoIn.MaxTimePerFrame = std::max(_stats.VideoIn.MaxTimePerFrame, input_dur_ms);
+    _stats.VideoIn.MaxTimePerFrame = std::max(_stats.VideoIn.MaxTimePerFrame, input_ms);
+}
+
+void VideoPlayer::QueueVideoFrame(std::unique_ptr<Bitmap> frame, float frame_ts)
+{
+    assert(frame);
+    // Convert frame_ts to our playback speed
+    frame_ts = frame_ts * _targetFrameTime / _frameTime;
+#if (VIDEO_DEBUG_VERBOSE)
+    const float expect_frame_ts = _inputFrameCount * _targetFrameTime;
+    Debug::Printf("INPUT VIDEO FRAME: expect ts = %.2f, given ts = %.2f, diff = %.2f", expect_frame_ts, frame_ts, expect_frame_ts - frame_ts);
+#endif
+    _inputFrameCount++;
+
+    // Stats
     _stats.MaxBufferedVideo = std::max<uint32_t>(_stats.MaxBufferedVideo, _videoFrameQueue.size());
     // TODO: maybe record this every 10 - 100 frames?
     _stats.BufferedVideoAccum += _videoFrameQueue.size();
 
     // Push final frame to the queue
-    _videoFrameQueue.push_back(std::make_unique<VideoFrame>(std::move(target_frame), frame_ts));
+    _videoFrameQueue.push_back(std::make_unique<VideoFrame>(std::move(frame), frame_ts));
+}
+
+void VideoPlayer::ReleaseVideoFrame(std::unique_ptr<Bitmap> frame)
+{
+#if !defined(AGS_DISABLE_THREADS)
+    if (IsDecodingAhead())
+    {
+        _freeVideo.Push(std::move(frame)); // if the queue is full, frame is deleted
+        return;
+    }
+#endif
+    _videoFramePool.push(std::move(frame));
+}
+
+bool VideoPlayer::IsVideoInputOver() const
+{
+#if !defined(AGS_DISABLE_THREADS)
+    // NOTE: the order of checks is important, as the decoder sets the flag
+    // after pushing its last frame
+    if (IsDecodingAhead())
+        return _videoDecoded.load(std::memory_order_acquire) && _decodedVideo.IsEmpty();
+#endif
+    return true;
 }
 
 void VideoPlayer::BufferAudio()
@@ -479,6 +618,24 @@ void VideoPlayer::BufferAudio()
     if (_audioQueueDurMs >= _queueMax * _targetFrameTime)
         return; // queue limit reached
 
+#if !defined(AGS_DISABLE_THREADS)
+    if (IsDecodingAhead())
+    {
+        // Take as many decoded frames as the queue allows
+        AudioFrame aframe;
+        bool got_frames = false;
+        while ((_audioQueueDurMs < _queueMax * _targetFrameTime) && _decodedAudio.Pop(aframe))
+        {
+            RecordAudioInput(*aframe.Buf, aframe.InputMs);
+            QueueAudioFrame(std::move(aframe.Buf));
+            got_frames = true;
+        }
+        if (got_frames)
+            WakeDecoder();
+        return;
+    }
+#endif
+
     // Get one frame from the pool, if present, otherwise allocate a new one
     std::unique_ptr<SoundBuffer> aframe;
     if (_audioFramePool.empty())
@@ -491,25 +648,43 @@ void VideoPlayer::BufferAudio()
         _audioFramePool.pop();
     }
 
-    const auto input_start = Clock::now();
-
-    if (!NextAudioFrame(*aframe))
+    float input_ms = 0.f;
+    if (!DecodeAudioFrame(*aframe, input_ms))
     {
         // failed to get frame, so move prepared frame into the pool for now
         _audioFramePool.push(std::move(aframe));
         return;
     }
 
-    const auto input_dur_ms = ToMillisecondsF(Clock::now() - input_start);
+    RecordAudioInput(*aframe, input_ms);
+    QueueAudioFrame(std::move(aframe));
+}
 
-    // Stats
-    assert(aframe);
+bool VideoPlayer::DecodeAudioFrame(SoundBuffer &aframe, float &input_ms)
+{
+    const auto input_start = Clock::now();
+
+    if (!NextAudioFrame(aframe))
+        return false;
+
+    input_ms = ToMillisecondsF(Clock::now() - input_start);
+    return true;
+}
+
+void VideoPlayer::RecordAudioInput(const SoundBuffer &aframe, float input_ms)
+{
     _stats.AudioIn.Frames++;
-    _stats.AudioIn.TotalDataSz += aframe->Size();
-    _stats.AudioIn.TotalDurMs += aframe->DurationMs();
-    _stats.AudioIn.TotalTime += static_cast<uint64_t>(input_dur_ms);
+    _stats.AudioIn.TotalDataSz += aframe.Size();
+    _stats.AudioIn.TotalDurMs += aframe.DurationMs();
+    _stats.AudioIn.TotalTime += static_cast<uint64_t>(input_ms);
     _stats.AudioIn.AvgTimePerFrame = static_cast<double>(_stats.AudioIn.TotalTime) / _stats.AudioIn.Frames;
-    _stats.AudioIn.MaxTimePerFrame = std::max(_stats.AudioIn.MaxTimePerFrame, input_dur_ms);
+    _stats.AudioIn.MaxTimePerFrame = std::max(_stats.AudioIn.MaxTimePerFrame, input_ms);
+}
+
+void VideoPlayer::QueueAudioFrame(std::unique_ptr<SoundBuffer> aframe)
+{
+    assert(aframe);
+    // Stats
     _stats.MaxBufferedAudioMs = std::max(_stats.MaxBufferedAudioMs, _audioQueueDurMs);
     // TODO: maybe record this every 10 - 100 frames?
     _stats.BufferedAudioAcum += _audioQueueDurMs;
@@ -519,6 +694,144 @@ void VideoPlayer::BufferAudio()
     _audioFrameQueue.push_back(std::move(aframe));
 }
 
+void VideoPlayer::ReleaseAudioFrame(std::unique_ptr<SoundBuffer> aframe)
+{
+#if !defined(AGS_DISABLE_THREADS)
+    if (IsDecodingAhead())
+    {
+        _freeAudio.Push(std::move(aframe)); // if the queue is full, frame is deleted
+        return;
+    }
+#endif
+    _audioFramePool.push(std::move(aframe));
+}
+
+bool VideoPlayer::IsAudioInputOver() const
+{
+#if !defined(AGS_DISABLE_THREADS)
+    if (IsDecodingAhead())
+        return _audioDecoded.load(std::memory_order_acquire) && _decodedAudio.IsEmpty();
+#endif
+    return true;
+}
+
+#if !defined(AGS_DISABLE_THREADS)
+void VideoPlayer::StartDecoder()
+{
+    if (_decoderThread.joinable())
+        return;
+
+    _decoderQuit = false;
+    _decoderWake = false;
+    _videoDecoded = !HasVideo();
+    _audioDecoded = !HasAudio();
+    _decoderDropTs = -1.f;
+    _decoderDropped = 0u;
+    _decoderThread = std::thread(&VideoPlayer::DecodeProc, this);
+}
+
+void VideoPlayer::StopDecoder()
+{
+    if (!_decoderThread.joinable())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lk(_decoderMutex);
+        _decoderQuit = true;
+    }
+    _decoderCV.notify_one();
+    _decoderThread.join();
+}
+
+void VideoPlayer::ResetDecoderQueues()
+{
+    _decodedVideo.Reset(_decodedVideo.GetCapacity());
+    _decodedAudio.Reset(_decodedAudio.GetCapacity());
+    _freeVideo.Reset(_freeVideo.GetCapacity());
+    _freeAudio.Reset(_freeAudio.GetCapacity());
+}
+
+void VideoPlayer::WakeDecoder()
+{
+    {
+        std::lock_guard<std::mutex> lk(_decoderMutex);
+        _decoderWake = true;
+    }
+    _decoderCV.notify_one();
+}
+
+void VideoPlayer::DecodeProc()
+{
+    bool video_over = _videoDecoded;
+    bool audio_over = _audioDecoded;
+    std::unique_ptr<Bitmap> spare_frame; // in case decoding failed
+    std::unique_ptr<SoundBuffer> spare_aframe;
+    while (!_decoderQuit && !(video_over && audio_over))
+    {
+        bool did_work = false;
+        if (!video_over && !_decodedVideo.IsFull())
+        {
+            // Drop late frames before decoding them, if requested by player
+            const float drop_ts = _decoderDropTs;
+            const float frame_ts = (drop_ts >= 0.f) ? PeekVideoFrame() : -1.f;
+            if (frame_ts >= 0.f && frame_ts < drop_ts)
+            {
+                DropVideoFrame();
+                _decoderDropped.fetch_add(1u, std::memory_order_relaxed);
+            }
+            else
+            {
+                std::unique_ptr<Bitmap> target_frame = std::move(spare_frame);
+                if (!target_frame && !_freeVideo.Pop(target_frame))
+                    target_frame.reset(new Bitmap(_targetSize.Width, _targetSize.Height, _targetDepth));
+
+                float ts = -1.f, input_ms = 0.f;
+                if (DecodeVideoFrame(target_frame.get(), ts, input_ms))
+                {
+                    _decodedVideo.Push(VideoFrame(std::move(target_frame), ts, input_ms));
+                }
+                else
+                {
+                    spare_frame = std::move(target_frame);
+                    video_over = true;
+                    _videoDecoded.store(true, std::memory_order_release);
+                }
+            }
+            did_work = true;
+        }
+
+        if (!audio_over && !_decodedAudio.IsFull())
+        {
+            std::unique_ptr<SoundBuffer> aframe = std::move(spare_aframe);
+            if (!aframe && !_freeAudio.Pop(aframe))
+                aframe.reset(new SoundBuffer());
+
+            float input_ms = 0.f;
+            if (DecodeAudioFrame(*aframe, input_ms))
+            {
+                _decodedAudio.Push(AudioFrame(std::move(aframe), input_ms));
+            }
+            else
+            {
+                spare_aframe = std::move(aframe);
+                audio_over = true;
+                _audioDecoded.store(true, std::memory_order_release);
+            }
+            did_work = true;
+        }
+
+        if (!did_work)
+        {
+            // Queues are full, wait until player takes some frames
+            std::unique_lock<std::mutex> lk(_decoderMutex);
+            _decoderCV.wait_for(lk, std::chrono::milliseconds(DecoderIdleMs),
+                [this]() { return _decoderWake || _decoderQuit; });
+            _decoderWake = false;
+        }
+    }
+}
+#endif // !AGS_DISABLE_THREADS
+
 void VideoPlayer::UpdateStats()
 {
     const auto now = Clock::now();
@@ -649,12 +962,13 @@ bool VideoPlayer::ProcessVideo()
             Debug::Printf("DROPPED LATE FRAME, ts: %.2f, drop time: %.2f, queue size now: %u",
                           frame->Timestamp(), drop_time, _videoFrameQueue.size());
 #endif
-            _videoFramePool.push(std::move(frame->Retrieve()));
+            ReleaseVideoFrame(frame->Retrieve());
             _stats.VideoOut.Dropped++;
         }
     }
-    // We are good so long as there's a ready frame in queue
-    return !_videoFrameQueue.empty();
+    // We are good so long as there's a ready frame in queue,
+    // or the decoder is still working
+    return !_videoFrameQueue.empty() || !IsVideoInputOver();
 }
 
 bool VideoPlayer::ProcessAudio()
@@ -665,7 +979,7 @@ bool VideoPlayer::ProcessAudio()
     if (_audioFrameQueue.empty())
     {
         _audioOut->Poll();
-        return !_audioOut->IsEmpty();
+        return !_audioOut->IsEmpty() || !IsAudioInputOver();
     }
 
 #if (VIDEO_TEST_DESYNC)
@@ -704,7 +1018,7 @@ bool VideoPlayer::ProcessAudio()
             // Push used frame back to the pool
             _audioQueueDurMs -= aframe->DurationMs();
             assert(_audioQueueDurMs >= 0.f);
-            _audioFramePool.push(std::move(aframe));
+            ReleaseAudioFrame(std::move(aframe));
         }
         else
         {
@@ -34,11 +34,18 @@
 #include <deque>
 #include <memory>
 #include <stack>
+#if !defined(AGS_DISABLE_THREADS)
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
 #include "ac/timer.h"
 #include "gfx/bitmap.h"
 #include "media/audio/audiodefines.h"
 #include "media/audio/openalsource.h"
 #include "util/error.h"
+#include "util/spscqueue.h"
 #include "util/stream.h"
 #include "util/time_util.h"
 
@@ -67,6 +74,10 @@ enum VideoFlags
     // Must accumulate decoded frames, when format's frames
     // do not have a full image, but diff from the previous frame
     kVideo_AccumFrame     = 0x0080,
+    // Decode frames ahead on a separate thread, which fills a short queue
+    // of ready frames; the decoder implementation must not depend on the
+    // thread it's called from. Ignored if the threads are disabled.
+    kVideo_DecodeAhead    = 0x0100,
 };
 
 // Parent video player class, provides basic playback logic,
@@ -88,6 +99,8 @@ public:
     virtual bool IsValid() { return false; }
     bool HasVideo() const { return (_flags & kVideo_EnableVideo) != 0; }
     bool HasAudio() const { return (_flags & kVideo_EnableAudio) != 0; }
+    // Tells if the frames are decoded ahead on a separate thread
+    bool IsDecodingAhead() const { return _decodeAhead; }
     // Assigns a wanted target bitmap size
     void SetTargetFrame(const Size &target_sz);
     // Begins or resumes playback
@@ -183,12 +196,13 @@ private:
     struct VideoFrame
     {
         VideoFrame() = default;
-        VideoFrame(std::unique_ptr<Common::Bitmap> &&bmp, float ts = -1.f)
-            : _bmp(std::move(bmp)), _ts(ts) {}
+        VideoFrame(std::unique_ptr<Common::Bitmap> &&bmp, float ts = -1.f, float input_ms = 0.f)
+            : _bmp(std::move(bmp)), _ts(ts), _inputMs(input_ms) {}
 
         const Common::Bitmap *Bitmap() const { return _bmp.get(); }
         float Timestamp() const { return _ts; }
         void SetTimestamp(float ts) { _ts = ts; }
+        float InputTimeMs() const { return _inputMs; }
 
         std::unique_ptr<Common::Bitmap> Retrieve()
         {
@@ -198,16 +212,69 @@ private:
     private:
         std::unique_ptr<Common::Bitmap> _bmp;
         float _ts = -1.f; // negative means undefined
+        float _inputMs = 0.f; // time spent decoding this frame
     };
 
+    // Audio frame passed from the decoder thread
+    struct AudioFrame
+    {
+        AudioFrame() = default;
+        AudioFrame(std::unique_ptr<SoundBuffer> &&buf, float input_ms)
+            : Buf(std::move(buf)), InputMs(input_ms) {}
+
+        std::unique_ptr<SoundBuffer> Buf;
+        float InputMs = 0.f; // time spent decoding this frame
+    };
+
+    // Number of frames which the decoder thread may prepare ahead,
+    // in addition to the frames in the player's own queue
+    static const size_t DecodeAheadVideoFrames = 3u;
+    static const size_t DecodeAheadAudioFrames = 8u;
+    // Max time the decoder thread sleeps when there's no work, in ms
+    static const int DecoderIdleMs = 5;
+
     // Rewind the stream to start and reset playback pos
     bool Rewind();
     // Resume after pause
     void ResumeImpl();
     // Read and queue video frames
     void BufferVideo();
+    // Buffers video, and, if decoding ahead, waits until at least one
+    // frame is available or the video is over
+    void BufferVideoOrWait();
     // Read and queue audio frames
     void BufferAudio();
+    // Decodes next video frame into the target bitmap, converting it to the
+    // target size and color depth if necessary; returns time spent in input_ms.
+    // May be called from the decoder thread, so must not touch player's stats.
+    bool DecodeVideoFrame(Common::Bitmap *target_frame, float &frame_ts, float &input_ms);
+    // Decodes next audio frame; returns time spent in input_ms
+    bool DecodeAudioFrame(SoundBuffer &aframe, float &input_ms);
+    // Record input stats for the decoded frames; called on the player's thread
+    void RecordVideoInput(const Common::Bitmap *frame, float input_ms);
+    void RecordAudioInput(const SoundBuffer &aframe, float input_ms);
+    // Puts decoded frames into the playback queues; the video timestamp
+    // is converted to the current playback speed
+    void QueueVideoFrame(std::unique_ptr<Common::Bitmap> frame, float frame_ts);
+    void QueueAudioFrame(std::unique_ptr<SoundBuffer> aframe);
+    // Returns used frames for the reuse
+    void ReleaseVideoFrame(std::unique_ptr<Common::Bitmap> frame);
+    void ReleaseAudioFrame(std::unique_ptr<SoundBuffer> aframe);
+    // Tells if there will be no more frames from the decoder
+    bool IsVideoInputOver() const;
+    bool IsAudioInputOver() const;
+#if !defined(AGS_DISABLE_THREADS)
+    // Starts the decoder thread, unless it's already running
+    void StartDecoder();
+    // Stops the decoder thread and waits for it to finish
+    void StopDecoder();
+    // Disposes all the frames in the decoder queues
+    void ResetDecoderQueues();
+    // Wakes the decoder thread after the frames were taken from its queues
+    void WakeDecoder();
+    // The decoder thread's function
+    void DecodeProc();
+#endif
     // Update statistic records
     void UpdateStats();
     // Update playback timing
@@ -231,6 +298,10 @@ private:
     // Parameters
     String _name;
     int _flags = 0;
+    // Tells if decoding ahead is currently used; this is only allowed
+    // when the frames do not have to be stretched, because bitmap lib's
+    // stretching relies on a global state and may run on the main thread
+    bool _decodeAhead = false;
     // Output video frame's color depth and size
     Size _targetSize;
     int _targetDepth = 0;
@@ -285,6 +356,29 @@ private:
     std::stack<std::unique_ptr<Common::Bitmap>> _videoFramePool;
     std::deque<std::unique_ptr<VideoFrame>> _videoFrameQueue;
 
+#if !defined(AGS_DISABLE_THREADS)
+    // Decoding ahead
+    std::thread _decoderThread;
+    std::mutex _decoderMutex; // used only for waking up the decoder thread
+    std::condition_variable _decoderCV;
+    bool _decoderWake = false;
+    std::atomic<bool> _decoderQuit{false};
+    // Set by decoder when there are no more frames in the respective stream
+    std::atomic<bool> _videoDecoded{false};
+    std::atomic<bool> _audioDecoded{false};
+    // Frames with timestamps (in video's own time) below this may be dropped
+    // by decoder without decoding; negative value means no dropping
+    std::atomic<float> _decoderDropTs{-1.f};
+    // Number of frames dropped by decoder, not yet added to the stats
+    std::atomic<uint32_t> _decoderDropped{0u};
+    // Decoded frames, passed from the decoder thread to the player
+    SpscQueue<VideoFrame> _decodedVideo;
+    SpscQueue<AudioFrame> _decodedAudio;
+    // Used frames, passed from the player back to decoder for the reuse
+    SpscQueue<std::unique_ptr<Common::Bitmap>> _freeVideo;
+    SpscQueue<std::unique_ptr<SoundBuffer>> _freeAudio;
+#endif
+
     // Statistics
     struct Statistics
     {
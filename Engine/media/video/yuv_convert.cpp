@@ -0,0 +1,178 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2026 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+#include "media/video/yuv_convert.h"
+#include <algorithm>
+#include <assert.h>
+#include <string.h> // memcpy
+#include <allegro.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define AGS_YUVCONVERT_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace AGS
+{
+namespace Engine
+{
+
+using namespace Common;
+
+// Conversion coefficients, in 13-bit fixed point:
+//  R = 1.164*(Y - 16)                   + 1.596*(V - 128)
+//  G = 1.164*(Y - 16) - 0.391*(U - 128) - 0.813*(V - 128)
+//  B = 1.164*(Y - 16) + 2.018*(U - 128)
+const int FixShift = 13;
+const int FixRound = 1 << (FixShift - 1);
+const int CoefY  = 9539;  // 255 / 219
+const int CoefRV = 13074; // 1.596
+const int CoefGU = 3203;  // 0.391
+const int CoefGV = 6660;  // 0.813
+const int CoefBU = 16531; // 2.018
+
+static inline uint32_t ClampToByte(int v)
+{
+    return static_cast<uint32_t>(std::min(255, std::max(0, v)));
+}
+
+static inline uint32_t YUVToRGB32(int y, int u, int v,
+    int r_shift, int g_shift, int b_shift, uint32_t alpha)
+{
+    const int yc = (y - 16) * CoefY + FixRound;
+    const int uc = u - 128, vc = v - 128;
+    const uint32_t r = ClampToByte((yc + vc * CoefRV) >> FixShift);
+    const uint32_t g = ClampToByte((yc - uc * CoefGU - vc * CoefGV) >> FixShift);
+    const uint32_t b = ClampToByte((yc + uc * CoefBU) >> FixShift);
+    return (r << r_shift) | (g << g_shift) | (b << b_shift) | alpha;
+}
+
+// Converts a range of pixels in a row, starting with the given x
+static void ConvertRowGeneric(const uint8_t *y_row, const uint8_t *u_row, const uint8_t *v_row,
+    int x, int width, uint32_t *dst_row)
+{
+    // NOTE: copy the pixel format into locals, as the compiler would have
+    // to reload globals after each write to the destination otherwise
+    const int r_shift = _rgb_r_shift_32, g_shift = _rgb_g_shift_32, b_shift = _rgb_b_shift_32;
+    const uint32_t alpha = 0xFFu << _rgb_a_shift_32;
+    for (; x < width; ++x)
+        dst_row[x] = YUVToRGB32(y_row[x], u_row[x >> 1], v_row[x >> 1], r_shift, g_shift, b_shift, alpha);
+}
+
+#if defined(AGS_YUVCONVERT_SSE2)
+// Calculates 8 channel values from the pairs of 16-bit components,
+// multiplied by the pairs of coefficients, clamped to 0-255 range,
+// and returned in the low 8 bytes of the register
+static inline __m128i ChannelSSE2(__m128i a_lo, __m128i a_hi, __m128i coef_a,
+    __m128i b_lo, __m128i b_hi, __m128i coef_b, __m128i round)
+{
+    const __m128i lo = _mm_srai_epi32(_mm_add_epi32(_mm_add_epi32(
+        _mm_madd_epi16(a_lo, coef_a), _mm_madd_epi16(b_lo, coef_b)), round), FixShift);
+    const __m128i hi = _mm_srai_epi32(_mm_add_epi32(_mm_add_epi32(
+        _mm_madd_epi16(a_hi, coef_a), _mm_madd_epi16(b_hi, coef_b)), round), FixShift);
+    return _mm_packus_epi16(_mm_packs_epi32(lo, hi), _mm_setzero_si128());
+}
+
+// Converts pixels of a row 8 at a time, returns the number of pixels done
+static int ConvertRowSSE2(const uint8_t *y_row, const uint8_t *u_row, const uint8_t *v_row,
+    int width, uint32_t *dst_row)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i round = _mm_set1_epi32(FixRound);
+    const __m128i y_off = _mm_set1_epi16(16);
+    const __m128i uv_off = _mm_set1_epi16(128);
+    // Coefficients are applied to the interleaved pairs of components:
+    // (Y, V) for red, (Y, U) and (V, 0) for green, (Y, U) for blue
+    const __m128i coef_r = _mm_setr_epi16(CoefY, CoefRV, CoefY, CoefRV, CoefY, CoefRV, CoefY, CoefRV);
+    const __m128i coef_g1 = _mm_setr_epi16(CoefY, -CoefGU, CoefY, -CoefGU, CoefY, -CoefGU, CoefY, -CoefGU);
+    const __m128i coef_g2 = _mm_setr_epi16(-CoefGV, 0, -CoefGV, 0, -CoefGV, 0, -CoefGV, 0);
+    const __m128i coef_b = _mm_setr_epi16(CoefY, CoefBU, CoefY, CoefBU, CoefY, CoefBU, CoefY, CoefBU);
+    const __m128i shift_r = _mm_cvtsi32_si128(_rgb_r_shift_32);
+    const __m128i shift_g = _mm_cvtsi32_si128(_rgb_g_shift_32);
+    const __m128i shift_b = _mm_cvtsi32_si128(_rgb_b_shift_32);
+    const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xFFu << _rgb_a_shift_32));
+
+    int x = 0;
+    for (; x + 8 <= width; x += 8)
+    {
+        int32_t u4, v4;
+        memcpy(&u4, u_row + (x >> 1), sizeof(u4));
+        memcpy(&v4, v_row + (x >> 1), sizeof(v4));
+        __m128i u8 = _mm_cvtsi32_si128(u4);
+        __m128i v8 = _mm_cvtsi32_si128(v4);
+        u8 = _mm_unpacklo_epi8(u8, u8); // each chroma sample covers 2 pixels
+        v8 = _mm_unpacklo_epi8(v8, v8);
+        const __m128i y16 = _mm_sub_epi16(_mm_unpacklo_epi8(
+            _mm_loadl_epi64(reinterpret_cast<const __m128i*>(y_row + x)), zero), y_off);
+        const __m128i u16 = _mm_sub_epi16(_mm_unpacklo_epi8(u8, zero), uv_off);
+        const __m128i v16 = _mm_sub_epi16(_mm_unpacklo_epi8(v8, zero), uv_off);
+
+        const __m128i yv_lo = _mm_unpacklo_epi16(y16, v16), yv_hi = _mm_unpackhi_epi16(y16, v16);
+        const __m128i yu_lo = _mm_unpacklo_epi16(y16, u16), yu_hi = _mm_unpackhi_epi16(y16, u16);
+        const __m128i v0_lo = _mm_unpacklo_epi16(v16, zero), v0_hi = _mm_unpackhi_epi16(v16, zero);
+        const __m128i r = ChannelSSE2(yv_lo, yv_hi, coef_r, zero, zero, zero, round);
+        const __m128i g = ChannelSSE2(yu_lo, yu_hi, coef_g1, v0_lo, v0_hi, coef_g2, round);
+        const __m128i b = ChannelSSE2(yu_lo, yu_hi, coef_b, zero, zero, zero, round);
+
+        const __m128i r16 = _mm_unpacklo_epi8(r, zero);
+        const __m128i g16 = _mm_unpacklo_epi8(g, zero);
+        const __m128i b16 = _mm_unpacklo_epi8(b, zero);
+        const __m128i px_lo = _mm_or_si128(_mm_or_si128(alpha,
+            _mm_sll_epi32(_mm_unpacklo_epi16(r16, zero), shift_r)),
+            _mm_or_si128(_mm_sll_epi32(_mm_unpacklo_epi16(g16, zero), shift_g),
+                         _mm_sll_epi32(_mm_unpacklo_epi16(b16, zero), shift_b)));
+        const __m128i px_hi = _mm_or_si128(_mm_or_si128(alpha,
+            _mm_sll_epi32(_mm_unpackhi_epi16(r16, zero), shift_r)),
+            _mm_or_si128(_mm_sll_epi32(_mm_unpackhi_epi16(g16, zero), shift_g),
+                         _mm_sll_epi32(_mm_unpackhi_epi16(b16, zero), shift_b)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst_row + x), px_lo);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst_row + x + 4), px_hi);
+    }
+    return x;
+}
+#endif // AGS_YUVCONVERT_SSE2
+
+static void ConvertYUV420(const YUV420Planes &src, int width, int height, Bitmap *dst, bool use_simd)
+{
+    assert(dst->GetColorDepth() == 32);
+    width = std::min(width, dst->GetWidth());
+    height = std::min(height, dst->GetHeight());
+    for (int y = 0; y < height; ++y)
+    {
+        const uint8_t *y_row = src.Y + y * src.YStride;
+        const uint8_t *u_row = src.U + (y >> 1) * src.UVStride;
+        const uint8_t *v_row = src.V + (y >> 1) * src.UVStride;
+        uint32_t *dst_row = reinterpret_cast<uint32_t*>(dst->GetScanLineForWriting(y));
+        int x = 0;
+#if defined(AGS_YUVCONVERT_SSE2)
+        if (use_simd)
+            x = ConvertRowSSE2(y_row, u_row, v_row, width, dst_row);
+#else
+        (void)use_simd;
+#endif
+        ConvertRowGeneric(y_row, u_row, v_row, x, width, dst_row);
+    }
+}
+
+void ConvertYUV420ToRGB32(const YUV420Planes &src, int width, int height, Bitmap *dst)
+{
+    ConvertYUV420(src, width, height, dst, true);
+}
+
+void ConvertYUV420ToRGB32Generic(const YUV420Planes &src, int width, int height, Bitmap *dst)
+{
+    ConvertYUV420(src, width, height, dst, false);
+}
+
+} // namespace Engine
+} // namespace AGS
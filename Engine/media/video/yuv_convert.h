@@ -0,0 +1,54 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2026 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+//
+// Conversion of the decoded planar YUV video frames into RGB bitmaps.
+//
+// The conversion uses ITU-R BT.601 coefficients with "video range" input,
+// same as APEG's own converter, but in 13-bit fixed point math, so that the
+// SSE2 implementation gives exactly same result as the generic one.
+//
+//=============================================================================
+#ifndef __AGS_EE_MEDIA__YUVCONVERT_H
+#define __AGS_EE_MEDIA__YUVCONVERT_H
+
+#include "platform/types.h"
+#include "gfx/bitmap.h"
+
+namespace AGS
+{
+namespace Engine
+{
+
+// Planar YUV 4:2:0 image: the chroma planes have half the width and height
+// of the luma plane; strides are in bytes
+struct YUV420Planes
+{
+    const uint8_t *Y = nullptr;
+    const uint8_t *U = nullptr;
+    const uint8_t *V = nullptr;
+    int YStride = 0;
+    int UVStride = 0;
+};
+
+// Converts the top-left width x height part of the YUV 4:2:0 image into the
+// 32-bit bitmap, writing directly into the bitmap's pixels; uses SIMD
+// instructions where available. The bitmap must be at least of the given size.
+void ConvertYUV420ToRGB32(const YUV420Planes &src, int width, int height, Common::Bitmap *dst);
+// Generic implementation of the above, with no use of SIMD instructions
+void ConvertYUV420ToRGB32Generic(const YUV420Planes &src, int width, int height, Common::Bitmap *dst);
+
+} // namespace Engine
+} // namespace AGS
+
+#endif // __AGS_EE_MEDIA__YUVCONVERT_H
@@ -23,6 +23,7 @@
 #include "ac/dynobj/managedobjectpool.h"
 #include "ac/dynobj/scriptstring.h"
 #include "ac/dynobj/scriptuserobject.h"
+#include "debug/profiler.h"
 #include "script/cc_common.h"
 #include "script/script_runtime.h"
 
@@ -379,6 +380,7 @@ bool ccInstance::FindExportedFunction(const String &fn_name, int32_t &start_at,
 
 ccInstError ccInstance::CallScriptFunction(const String &funcname, int32_t numargs, const RuntimeScriptValue *params)
 {
+    AGS_PROFILE_ZONE("ccInstance::CallScriptFunction");
     cc_clear_error();
     currentline = 0;
 
@@ -50,6 +50,7 @@ extern void RegisterScreenAPI();
 extern void RegisterSliderAPI();
 extern void RegisterSpeechAPI(ScriptAPIVersion base_api, ScriptAPIVersion compat_api);
 extern void RegisterStringAPI();
+extern void RegisterStringBuilderAPI();
 extern void RegisterSystemAPI();
 extern void RegisterTextBoxAPI();
 extern void RegisterUtilsAPI();
@@ -93,6 +94,7 @@ void setup_script_exports(ScriptAPIVersion base_api, ScriptAPIVersion compat_api
     RegisterSliderAPI();
     RegisterSpeechAPI(base_api, compat_api);
     RegisterStringAPI();
+    RegisterStringBuilderAPI();
     RegisterSystemAPI();
     RegisterTextBoxAPI();
     RegisterUtilsAPI();
@@ -11,6 +11,7 @@
 // https://opensource.org/license/artistic-2-0/
 //
 //=============================================================================
+#include <algorithm>
 #include <stdio.h>
 #include <string.h>
 #include "script/script.h"
@@ -41,8 +42,11 @@
 #include "main/game_run.h"
 #include "script/script_runtime.h"
 #include "util/string_compat.h"
+#include "util/time_util.h"
 #include "media/audio/audio_system.h"
 
+using namespace AGS::Engine;
+
 extern GameSetupStruct game;
 extern int gameHasBeenRestored, displayed_room;
 extern unsigned int load_new_game;
@@ -66,8 +70,8 @@ int post_script_cleanup_stack = 0;
 int inside_script=0,in_graph_script=0;
 int no_blocking_functions = 0; // set to 1 while in rep_Exec_always
 
-NonBlockingScriptFunction repExecAlways(REP_EXEC_ALWAYS_NAME, 0);
-NonBlockingScriptFunction lateRepExecAlways(LATE_REP_EXEC_ALWAYS_NAME, 0);
+NonBlockingScriptFunction repExecAlways(REP_EXEC_ALWAYS_NAME, 0, true);
+NonBlockingScriptFunction lateRepExecAlways(LATE_REP_EXEC_ALWAYS_NAME, 0, true);
 NonBlockingScriptFunction getDialogOptionsDimensionsFunc("dialog_options_get_dimensions", 1);
 NonBlockingScriptFunction renderDialogOptionsFunc("dialog_options_render", 1);
 NonBlockingScriptFunction getDialogOptionUnderCursorFunc("dialog_options_get_active", 1);
@@ -86,9 +90,80 @@ std::vector<UInstance> moduleInstFork;
 std::vector<RuntimeScriptValue> moduleRepExecAddr;
 size_t numScriptModules = 0;
 
+// All the non-blocking callbacks, for testing which scripts have them
+static NonBlockingScriptFunction *const nonBlockingFuncs[] = {
+    &repExecAlways, &lateRepExecAlways, &getDialogOptionsDimensionsFunc,
+    &renderDialogOptionsFunc, &getDialogOptionUnderCursorFunc,
+    &runDialogOptionMouseClickHandlerFunc, &runDialogOptionKeyPressHandlerFunc,
+    &runDialogOptionTextInputHandlerFunc, &runDialogOptionRepExecFunc,
+    &runDialogOptionCloseFunc
+};
+
+// Rep-exec schedule: run intervals of the scheduled non-blocking callbacks
+// per script module, the last element is for the global script
+static std::vector<uint32_t> repExecInterval;
+// Time budget for the scheduled callbacks in one game frame, zero if disabled
+static Clock::duration repExecBudget = Clock::duration::zero();
+// Time spent in the scheduled callbacks during the current game frame
+static Clock::duration repExecFrameTime = Clock::duration::zero();
+static uint32_t repExecFrame = 0u; // loop counter of the measured frame
+static uint32_t repExecWarnFrame = 0u; // loop counter of the last budget warning
+static bool repExecWarned = false;
+
 
 static bool DoRunScriptFuncCantBlock(ccInstance *sci, NonBlockingScriptFunction* funcToRun, bool hasTheFunc);
 
+// Tells if the scheduled callback of the given script is due on this game tick;
+// the scripts which have same interval are spread over different ticks
+static bool IsRepExecDue(size_t script_index)
+{
+    if (script_index >= repExecInterval.size())
+        return true;
+    const uint32_t interval = repExecInterval[script_index];
+    return (interval <= 1u) || ((get_loop_counter() + script_index) % interval == 0u);
+}
+
+// Adds the time spent in the scheduled callback to the frame's total,
+// and warns if the frame has exceeded the time budget
+static void CheckRepExecBudget(ccInstance *sci, NonBlockingScriptFunction *funcToRun, Clock::duration spent)
+{
+    const uint32_t loop_counter = get_loop_counter();
+    if (loop_counter != repExecFrame)
+    {
+        repExecFrame = loop_counter;
+        repExecFrameTime = Clock::duration::zero();
+    }
+    repExecFrameTime += spent;
+    if (repExecFrameTime <= repExecBudget)
+        return;
+    // Don't flood the log, warn at most once per second of game time
+    if (repExecWarned && (loop_counter - repExecWarnFrame < static_cast<uint32_t>(GetGameSpeed())))
+        return;
+    repExecWarned = true;
+    repExecWarnFrame = loop_counter;
+    Debug::Printf(kDbgGroup_Script, kDbgMsg_Warn,
+        "Script frame budget exceeded: %.2f ms spent in the non-blocking callbacks (budget: %.2f ms); %s in '%s' took %.2f ms",
+        ToMillisecondsF(repExecFrameTime), ToMillisecondsF(repExecBudget),
+        funcToRun->FunctionName.GetCStr(), sci->GetScript()->GetScriptName().c_str(), ToMillisecondsF(spent));
+}
+
+// Runs the non-blocking callback in the given script, following the rep-exec
+// schedule if the callback uses one; script_index is the schedule's index
+static bool DoRunScheduledFuncCantBlock(ccInstance *sci, NonBlockingScriptFunction *funcToRun,
+    bool hasTheFunc, size_t script_index)
+{
+    if (!funcToRun->UseSchedule)
+        return DoRunScriptFuncCantBlock(sci, funcToRun, hasTheFunc);
+    if (!hasTheFunc || !IsRepExecDue(script_index))
+        return hasTheFunc;
+    if (repExecBudget == Clock::duration::zero())
+        return DoRunScriptFuncCantBlock(sci, funcToRun, hasTheFunc);
+
+    const auto start = Clock::now();
+    hasTheFunc = DoRunScriptFuncCantBlock(sci, funcToRun, hasTheFunc);
+    CheckRepExecBudget(sci, funcToRun, Clock::now() - start);
+    return hasTheFunc;
+}
 
 void run_function_on_non_blocking_thread(NonBlockingScriptFunction* funcToRun) {
 
@@ -100,18 +175,67 @@ void run_function_on_non_blocking_thread(NonBlockingScriptFunction* funcToRun) {
     // run modules
     // modules need a forkedinst for this to work
     for (size_t i = 0; i < numScriptModules; ++i) {
-        funcToRun->ModuleHasFunction[i] = DoRunScriptFuncCantBlock(moduleInstFork[i].get(), funcToRun, funcToRun->ModuleHasFunction[i]);
+        if (!funcToRun->ModuleHasFunction[i])
+            continue; // skip quickly, most modules don't have most callbacks
+
+        funcToRun->ModuleHasFunction[i] = DoRunScheduledFuncCantBlock(moduleInstFork[i].get(), funcToRun, funcToRun->ModuleHasFunction[i], i);
 
         if (room_changes_was != play.room_changes)
             return;
     }
 
-    funcToRun->GlobalScriptHasFunction = DoRunScriptFuncCantBlock(gameinstFork.get(), funcToRun, funcToRun->GlobalScriptHasFunction);
+    funcToRun->GlobalScriptHasFunction = DoRunScheduledFuncCantBlock(gameinstFork.get(), funcToRun, funcToRun->GlobalScriptHasFunction, numScriptModules);
 
     if (room_changes_was != play.room_changes)
         return;
 
-    funcToRun->RoomHasFunction = DoRunScriptFuncCantBlock(roominstFork.get(), funcToRun, funcToRun->RoomHasFunction);
+    // NOTE: room script is not throttled, as its schedule would not persist between rooms
+    funcToRun->RoomHasFunction = DoRunScheduledFuncCantBlock(roominstFork.get(), funcToRun, funcToRun->RoomHasFunction, SIZE_MAX);
+}
+
+bool SetScriptRepExecInterval(const ccInstance *inst, int interval)
+{
+    if (!inst)
+        return false;
+    for (size_t i = 0; i < numScriptModules; ++i)
+    {
+        if (inst->GetScript() == moduleInst[i]->GetScript())
+        {
+            repExecInterval[i] = std::max(1, interval);
+            return true;
+        }
+    }
+    if (gameinst && (inst->GetScript() == gameinst->GetScript()))
+    {
+        repExecInterval[numScriptModules] = std::max(1, interval);
+        return true;
+    }
+    return false;
+}
+
+void SetScriptRepExecBudget(int budget_ms)
+{
+    repExecBudget = std::chrono::milliseconds(std::max(0, budget_ms));
+    repExecFrameTime = Clock::duration::zero();
+    repExecWarned = false;
+}
+
+// Tests which of the non-blocking callbacks exist in the script modules
+// and the global script, so that the missing ones are never looked up
+static void FindNonBlockingFunctions()
+{
+    for (auto *func : nonBlockingFuncs)
+    {
+        for (size_t i = 0; i < numScriptModules; ++i)
+            func->ModuleHasFunction[i] = DoesScriptFunctionExist(moduleInst[i].get(), func->FunctionName);
+        func->GlobalScriptHasFunction = DoesScriptFunctionExist(gameinst.get(), func->FunctionName);
+    }
+}
+
+void FindNonBlockingFunctionsInRoom()
+{
+    for (auto *func : nonBlockingFuncs)
+        func->RoomHasFunction = DoesScriptFunctionExist(roominst.get(), func->FunctionName);
 }
 
 // Runs old-style interaction command list
@@ -293,6 +417,8 @@ HError create_game_scripts()
         return new Error(String::FromFormat("Failed to create non-blocking fork for the global script:\n%s",
             cc_get_error().ErrorString.GetCStr()));
 
+    FindNonBlockingFunctions();
+
     ccSetOption(SCOPT_AUTOIMPORT, 0);
     return HError::None();
 }
@@ -611,6 +737,7 @@ void AllocScriptModules()
     runDialogOptionTextInputHandlerFunc.ModuleHasFunction.resize(numScriptModules, true);
     runDialogOptionRepExecFunc.ModuleHasFunction.resize(numScriptModules, true);
     runDialogOptionCloseFunc.ModuleHasFunction.resize(numScriptModules, true);
+    repExecInterval.assign(numScriptModules + 1, 1u);
     for (auto &val : moduleRepExecAddr)
     {
         val.Invalidate();
@@ -657,6 +784,7 @@ void FreeGlobalScripts()
     runDialogOptionTextInputHandlerFunc.ModuleHasFunction.clear();
     runDialogOptionRepExecFunc.ModuleHasFunction.clear();
     runDialogOptionCloseFunc.ModuleHasFunction.clear();
+    repExecInterval.clear();
 }
 
 //=============================================================================
@@ -88,18 +88,31 @@ struct NonBlockingScriptFunction
     bool GlobalScriptHasFunction;
     std::vector<bool> ModuleHasFunction;
     bool AtLeastOneImplementationExists;
+    // Whether this callback follows the rep-exec schedule: the scripts'
+    // run intervals and the per-frame time budget
+    bool UseSchedule;
 
-    NonBlockingScriptFunction(const String &fn_name, int param_count)
+    NonBlockingScriptFunction(const String &fn_name, int param_count, bool use_schedule = false)
     {
         FunctionName = fn_name;
         ParamCount = param_count;
         AtLeastOneImplementationExists = false;
         RoomHasFunction = true;
         GlobalScriptHasFunction = true;
+        UseSchedule = use_schedule;
     }
 };
 
 void    run_function_on_non_blocking_thread(NonBlockingScriptFunction* funcToRun);
+// Tests which of the non-blocking callbacks exist in the current room script
+void    FindNonBlockingFunctionsInRoom();
+// Sets the interval, in game ticks, at which the scheduled non-blocking callbacks
+// (repeatedly_execute_always and late_repeatedly_execute_always) of the given
+// script are run; only supported for the script modules and global script.
+bool    SetScriptRepExecInterval(const ccInstance *inst, int interval);
+// Sets the time budget for the scheduled non-blocking callbacks in a single
+// game frame, in milliseconds; exceeding it is reported to the log. 0 disables.
+void    SetScriptRepExecBudget(int budget_ms);
 
 // TODO: run_interaction_event() and run_interaction_script()
 // are in most part duplicating each other, except for the script callback run method.
@@ -0,0 +1,147 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2026 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <string.h>
+#include <vector>
+#include "gtest/gtest.h"
+#include "ac/dynobj/managedbufferpool.h"
+
+TEST(ManagedBufferPool, AllocateFree) {
+    ManagedBufferPool mpool;
+    std::vector<uint8_t*> bufs;
+    // Cover all the size classes, and the large buffers
+    for (size_t sz = 0; sz <= ManagedBufferPool::MaxBlockSize + 64; sz += 7)
+    {
+        uint8_t *buf = mpool.Allocate(sz);
+        ASSERT_NE(buf, nullptr);
+        memset(buf, static_cast<int>(sz & 0xFF), sz);
+        bufs.push_back(buf);
+    }
+    ASSERT_EQ(mpool.GetStats().InUse, bufs.size());
+    ASSERT_GT(mpool.GetStats().LargeAllocs, 0u);
+    // Check that buffers did not overwrite each other
+    for (size_t i = 0; i < bufs.size(); ++i)
+    {
+        const size_t sz = i * 7;
+        for (size_t j = 0; j < sz; ++j)
+            ASSERT_EQ(bufs[i][j], static_cast<uint8_t>(sz & 0xFF));
+    }
+
+    ASSERT_FALSE(mpool.Trim());
+    for (auto *buf : bufs)
+        mpool.Free(buf);
+    ASSERT_EQ(mpool.GetStats().InUse, 0u);
+    ASSERT_EQ(mpool.GetStats().Frees, mpool.GetStats().Allocs);
+    ASSERT_TRUE(mpool.Trim());
+    ASSERT_EQ(mpool.GetStats().SlabMemory, 0u);
+}
+
+TEST(ManagedBufferPool, ReuseFreed) {
+    ManagedBufferPool mpool;
+    uint8_t *buf1 = mpool.Allocate(40);
+    uint8_t *buf2 = mpool.Allocate(40);
+    ASSERT_NE(buf1, buf2);
+    mpool.Free(buf1);
+    // Freed block of the same size class is reused first
+    uint8_t *buf3 = mpool.Allocate(33);
+    ASSERT_EQ(buf1, buf3);
+    mpool.Free(buf2);
+    mpool.Free(buf3);
+    ASSERT_EQ(mpool.GetStats().SlabsAllocated, 1u);
+}
+
+// Simulates typical string building workloads, comparing the plain heap
+// allocations with the managed buffer pool
+TEST(ManagedBufferPool, StringBuildingPerformance) {
+    const int iterations = 200;
+    ManagedBufferPool mpool;
+    std::function<uint8_t*(size_t)> heap_alloc = [](size_t sz) { return new uint8_t[sz]; };
+    std::function<void(uint8_t*)> heap_free = [](uint8_t *buf) { delete[] buf; };
+    std::function<uint8_t*(size_t)> pool_alloc = [&mpool](size_t sz) { return mpool.Allocate(sz); };
+    std::function<void(uint8_t*)> pool_free = [&mpool](uint8_t *buf) { mpool.Free(buf); };
+
+    // s = s.Append("x") in a loop: each step creates a new string one char longer
+    auto append_loop = [](const std::function<uint8_t*(size_t)> &alloc,
+                          const std::function<void(uint8_t*)> &free)
+    {
+        size_t checksum = 0u;
+        for (int i = 0; i < iterations; ++i)
+        {
+            uint8_t *s = alloc(1);
+            s[0] = 0;
+            for (size_t len = 1; len < 200; ++len)
+            {
+                uint8_t *ns = alloc(len + 1);
+                memcpy(ns, s, len - 1);
+                ns[len - 1] = 'x';
+                ns[len] = 0;
+                free(s);
+                s = ns;
+            }
+            checksum += s[0];
+            free(s);
+        }
+        return checksum;
+    };
+    // String.Format, Substring and similar: a number of short-lived
+    // strings of various lengths, some of them are kept for a while
+    auto format_loop = [](const std::function<uint8_t*(size_t)> &alloc,
+                          const std::function<void(uint8_t*)> &free)
+    {
+        size_t checksum = 0u;
+        std::vector<uint8_t*> kept;
+        for (int i = 0; i < iterations * 100; ++i)
+        {
+            const size_t len = 8 + (i * 37) % 120;
+            uint8_t *s = alloc(len + 1);
+            memset(s, 'a' + (i % 26), len);
+            s[len] = 0;
+            checksum += s[len / 2];
+            if (i % 8 == 0)
+                kept.push_back(s);
+            else
+                free(s);
+            if (kept.size() > 64)
+            {
+                for (auto *k : kept)
+                    free(k);
+                kept.clear();
+            }
+        }
+        for (auto *k : kept)
+            free(k);
+        return checksum;
+    };
+
+    auto measure = [](const std::function<size_t()> &fn, size_t &checksum)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        checksum = fn();
+        const auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::milli>(end - start).count();
+    };
+
+    size_t sum_heap, sum_pool;
+    const double t_append_heap = measure([&]() { return append_loop(heap_alloc, heap_free); }, sum_heap);
+    const double t_append_pool = measure([&]() { return append_loop(pool_alloc, pool_free); }, sum_pool);
+    ASSERT_EQ(sum_heap, sum_pool);
+    const double t_format_heap = measure([&]() { return format_loop(heap_alloc, heap_free); }, sum_heap);
+    const double t_format_pool = measure([&]() { return format_loop(pool_alloc, pool_free); }, sum_pool);
+    ASSERT_EQ(sum_heap, sum_pool);
+    ASSERT_EQ(mpool.GetStats().InUse, 0u);
+    printf("String append: heap %.2f ms, pool %.2f ms; string format: heap %.2f ms, pool %.2f ms\n",
+        t_append_heap, t_append_pool, t_format_heap, t_format_pool);
+}
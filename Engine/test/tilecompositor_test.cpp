@@ -0,0 +1,73 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2026 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+#include <memory>
+#include <string.h>
+#include <vector>
+#include "gtest/gtest.h"
+#include "gfx/tilecompositor.h"
+#include "test/gfx_test_helper.h"
+
+using namespace AGS::Common;
+using namespace AGS::Engine;
+
+// Draws a number of overlapping sprites, partially outside of the surface,
+// and compares the tiled result with the sprites drawn one by one
+static void TestCompositor(int depth, const Rect &clip)
+{
+    uint32_t seed = 12345u;
+    auto rand = [&seed](int max) { seed = seed * 1664525u + 1013904223u; return static_cast<int>((seed >> 8) % max); };
+
+    std::vector<std::unique_ptr<Bitmap>> sprites;
+    std::vector<TileDrawOp> ops;
+    for (int i = 0; i < 60; ++i)
+    {
+        sprites.emplace_back(new Bitmap(8 + rand(200), 8 + rand(150), depth));
+        FillRandom(*sprites.back(), i);
+        ops.emplace_back(sprites.back().get(), rand(700) - 60, rand(460) - 60,
+            static_cast<TileDrawOpKind>(rand(3)));
+    }
+
+    Bitmap expect(640, 400, depth), actual(640, 400, depth);
+    FillRandom(expect, 7);
+    FillRandom(actual, 7);
+    expect.SetClip(clip);
+    actual.SetClip(clip);
+
+    set_trans_blender(0, 0, 0, 100);
+    for (const auto &op : ops)
+    {
+        switch (op.Kind)
+        {
+        case kTileOp_Copy: expect.Blit(op.Src, 0, 0, op.X, op.Y, op.Src->GetWidth(), op.Src->GetHeight()); break;
+        case kTileOp_Masked: expect.Blit(op.Src, op.X, op.Y, kBitmap_Transparency); break;
+        case kTileOp_Blend: expect.TransBlendBlt(op.Src, op.X, op.Y); break;
+        }
+    }
+
+    TileCompositor compositor;
+    compositor.SetThreadCount(4);
+    ASSERT_TRUE(compositor.IsEnabled());
+    for (const auto &op : ops)
+        compositor.Add(op);
+    ASSERT_TRUE(compositor.HasPending());
+    compositor.Flush(&actual);
+    ASSERT_FALSE(compositor.HasPending());
+    ASSERT_TRUE(AreEqual(expect, actual)) << "depth " << depth;
+}
+
+TEST(TileCompositor, DrawTiled) {
+    TestCompositor(16, RectWH(0, 0, 640, 400));
+    TestCompositor(32, RectWH(0, 0, 640, 400));
+    TestCompositor(32, RectWH(33, 17, 500, 301));
+}
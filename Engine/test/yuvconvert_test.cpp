@@ -0,0 +1,119 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2026 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <string.h>
+#include <vector>
+#include "gtest/gtest.h"
+#include "media/video/yuv_convert.h"
+#include "test/gfx_test_helper.h"
+
+using namespace AGS::Common;
+using namespace AGS::Engine;
+
+// YUV 4:2:0 image, with strides larger than the image, same as APEG gives
+struct TestYUVImage
+{
+    std::vector<uint8_t> Y, U, V;
+    YUV420Planes Planes;
+
+    TestYUVImage(int width, int height, int coded_width, uint32_t seed)
+    {
+        const int coded_height = (height + 1) & ~1;
+        Y.resize(coded_width * coded_height);
+        U.resize((coded_width / 2) * (coded_height / 2));
+        V.resize(U.size());
+        for (auto *plane : { &Y, &U, &V })
+        {
+            for (auto &b : *plane)
+            {
+                seed = seed * 1664525u + 1013904223u;
+                b = static_cast<uint8_t>(seed >> 24);
+            }
+        }
+        Planes.Y = Y.data();
+        Planes.U = U.data();
+        Planes.V = V.data();
+        Planes.YStride = coded_width;
+        Planes.UVStride = coded_width / 2;
+    }
+};
+
+TEST(YUVConvert, SIMDMatchesGeneric) {
+    // Odd sizes test the row remainders and the last unpaired row
+    const Size sizes[] = { Size(320, 240), Size(37, 21), Size(7, 3), Size(1, 1) };
+    for (const auto &sz : sizes)
+    {
+        TestYUVImage img(sz.Width, sz.Height, (sz.Width + 15) & ~15, 1234u);
+        Bitmap expect(sz.Width, sz.Height, 32), actual(sz.Width, sz.Height, 32);
+        ConvertYUV420ToRGB32Generic(img.Planes, sz.Width, sz.Height, &expect);
+        ConvertYUV420ToRGB32(img.Planes, sz.Width, sz.Height, &actual);
+        ASSERT_TRUE(AreEqual(expect, actual));
+    }
+}
+
+TEST(YUVConvert, MatchesReference) {
+    const int width = 64, height = 32;
+    TestYUVImage img(width, height, width, 4321u);
+    Bitmap bmp(width, height, 32);
+    ConvertYUV420ToRGB32(img.Planes, width, height, &bmp);
+
+    auto clamp = [](double v) { return std::min(255, std::max(0, static_cast<int>(std::floor(v + 0.5)))); };
+    for (int y = 0; y < height; ++y)
+    {
+        const uint32_t *row = reinterpret_cast<const uint32_t*>(bmp.GetScanLine(y));
+        for (int x = 0; x < width; ++x)
+        {
+            const double yv = 1.164 * (img.Y[y * width + x] - 16);
+            const double u = img.U[(y / 2) * (width / 2) + x / 2] - 128;
+            const double v = img.V[(y / 2) * (width / 2) + x / 2] - 128;
+            const int r = clamp(yv + 1.596 * v);
+            const int g = clamp(yv - 0.391 * u - 0.813 * v);
+            const int b = clamp(yv + 2.018 * u);
+            ASSERT_NEAR(getr32(row[x]), r, 1);
+            ASSERT_NEAR(getg32(row[x]), g, 1);
+            ASSERT_NEAR(getb32(row[x]), b, 1);
+        }
+    }
+}
+
+TEST(YUVConvert, Performance) {
+    const int width = 1280, height = 720, iterations = 50;
+    TestYUVImage img(width, height, width, 1u);
+    // Use smooth gradients, as the random noise is not like a real video
+    for (size_t i = 0; i < img.Y.size(); ++i)
+        img.Y[i] = static_cast<uint8_t>((i % width) * 255 / width);
+    for (size_t i = 0; i < img.U.size(); ++i)
+    {
+        img.U[i] = static_cast<uint8_t>(i * 255 / img.U.size());
+        img.V[i] = static_cast<uint8_t>(255 - i * 255 / img.V.size());
+    }
+    Bitmap bmp(width, height, 32);
+
+    auto measure = [&](void(*convert)(const YUV420Planes&, int, int, Bitmap*))
+    {
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i)
+            convert(img.Planes, width, height, &bmp);
+        const auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::milli>(end - start).count() / iterations;
+    };
+
+    const double t_generic = measure(ConvertYUV420ToRGB32Generic);
+    const double t_simd = measure(ConvertYUV420ToRGB32);
+    printf("YUV 4:2:0 to RGB32, %dx%d: generic %.3f ms, optimized %.3f ms per frame\n",
+        width, height, t_generic, t_simd);
+}
@@ -0,0 +1,362 @@
+/***********************************************************
+ * AGSBlend                                                *
+ *                                                         *
+ * Description: Row kernels for blending and blurring      *
+ *              32-bit ARGB pixels.                        *
+ *                                                         *
+ * The kernels must produce exactly the same results as    *
+ * the original per-pixel code. Blend modes are looked up  *
+ * in precalculated tables; the alpha compositing, which   *
+ * involves per-pixel divisions, is done with SSE2 where   *
+ * available. Float division is exact for our purposes:    *
+ * when both operands are integers and the dividend is     *
+ * below 2^24, the truncated float quotient equals the     *
+ * integer quotient.                                       *
+ *                                                         *
+ ***********************************************************/
+
+#include "blendkernels.h"
+#include <string.h>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define AGSBLEND_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#if defined(BUILTIN_PLUGINS)
+namespace agsblend {
+#endif
+
+// Pixels are processed in chunks of this size, using a temporary buffer on stack
+#define ROW_CHUNK 256
+
+//------------------------------------------------------------------------------
+// Blend tables
+//------------------------------------------------------------------------------
+
+// Blend mode tables, indexed by [src << 8 | dst], created on demand
+static std::vector<uint8> BlendTables[kNumBlendModes];
+
+static const uint8 *GetBlendTable(int mode)
+{
+    std::vector<uint8> &table = BlendTables[mode];
+    if (table.empty())
+    {
+        table.resize(256 * 256);
+        for (int src = 0; src < 256; ++src)
+            for (int dst = 0; dst < 256; ++dst)
+                table[(src << 8) | dst] = (uint8)ChannelBlend(mode, src, dst);
+    }
+    return &table[0];
+}
+
+//------------------------------------------------------------------------------
+// Alpha compositing
+//------------------------------------------------------------------------------
+
+// Composites a single pixel of the given alpha and color over destination
+inline unsigned int CompositePixel(int srca, int srcr, int srcg, int srcb, unsigned int dest)
+{
+    const int desta = (dest >> 24) & 0xFF;
+    const int destr = (dest >> 16) & 0xFF;
+    const int destg = (dest >> 8) & 0xFF;
+    const int destb = dest & 0xFF;
+    const int finala = 255-(255-srca)*(255-desta)/255;
+    if (finala == 0)
+        return dest; // fully transparent
+    const int finalr = srca*srcr/finala + desta*destr*(255-srca)/finala/255;
+    const int finalg = srca*srcg/finala + desta*destg*(255-srca)/finala/255;
+    const int finalb = srca*srcb/finala + desta*destb*(255-srca)/finala/255;
+    return (finalr << 16) | (finalg << 8) | finalb | (finala << 24);
+}
+
+#if defined(AGSBLEND_SSE2)
+// Truncated quotient of non-negative integers, given as floats; exact for dividends below 2^24
+static inline __m128i DivTrunc(__m128 num, __m128 den)
+{
+    return _mm_cvttps_epi32(_mm_div_ps(num, den));
+}
+
+static inline __m128 ChannelF(__m128i px, int shift)
+{
+    return _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(px, shift), _mm_set1_epi32(0xFF)));
+}
+#endif
+
+// Composites a row of "blended" pixels over destination: these have
+// the resulting color and the sprite's alpha multiplied by opacity;
+// pixels with zero alpha leave destination unchanged
+static void CompositeRow(const unsigned int *blend, unsigned int *dst, int count)
+{
+    int i = 0;
+#if defined(AGSBLEND_SSE2)
+    const __m128 f255 = _mm_set1_ps(255.f);
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m128i b = _mm_loadu_si128((const __m128i*)(blend + i));
+        const __m128i d = _mm_loadu_si128((const __m128i*)(dst + i));
+        const __m128i skip = _mm_cmpeq_epi32(_mm_srli_epi32(b, 24), _mm_setzero_si128());
+        if (_mm_movemask_epi8(skip) == 0xFFFF)
+            continue;
+
+        const __m128 srca = ChannelF(b, 24);
+        const __m128 desta = ChannelF(d, 24);
+        const __m128 inv_srca = _mm_sub_ps(f255, srca);
+        // finala = 255 - (255 - srca) * (255 - desta) / 255
+        const __m128i finala = _mm_sub_epi32(_mm_set1_epi32(255),
+            DivTrunc(_mm_mul_ps(inv_srca, _mm_sub_ps(f255, desta)), f255));
+        const __m128 finala_f = _mm_cvtepi32_ps(finala);
+        // (a / finala / 255) equals to (a / (finala * 255)) for non-negative integers
+        const __m128 finala255_f = _mm_mul_ps(finala_f, f255);
+        const __m128 dest_k = _mm_mul_ps(desta, inv_srca);
+
+        __m128i result = _mm_slli_epi32(finala, 24);
+        for (int shift = 0; shift <= 16; shift += 8)
+        {
+            const __m128i c = _mm_add_epi32(
+                DivTrunc(_mm_mul_ps(srca, ChannelF(b, shift)), finala_f),
+                DivTrunc(_mm_mul_ps(dest_k, ChannelF(d, shift)), finala255_f));
+            // NOTE: shift by a variable count, as the immediate form requires a constant
+            result = _mm_or_si128(result, _mm_sll_epi32(c, _mm_cvtsi32_si128(shift)));
+        }
+
+        result = _mm_or_si128(_mm_and_si128(skip, d), _mm_andnot_si128(skip, result));
+        _mm_storeu_si128((__m128i*)(dst + i), result);
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        if ((blend[i] >> 24) != 0)
+            dst[i] = CompositePixel(blend[i] >> 24, (blend[i] >> 16) & 0xFF, (blend[i] >> 8) & 0xFF,
+                blend[i] & 0xFF, dst[i]);
+    }
+}
+
+//------------------------------------------------------------------------------
+// Public kernels
+//------------------------------------------------------------------------------
+
+void BlendSpriteRow(const unsigned int *src, unsigned int *dst, int count, int mode, int opacity)
+{
+    if (mode < 0 || mode >= kNumBlendModes)
+        mode = 0;
+    const uint8 *table = (mode != 0) ? GetBlendTable(mode) : nullptr;
+    if (opacity < 0 || opacity > 100)
+    {
+        // Resulting alpha may be out of range and cannot be packed into a pixel,
+        // so process this unusual case separately
+        for (int i = 0; i < count; ++i)
+        {
+            if ((src[i] >> 24) == 0)
+                continue;
+            const int srca = (int)(src[i] >> 24) * opacity / 100;
+            const int srcr = (src[i] >> 16) & 0xFF, srcg = (src[i] >> 8) & 0xFF, srcb = src[i] & 0xFF;
+            const int destr = (dst[i] >> 16) & 0xFF, destg = (dst[i] >> 8) & 0xFF, destb = dst[i] & 0xFF;
+            dst[i] = CompositePixel(srca, ChannelBlend(mode, srcr, destr), ChannelBlend(mode, srcg, destg),
+                ChannelBlend(mode, srcb, destb), dst[i]);
+        }
+        return;
+    }
+    unsigned int blend[ROW_CHUNK];
+    for (int chunk = 0; chunk < count; chunk += ROW_CHUNK)
+    {
+        const int n = std::min(ROW_CHUNK, count - chunk);
+        const unsigned int *s = src + chunk;
+        const unsigned int *d = dst + chunk;
+        for (int i = 0; i < n; ++i)
+        {
+            const unsigned int srca = (s[i] >> 24) * opacity / 100;
+            if (table)
+            {
+                blend[i] = (srca << 24) |
+                    (table[((s[i] >> 8) & 0xFF00) | ((d[i] >> 16) & 0xFF)] << 16) |
+                    (table[(s[i] & 0xFF00) | ((d[i] >> 8) & 0xFF)] << 8) |
+                    (table[((s[i] << 8) & 0xFF00) | (d[i] & 0xFF)]);
+            }
+            else
+            {
+                blend[i] = (srca << 24) | (s[i] & 0xFFFFFF);
+            }
+        }
+        CompositeRow(blend, dst + chunk, n);
+    }
+}
+
+void DrawAlphaRow(const unsigned int *src, unsigned int *dst, int count, int opacity)
+{
+    BlendSpriteRow(src, dst, count, 0, opacity);
+}
+
+void DrawAddRow(const unsigned int *src, unsigned int *dst, int count, float scale)
+{
+    int i = 0;
+#if defined(AGSBLEND_SSE2)
+    const __m128 f255 = _mm_set1_ps(255.f);
+    const __m128 fscale = _mm_set1_ps(scale);
+    const __m128 zero = _mm_setzero_ps();
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m128i s = _mm_loadu_si128((const __m128i*)(src + i));
+        const __m128i d = _mm_loadu_si128((const __m128i*)(dst + i));
+        const __m128i skip = _mm_cmpeq_epi32(_mm_srli_epi32(s, 24), _mm_setzero_si128());
+        if (_mm_movemask_epi8(skip) == 0xFFFF)
+            continue;
+
+        const __m128 srca = ChannelF(s, 24);
+        const __m128 desta = ChannelF(d, 24);
+        // if destination alpha is 0, then its color is treated as black
+        const __m128i dest_rgb = _mm_andnot_si128(
+            _mm_cmpeq_epi32(_mm_srli_epi32(d, 24), _mm_setzero_si128()), d);
+        const __m128i finala = _mm_sub_epi32(_mm_set1_epi32(255),
+            DivTrunc(_mm_mul_ps(_mm_sub_ps(f255, srca), _mm_sub_ps(f255, desta)), f255));
+
+        __m128i result = _mm_slli_epi32(finala, 24);
+        for (int shift = 0; shift <= 16; shift += 8)
+        {
+            // srcc = (int)((c * srca / 255) * scale)
+            const __m128 q = _mm_cvtepi32_ps(DivTrunc(_mm_mul_ps(ChannelF(s, shift), srca), f255));
+            const __m128 srcc = _mm_cvtepi32_ps(_mm_cvttps_epi32(_mm_mul_ps(q, fscale)));
+            const __m128 sum = _mm_add_ps(srcc, ChannelF(dest_rgb, shift));
+            const __m128i c = _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(sum, zero), f255));
+            result = _mm_or_si128(result, _mm_sll_epi32(c, _mm_cvtsi32_si128(shift)));
+        }
+
+        result = _mm_or_si128(_mm_and_si128(skip, d), _mm_andnot_si128(skip, result));
+        _mm_storeu_si128((__m128i*)(dst + i), result);
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        const int srca = (src[i] >> 24) & 0xFF;
+        if (srca == 0)
+            continue;
+        const int srcr = ((src[i] >> 16) & 0xFF) * srca / 255 * scale;
+        const int srcg = ((src[i] >> 8) & 0xFF) * srca / 255 * scale;
+        const int srcb = (src[i] & 0xFF) * srca / 255 * scale;
+        const int desta = (dst[i] >> 24) & 0xFF;
+        const int destr = desta ? (dst[i] >> 16) & 0xFF : 0;
+        const int destg = desta ? (dst[i] >> 8) & 0xFF : 0;
+        const int destb = desta ? dst[i] & 0xFF : 0;
+        const int finala = 255-(255-srca)*(255-desta)/255;
+        const int finalr = std::max(0, std::min(255, srcr + destr));
+        const int finalg = std::max(0, std::min(255, srcg + destg));
+        const int finalb = std::max(0, std::min(255, srcb + destb));
+        dst[i] = (finalr << 16) | (finalg << 8) | finalb | (finala << 24);
+    }
+}
+
+//------------------------------------------------------------------------------
+// Blur
+//------------------------------------------------------------------------------
+
+// Runs a sliding window of (radius * 2 + 1) along a row of channel values,
+// writes averages to the output; pixels outside of the row are counted as zeroes
+static void BoxFilterRow(const int *in, int *out, int count, int radius, int numofpixels)
+{
+    int total = 0;
+    for (int x = 0; x <= radius && x < count; ++x)
+        total += in[x];
+    for (int x = 0; x < count; ++x)
+    {
+        out[x] = total / numofpixels;
+        if (x - radius >= 0)
+            total -= in[x - radius];
+        if (x + radius + 1 < count)
+            total += in[x + radius + 1];
+    }
+}
+
+void BlurImage(unsigned int **rows, int width, int height, int radius)
+{
+    if (width <= 0 || height <= 0 || radius < 0)
+        return;
+
+    // NOTE: the blur premultiplies color by alpha on both passes, which does not
+    // look correct, but is kept for the sake of compatibility with existing games.
+    const int numofpixels = radius * 2 + 1;
+    const size_t plane = (size_t)width * height;
+    // Temporary image, split into channel planes: alpha, red, green, blue
+    std::vector<int> temp(plane * 4);
+    int *temp_a = &temp[0], *temp_r = temp_a + plane, *temp_g = temp_r + plane, *temp_b = temp_g + plane;
+
+    // Horizontal pass: premultiply each row and filter it into the temporary planes
+    std::vector<int> line(width * 4);
+    int *line_a = &line[0], *line_r = line_a + width, *line_g = line_r + width, *line_b = line_g + width;
+    for (int y = 0; y < height; ++y)
+    {
+        const unsigned int *row = rows[y];
+        for (int x = 0; x < width; ++x)
+        {
+            const int a = (row[x] >> 24) & 0xFF;
+            line_a[x] = a;
+            line_r[x] = ((row[x] >> 16) & 0xFF) * a / 255;
+            line_g[x] = ((row[x] >> 8) & 0xFF) * a / 255;
+            line_b[x] = (row[x] & 0xFF) * a / 255;
+        }
+        const size_t off = (size_t)y * width;
+        BoxFilterRow(line_a, temp_a + off, width, radius, numofpixels);
+        BoxFilterRow(line_r, temp_r + off, width, radius, numofpixels);
+        BoxFilterRow(line_g, temp_g + off, width, radius, numofpixels);
+        BoxFilterRow(line_b, temp_b + off, width, radius, numofpixels);
+    }
+
+    // Premultiply the intermediate result once more
+    for (size_t i = 0; i < plane; ++i)
+    {
+        temp_r[i] = temp_r[i] * temp_a[i] / 255;
+        temp_g[i] = temp_g[i] * temp_a[i] / 255;
+        temp_b[i] = temp_b[i] * temp_a[i] / 255;
+    }
+
+    // Vertical pass: keep running sums for the whole row, moving the window down,
+    // which lets process memory sequentially
+    std::vector<int> sums(width * 4, 0);
+    int *sum_a = &sums[0], *sum_r = sum_a + width, *sum_g = sum_r + width, *sum_b = sum_g + width;
+    for (int y = 0; y <= radius && y < height; ++y)
+    {
+        const size_t off = (size_t)y * width;
+        for (int x = 0; x < width; ++x)
+        {
+            sum_a[x] += temp_a[off + x];
+            sum_r[x] += temp_r[off + x];
+            sum_g[x] += temp_g[off + x];
+            sum_b[x] += temp_b[off + x];
+        }
+    }
+    for (int y = 0; y < height; ++y)
+    {
+        unsigned int *row = rows[y];
+        for (int x = 0; x < width; ++x)
+        {
+            row[x] = ((sum_r[x] / numofpixels) << 16) | ((sum_g[x] / numofpixels) << 8) |
+                (sum_b[x] / numofpixels) | ((sum_a[x] / numofpixels) << 24);
+        }
+        if (y - radius >= 0)
+        {
+            const size_t off = (size_t)(y - radius) * width;
+            for (int x = 0; x < width; ++x)
+            {
+                sum_a[x] -= temp_a[off + x];
+                sum_r[x] -= temp_r[off + x];
+                sum_g[x] -= temp_g[off + x];
+                sum_b[x] -= temp_b[off + x];
+            }
+        }
+        if (y + radius + 1 < height)
+        {
+            const size_t off = (size_t)(y + radius + 1) * width;
+            for (int x = 0; x < width; ++x)
+            {
+                sum_a[x] += temp_a[off + x];
+                sum_r[x] += temp_r[off + x];
+                sum_g[x] += temp_g[off + x];
+                sum_b[x] += temp_b[off + x];
+            }
+        }
+    }
+}
+
+#if defined(BUILTIN_PLUGINS)
+} // namespace agsblend
+#endif
@@ -0,0 +1,103 @@
+/***********************************************************
+ * AGSBlend                                                *
+ *                                                         *
+ * Description: Row kernels for blending and blurring      *
+ *              32-bit ARGB pixels, independent of the     *
+ *              plugin API, so they may be tested alone.   *
+ *                                                         *
+ ***********************************************************/
+
+#ifndef AGS_BLEND_KERNELS_H
+#define AGS_BLEND_KERNELS_H
+
+#include <algorithm>
+
+#if defined(BUILTIN_PLUGINS)
+namespace agsblend {
+#endif
+
+typedef unsigned char uint8;
+
+#define BLEND_ABS(a)                 ((a)<0 ? -(a) : (a))
+#define ChannelBlend_Normal(B,L)     ((uint8)(B))
+#define ChannelBlend_Lighten(B,L)    ((uint8)((L > B) ? L:B))
+#define ChannelBlend_Darken(B,L)     ((uint8)((L > B) ? B:L))
+#define ChannelBlend_Multiply(B,L)   ((uint8)((B * L) / 255))
+#define ChannelBlend_Average(B,L)    ((uint8)((B + L) / 2))
+#define ChannelBlend_Add(B,L)        ((uint8)(std::min(255, (B + L))))
+#define ChannelBlend_Subtract(B,L)   ((uint8)((B + L < 255) ? 0:(B + L - 255)))
+#define ChannelBlend_Difference(B,L) ((uint8)(BLEND_ABS(B - L)))
+#define ChannelBlend_Negation(B,L)   ((uint8)(255 - BLEND_ABS(255 - B - L)))
+#define ChannelBlend_Screen(B,L)     ((uint8)(255 - (((255 - B) * (255 - L)) >> 8)))
+#define ChannelBlend_Exclusion(B,L)  ((uint8)(B + L - 2 * B * L / 255))
+#define ChannelBlend_Overlay(B,L)    ((uint8)((L < 128) ? (2 * B * L / 255):(255 - 2 * (255 - B) * (255 - L) / 255)))
+#define ChannelBlend_SoftLight(B,L)  ((uint8)((L < 128)?(2*((B>>1)+64))*((float)L/255):(255-(2*(255-((B>>1)+64))*(float)(255-L)/255))))
+#define ChannelBlend_HardLight(B,L)  (ChannelBlend_Overlay(L,B))
+#define ChannelBlend_ColorDodge(B,L) ((uint8)((L == 255) ? L:std::min(255, ((B << 8 ) / (255 - L)))))
+#define ChannelBlend_ColorBurn(B,L)  ((uint8)((L == 0) ? L:std::max(0, (255 - ((255 - B) << 8 ) / L))))
+#define ChannelBlend_LinearDodge(B,L)(ChannelBlend_Add(B,L))
+#define ChannelBlend_LinearBurn(B,L) (ChannelBlend_Subtract(B,L))
+#define ChannelBlend_LinearLight(B,L)((uint8)(L < 128)?ChannelBlend_LinearBurn(B,(2 * L)):ChannelBlend_LinearDodge(B,(2 * (L - 128))))
+#define ChannelBlend_VividLight(B,L) ((uint8)(L < 128)?ChannelBlend_ColorBurn(B,(2 * L)):ChannelBlend_ColorDodge(B,(2 * (L - 128))))
+#define ChannelBlend_PinLight(B,L)   ((uint8)(L < 128)?ChannelBlend_Darken(B,(2 * L)):ChannelBlend_Lighten(B,(2 * (L - 128))))
+#define ChannelBlend_HardMix(B,L)    ((uint8)((ChannelBlend_VividLight(B,L) < 128) ? 0:255))
+#define ChannelBlend_Reflect(B,L)    ((uint8)((L == 255) ? L:std::min(255, (B * B / (255 - L)))))
+#define ChannelBlend_Glow(B,L)       (ChannelBlend_Reflect(L,B))
+#define ChannelBlend_Phoenix(B,L)    ((uint8)(std::min(B,L) - std::max(B,L) + 255))
+#define ChannelBlend_Alpha(B,L,O)    ((uint8)(O * B + (1 - O) * L))
+#define ChannelBlend_AlphaF(B,L,F,O) (ChannelBlend_Alpha(F(B,L),B,O))
+
+// Number of blend modes supported by DrawSprite
+const int kNumBlendModes = 24;
+
+// Blends a single color channel of the sprite (src) with destination (dst)
+// using the given mode; unknown modes act as the "normal" one
+inline int ChannelBlend(int mode, int src, int dst)
+{
+    switch (mode)
+    {
+    case 1: return ChannelBlend_Lighten(src, dst);
+    case 2: return ChannelBlend_Darken(src, dst);
+    case 3: return ChannelBlend_Multiply(src, dst);
+    case 4: return ChannelBlend_Add(src, dst);
+    case 5: return ChannelBlend_Subtract(src, dst);
+    case 6: return ChannelBlend_Difference(src, dst);
+    case 7: return ChannelBlend_Negation(src, dst);
+    case 8: return ChannelBlend_Screen(src, dst);
+    case 9: return ChannelBlend_Exclusion(src, dst);
+    case 10: return ChannelBlend_Overlay(src, dst);
+    case 11: return ChannelBlend_SoftLight(src, dst);
+    case 12: return ChannelBlend_HardLight(src, dst);
+    case 13: return ChannelBlend_ColorDodge(src, dst);
+    case 14: return ChannelBlend_ColorBurn(src, dst);
+    case 15: return ChannelBlend_LinearDodge(src, dst);
+    case 16: return ChannelBlend_LinearBurn(src, dst);
+    case 17: return ChannelBlend_LinearLight(src, dst);
+    case 18: return ChannelBlend_VividLight(src, dst);
+    case 19: return ChannelBlend_PinLight(src, dst);
+    case 20: return ChannelBlend_HardMix(src, dst);
+    case 21: return ChannelBlend_Reflect(src, dst);
+    case 22: return ChannelBlend_Glow(src, dst);
+    case 23: return ChannelBlend_Phoenix(src, dst);
+    default: return ChannelBlend_Normal(src, dst);
+    }
+}
+
+// Blends a row of sprite pixels onto the destination row, using the given
+// blend mode and opacity (0-100), as done by DrawSprite
+void BlendSpriteRow(const unsigned int *src, unsigned int *dst, int count, int mode, int opacity);
+// Alpha blends a row of sprite pixels onto the destination row, using the given
+// opacity (0-100), as done by DrawAlpha
+void DrawAlphaRow(const unsigned int *src, unsigned int *dst, int count, int opacity);
+// Adds a row of sprite pixels, premultiplied by their alpha and scale,
+// to the destination row, as done by DrawAdd
+void DrawAddRow(const unsigned int *src, unsigned int *dst, int count, float scale);
+// Applies box blur of the given radius to the image, in place;
+// the image is given as an array of rows
+void BlurImage(unsigned int **rows, int width, int height, int radius);
+
+#if defined(BUILTIN_PLUGINS)
+} // namespace agsblend
+#endif
+
+#endif // AGS_BLEND_KERNELS_H
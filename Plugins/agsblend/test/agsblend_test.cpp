@@ -0,0 +1,406 @@
+/***********************************************************
+ * AGSBlend                                                *
+ *                                                         *
+ * Description: Standalone test and benchmark for the      *
+ *              blending kernels. Compares kernels with    *
+ *              the reference per-pixel implementation,    *
+ *              then measures their speed.                 *
+ *                                                         *
+ * Usage: agsblend_test [-nobench]                         *
+ *                                                         *
+ ***********************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <random>
+#include <vector>
+#include "../agsblend/blendkernels.h"
+
+#if defined(BUILTIN_PLUGINS)
+using namespace agsblend;
+#endif
+
+//------------------------------------------------------------------------------
+// Reference implementation: the original per-pixel plugin code
+//------------------------------------------------------------------------------
+
+static int getr32(int c) { return ((c >> 16) & 0xFF); }
+static int getg32(int c) { return ((c >> 8) & 0xFF); }
+static int getb32(int c) { return ((c >> 0) & 0xFF); }
+static int geta32(int c) { return ((c >> 24) & 0xFF); }
+static int makeacol32(int r, int g, int b, int a) { return ((r << 16) | (g << 8) | (b << 0) | (a << 24)); }
+static int Clamp(int val, int min, int max) { return val < min ? min : (val > max ? max : val); }
+
+static void RefDrawSprite(const unsigned int *src, unsigned int *dst, int count, int DrawMode, int trans)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        int srca = geta32(src[i]);
+        if (srca == 0)
+            continue;
+        srca = srca * trans / 100;
+        int srcr = getr32(src[i]), srcg = getg32(src[i]), srcb = getb32(src[i]);
+        int destr = getr32(dst[i]), destg = getg32(dst[i]), destb = getb32(dst[i]), desta = geta32(dst[i]);
+        int finalr = ChannelBlend(DrawMode, srcr, destr);
+        int finalg = ChannelBlend(DrawMode, srcg, destg);
+        int finalb = ChannelBlend(DrawMode, srcb, destb);
+        int finala = 255-(255-srca)*(255-desta)/255;
+        if (finala == 0)
+            continue; // the original code would fail with division by zero here
+        finalr = srca*finalr/finala + desta*destr*(255-srca)/finala/255;
+        finalg = srca*finalg/finala + desta*destg*(255-srca)/finala/255;
+        finalb = srca*finalb/finala + desta*destb*(255-srca)/finala/255;
+        dst[i] = makeacol32(finalr, finalg, finalb, finala);
+    }
+}
+
+static void RefDrawAlpha(const unsigned int *src, unsigned int *dst, int count, int trans)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        int srca = geta32(src[i]) * trans / 100;
+        if (srca == 0)
+            continue;
+        int srcr = getr32(src[i]), srcg = getg32(src[i]), srcb = getb32(src[i]);
+        int destr = getr32(dst[i]), destg = getg32(dst[i]), destb = getb32(dst[i]), desta = geta32(dst[i]);
+        int finala = 255-(255-srca)*(255-desta)/255;
+        int finalr = srca*srcr/finala + desta*destr*(255-srca)/finala/255;
+        int finalg = srca*srcg/finala + desta*destg*(255-srca)/finala/255;
+        int finalb = srca*srcb/finala + desta*destb*(255-srca)/finala/255;
+        dst[i] = makeacol32(finalr, finalg, finalb, finala);
+    }
+}
+
+static void RefDrawAdd(const unsigned int *src, unsigned int *dst, int count, float scale)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        int srca = geta32(src[i]);
+        if (srca == 0)
+            continue;
+        int srcr = getr32(src[i]) * srca / 255 * scale;
+        int srcg = getg32(src[i]) * srca / 255 * scale;
+        int srcb = getb32(src[i]) * srca / 255 * scale;
+        int desta = geta32(dst[i]);
+        int destr = 0, destg = 0, destb = 0;
+        if (desta != 0)
+        {
+            destr = getr32(dst[i]); destg = getg32(dst[i]); destb = getb32(dst[i]);
+        }
+        int finala = 255-(255-srca)*(255-desta)/255;
+        int finalr = Clamp(srcr + destr, 0, 255);
+        int finalg = Clamp(srcg + destg, 0, 255);
+        int finalb = Clamp(srcb + destb, 0, 255);
+        dst[i] = makeacol32(finalr, finalg, finalb, finala);
+    }
+}
+
+struct Pixel32 { int Red = 0, Green = 0, Blue = 0, Alpha = 0; };
+
+static int xytolocale(int x, int y, int width) { return (y * width + x); }
+
+static void RefBlur(std::vector<unsigned int> &image, int srcWidth, int srcHeight, int radius)
+{
+    int negrad = -1 * radius;
+    std::vector<Pixel32> Pixels((srcWidth + (radius * 2)) * (srcHeight + (radius * 2)));
+    std::vector<Pixel32> Dest((srcWidth + (radius * 2)) * (srcHeight + (radius * 2)));
+    std::vector<Pixel32> Temp((srcWidth + (radius * 2)) * (srcHeight + (radius * 2)));
+    int arraywidth = srcWidth + (radius * 2);
+
+    for (int y = 0; y < srcHeight; y++)
+    {
+        for (int x = 0; x < srcWidth; x++)
+        {
+            int locale = xytolocale(x + radius, y + radius, arraywidth);
+            const int c = image[y * srcWidth + x];
+            Pixels[locale].Red = getr32(c);
+            Pixels[locale].Green = getg32(c);
+            Pixels[locale].Blue = getb32(c);
+            Pixels[locale].Alpha = geta32(c);
+        }
+    }
+
+    int numofpixels = (radius * 2 + 1);
+    for (int y = 0; y < srcHeight; y++)
+    {
+        int totalr = 0, totalg = 0, totalb = 0, totala = 0;
+        for (int kx = negrad; kx <= radius; kx++)
+        {
+            int locale = xytolocale(kx + radius, y + radius, arraywidth);
+            totala += Pixels[locale].Alpha;
+            totalr += (Pixels[locale].Red * Pixels[locale].Alpha) / 255;
+            totalg += (Pixels[locale].Green * Pixels[locale].Alpha) / 255;
+            totalb += (Pixels[locale].Blue * Pixels[locale].Alpha) / 255;
+        }
+        int locale = xytolocale(radius, y + radius, arraywidth);
+        Temp[locale].Red = totalr / numofpixels;
+        Temp[locale].Green = totalg / numofpixels;
+        Temp[locale].Blue = totalb / numofpixels;
+        Temp[locale].Alpha = totala / numofpixels;
+        for (int x = 1; x < srcWidth; x++)
+        {
+            int locale = xytolocale(x - 1, y + radius, arraywidth);
+            totala -= Pixels[locale].Alpha;
+            totalr -= (Pixels[locale].Red * Pixels[locale].Alpha) / 255;
+            totalg -= (Pixels[locale].Green * Pixels[locale].Alpha) / 255;
+            totalb -= (Pixels[locale].Blue * Pixels[locale].Alpha) / 255;
+            locale = xytolocale(x + radius + radius, y + radius, arraywidth);
+            totala += Pixels[locale].Alpha;
+            totalr += (Pixels[locale].Red * Pixels[locale].Alpha) / 255;
+            totalg += (Pixels[locale].Green * Pixels[locale].Alpha) / 255;
+            totalb += (Pixels[locale].Blue * Pixels[locale].Alpha) / 255;
+            locale = xytolocale(x + radius, y + radius, arraywidth);
+            Temp[locale].Red = totalr / numofpixels;
+            Temp[locale].Green = totalg / numofpixels;
+            Temp[locale].Blue = totalb / numofpixels;
+            Temp[locale].Alpha = totala / numofpixels;
+        }
+    }
+
+    for (int x = 0; x < srcWidth; x++)
+    {
+        int totalr = 0, totalg = 0, totalb = 0, totala = 0;
+        for (int ky = negrad; ky <= radius; ky++)
+        {
+            int locale = xytolocale(x + radius, ky + radius, arraywidth);
+            totala += Temp[locale].Alpha;
+            totalr += (Temp[locale].Red * Temp[locale].Alpha) / 255;
+            totalg += (Temp[locale].Green * Temp[locale].Alpha) / 255;
+            totalb += (Temp[locale].Blue * Temp[locale].Alpha) / 255;
+        }
+        int locale = xytolocale(x + radius, radius, arraywidth);
+        Dest[locale].Red = totalr / numofpixels;
+        Dest[locale].Green = totalg / numofpixels;
+        Dest[locale].Blue = totalb / numofpixels;
+        Dest[locale].Alpha = totala / numofpixels;
+        for (int y = 1; y < srcHeight; y++)
+        {
+            int locale = xytolocale(x + radius, y - 1, arraywidth);
+            totala -= Temp[locale].Alpha;
+            totalr -= (Temp[locale].Red * Temp[locale].Alpha) / 255;
+            totalg -= (Temp[locale].Green * Temp[locale].Alpha) / 255;
+            totalb -= (Temp[locale].Blue * Temp[locale].Alpha) / 255;
+            locale = xytolocale(x + radius, y + radius + radius, arraywidth);
+            totala += Temp[locale].Alpha;
+            totalr += (Temp[locale].Red * Temp[locale].Alpha) / 255;
+            totalg += (Temp[locale].Green * Temp[locale].Alpha) / 255;
+            totalb += (Temp[locale].Blue * Temp[locale].Alpha) / 255;
+            locale = xytolocale(x + radius, y + radius, arraywidth);
+            Dest[locale].Red = totalr / numofpixels;
+            Dest[locale].Green = totalg / numofpixels;
+            Dest[locale].Blue = totalb / numofpixels;
+            Dest[locale].Alpha = totala / numofpixels;
+        }
+    }
+
+    for (int y = 0; y < srcHeight; y++)
+    {
+        for (int x = 0; x < srcWidth; x++)
+        {
+            int locale = xytolocale(x + radius, y + radius, arraywidth);
+            const Pixel32 &d = Dest[locale];
+            image[y * srcWidth + x] = makeacol32(d.Red, d.Green, d.Blue, d.Alpha);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+// Test helpers
+//------------------------------------------------------------------------------
+
+static std::mt19937 Rng(12345);
+
+// Generates a random image, with a share of fully transparent and opaque pixels
+static std::vector<unsigned int> MakeImage(int width, int height)
+{
+    std::vector<unsigned int> image((size_t)width * height);
+    for (auto &px : image)
+    {
+        px = Rng();
+        switch (Rng() % 4)
+        {
+        case 0: px &= 0x00FFFFFF; break;
+        case 1: px |= 0xFF000000; break;
+        default: break;
+        }
+    }
+    return image;
+}
+
+static std::vector<unsigned int*> GetRows(std::vector<unsigned int> &image, int width, int height)
+{
+    std::vector<unsigned int*> rows(height);
+    for (int y = 0; y < height; ++y)
+        rows[y] = &image[(size_t)y * width];
+    return rows;
+}
+
+static int Failures = 0;
+
+static void Check(const std::vector<unsigned int> &expect, const std::vector<unsigned int> &actual, const char *what)
+{
+    for (size_t i = 0; i < expect.size(); ++i)
+    {
+        if (expect[i] != actual[i])
+        {
+            printf("FAILED: %s: pixel %zu, expected %08X, got %08X\n", what, i, expect[i], actual[i]);
+            Failures++;
+            return;
+        }
+    }
+}
+
+template <typename TFunc>
+static double Measure(TFunc fn, int iterations)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i)
+        fn();
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count() / iterations;
+}
+
+//------------------------------------------------------------------------------
+// Tests
+//------------------------------------------------------------------------------
+
+static void TestBlendModes()
+{
+    const int width = 259; // odd size, to test the remainder of vectorized loops
+    const std::vector<unsigned int> src = MakeImage(width, 1);
+    const std::vector<unsigned int> dst = MakeImage(width, 1);
+    const int opacities[] = { 1, 33, 50, 99, 100, 150, -20 };
+    char what[64];
+    for (int mode = -1; mode <= kNumBlendModes; ++mode)
+    {
+        for (int opacity : opacities)
+        {
+            std::vector<unsigned int> expect = dst, actual = dst;
+            RefDrawSprite(src.data(), expect.data(), width, (mode < 0 || mode >= kNumBlendModes) ? 0 : mode, opacity);
+            BlendSpriteRow(src.data(), actual.data(), width, mode, opacity);
+            snprintf(what, sizeof(what), "DrawSprite mode %d, opacity %d", mode, opacity);
+            Check(expect, actual, what);
+        }
+    }
+}
+
+static void TestDrawAlpha()
+{
+    const int width = 1027;
+    const std::vector<unsigned int> src = MakeImage(width, 1);
+    const std::vector<unsigned int> dst = MakeImage(width, 1);
+    char what[64];
+    for (int opacity = 0; opacity <= 100; ++opacity)
+    {
+        std::vector<unsigned int> expect = dst, actual = dst;
+        RefDrawAlpha(src.data(), expect.data(), width, opacity);
+        DrawAlphaRow(src.data(), actual.data(), width, opacity);
+        snprintf(what, sizeof(what), "DrawAlpha opacity %d", opacity);
+        Check(expect, actual, what);
+    }
+
+    // Exhaustive test of alpha and color combinations
+    std::vector<unsigned int> src_all, dst_all;
+    for (unsigned int sa = 1; sa < 256; ++sa)
+        for (unsigned int da = 0; da < 256; da += 3)
+            for (unsigned int c = 0; c < 256; c += 5)
+            {
+                src_all.push_back((sa << 24) | (c << 16) | ((255 - c) << 8) | (c / 2));
+                dst_all.push_back((da << 24) | ((255 - c) << 16) | (c << 8) | 255);
+            }
+    std::vector<unsigned int> expect = dst_all, actual = dst_all;
+    RefDrawAlpha(src_all.data(), expect.data(), (int)src_all.size(), 100);
+    DrawAlphaRow(src_all.data(), actual.data(), (int)src_all.size(), 100);
+    Check(expect, actual, "DrawAlpha all alpha combinations");
+}
+
+static void TestDrawAdd()
+{
+    const int width = 1027;
+    const std::vector<unsigned int> src = MakeImage(width, 1);
+    const std::vector<unsigned int> dst = MakeImage(width, 1);
+    const float scales[] = { 0.f, 0.1f, 0.5f, 1.f, 1.337f, 2.f, 10.f, -0.5f };
+    char what[64];
+    for (float scale : scales)
+    {
+        std::vector<unsigned int> expect = dst, actual = dst;
+        RefDrawAdd(src.data(), expect.data(), width, scale);
+        DrawAddRow(src.data(), actual.data(), width, scale);
+        snprintf(what, sizeof(what), "DrawAdd scale %f", scale);
+        Check(expect, actual, what);
+    }
+}
+
+static void TestBlur()
+{
+    const int sizes[][2] = { { 1, 1 }, { 7, 3 }, { 64, 48 }, { 127, 65 } };
+    const int radii[] = { 0, 1, 2, 5, 40, 200 };
+    char what[64];
+    for (const auto &size : sizes)
+    {
+        for (int radius : radii)
+        {
+            const int width = size[0], height = size[1];
+            std::vector<unsigned int> expect = MakeImage(width, height);
+            std::vector<unsigned int> actual = expect;
+            RefBlur(expect, width, height, radius);
+            BlurImage(GetRows(actual, width, height).data(), width, height, radius);
+            snprintf(what, sizeof(what), "Blur %dx%d radius %d", width, height, radius);
+            Check(expect, actual, what);
+        }
+    }
+}
+
+static void Benchmark()
+{
+    const int width = 1280, height = 720, iterations = 10;
+    const size_t count = (size_t)width * height;
+    const std::vector<unsigned int> src = MakeImage(width, height);
+    const std::vector<unsigned int> dst = MakeImage(width, height);
+    std::vector<unsigned int> buf = dst;
+
+    printf("Benchmark on %dx%d, ms per call (reference / kernel):\n", width, height);
+    const int modes[] = { 0, 3, 8, 11, 18 };
+    for (int mode : modes)
+    {
+        const double ref = Measure([&]() { buf = dst; RefDrawSprite(src.data(), buf.data(), (int)count, mode, 80); }, iterations);
+        const double ker = Measure([&]() { buf = dst; BlendSpriteRow(src.data(), buf.data(), (int)count, mode, 80); }, iterations);
+        printf("  DrawSprite mode %-2d %8.3f / %8.3f\n", mode, ref, ker);
+    }
+    {
+        const double ref = Measure([&]() { buf = dst; RefDrawAlpha(src.data(), buf.data(), (int)count, 80); }, iterations);
+        const double ker = Measure([&]() { buf = dst; DrawAlphaRow(src.data(), buf.data(), (int)count, 80); }, iterations);
+        printf("  DrawAlpha          %8.3f / %8.3f\n", ref, ker);
+    }
+    {
+        const double ref = Measure([&]() { buf = dst; RefDrawAdd(src.data(), buf.data(), (int)count, 0.75f); }, iterations);
+        const double ker = Measure([&]() { buf = dst; DrawAddRow(src.data(), buf.data(), (int)count, 0.75f); }, iterations);
+        printf("  DrawAdd            %8.3f / %8.3f\n", ref, ker);
+    }
+    const int radii[] = { 2, 16 };
+    for (int radius : radii)
+    {
+        const double ref = Measure([&]() { buf = dst; RefBlur(buf, width, height, radius); }, iterations);
+        const double ker = Measure([&]() { buf = dst; BlurImage(GetRows(buf, width, height).data(), width, height, radius); }, iterations);
+        printf("  Blur radius %-2d     %8.3f / %8.3f\n", radius, ref, ker);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    TestBlendModes();
+    TestDrawAlpha();
+    TestDrawAdd();
+    TestBlur();
+    if (Failures > 0)
+    {
+        printf("%d test(s) failed\n", Failures);
+        return 1;
+    }
+    printf("All tests passed\n");
+
+    if (argc < 2 || strcmp(argv[1], "-nobench") != 0)
+        Benchmark();
+    return 0;
+}
@@ -2102,6 +2102,7 @@ void AGS_EngineShutdown() {
   // we should delete them here
 	delete [] Reflection.Characters;
 	delete [] Reflection.Objects;
+	Raycast_StopWorkers ();
 	//QuitCleanup ();
 }
 
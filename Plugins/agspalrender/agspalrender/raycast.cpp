@@ -30,6 +30,14 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <algorithm>
 #include <stdio.h>
 #include <math.h>
+#include <string.h>
+#if !defined(AGS_DISABLE_THREADS)
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#endif
 
 #if defined(BUILTIN_PLUGINS)
 namespace agspalrender {
@@ -81,6 +89,7 @@ namespace agspalrender {
  unsigned char **transalphabuffer;
  double **transzbuffer;
  bool *transslicedrawn;
+ int *transwallcounts;
  int *transwallblendmode;
  double **ZBuffer;
  double *distTable;
@@ -765,8 +774,10 @@ void Init_Raycaster ()
 	transalphabuffer = new unsigned char*[sWidth];
 	transslicedrawn = new bool[sWidth]();
 	transzbuffer = new double*[sWidth];
-	transwallblendmode = new int [mapWidth]();
+	transwallcounts = new int [sWidth]();
+	transwallblendmode = new int [sWidth*mapWidth]();
 	ZBuffer = new double*[sWidth];
+	ZBuffer[0] = new double [sWidth*sHeight]();
 	distTable = new double[sHeight+(sHeight>>1)];
 	interactionmap = new short[sWidth*sHeight]();
 	for (int y=0;y<sHeight+(sHeight>>1);y++)
@@ -778,54 +789,161 @@ void Init_Raycaster ()
 	  transcolorbuffer[x] = new unsigned char [sHeight*(mapWidth)]();
 	  transalphabuffer[x] = new unsigned char [sHeight*(mapWidth)]();
 	  transzbuffer[x] = new double [sHeight*(mapWidth)]();
-	  ZBuffer[x] = new double [sHeight]();
+	  ZBuffer[x] = ZBuffer[0] + x*sHeight;
 	  transslicedrawn [x] = false;
 	}
 }
 
-bool rendering;
-void Raycast_Render (int slot)
+// Results of the column rendering which are shared by all columns; each
+// rendering thread accumulates its own, and they are merged once all are done.
+struct ColumnSlice
 {
-	ambientweight = 0;
-	raycastOn = true;
-	double playerrad = atan2 (dirY,dirX)+(2.0 * PI);
-	rendering=true;
-	int32 w=sWidth,h=sHeight;
-	BITMAP *screen = engine->GetSpriteGraphic (slot);
-	if (!screen) engine->AbortGame ("Raycast_Render: No valid sprite to draw on.");
-	engine->GetBitmapDimensions (screen,&w,&h,nullptr);
-	BITMAP *sbBm = engine->GetSpriteGraphic (skybox);
-	if (!sbBm) engine->AbortGame ("Raycast_Render: No valid skybox sprite.");
-	if (skybox > 0)
+	int ambientweight;
+	unsigned char seen[mapWidth][mapHeight];
+};
+
+#if !defined(AGS_DISABLE_THREADS)
+// A pool of threads which render the columns along with the caller's thread.
+// Threads are kept alive between frames and woken for each Run call.
+class ColumnWorkers
+{
+public:
+	ColumnWorkers (int count)
+	{
+		for (int i = 0; i < count; i++)
+			threads.emplace_back (&ColumnWorkers::Loop, this, i + 1);
+	}
+
+	~ColumnWorkers ()
 	{
-		int bgdeg = (int)((playerrad / PI) * 180.0)+180;
-		int xoffset = (int)(playerrad*320.0);
-		BITMAP *virtsc = engine->GetVirtualScreen ();
-		engine->SetVirtualScreen (screen);
-		xoffset = abs(xoffset % w);
-		if (xoffset > 0)
 		{
-			engine->BlitBitmap (xoffset-320,1,sbBm,false);
+			std::lock_guard<std::mutex> lk (mutex);
+			quit = true;
 		}
-		engine->BlitBitmap (xoffset,1,sbBm,false);
-		engine->SetVirtualScreen (virtsc);
+		wake.notify_all ();
+		for (auto &t : threads) t.join ();
 	}
-	int transwallcount = 0;
-	unsigned char** buffer = engine->GetRawBitmapSurface (screen);
-	for (int x = 0;x<w;x++)
+
+	int GetCount () const { return (int)threads.size (); }
+
+	// Calls job(0) on the calling thread and job(1..count) on the workers,
+	// and returns when all of them have finished.
+	void Run (const std::function<void(int)> &job)
 	{
-		transslicedrawn [x] = false;
-		for (int y=0;y<h;y++)
 		{
-			ZBuffer[x][y] = 0;
+			std::lock_guard<std::mutex> lk (mutex);
+			curjob = &job;
+			pending = (int)threads.size ();
+			generation++;
 		}
+		wake.notify_all ();
+		job (0);
+		std::unique_lock<std::mutex> lk (mutex);
+		done.wait (lk, [this]() { return pending == 0; });
+		curjob = nullptr;
 	}
-	int multiplier = mapWidth;
-	memset (interactionmap,0,sizeof(short)*(sHeight*sWidth));
-  //start the main loop
-    for(int x = 0; x < w; x++)
-    {
-	  transwallcount=0;
+
+private:
+	void Loop (int index)
+	{
+		unsigned lastgen = 0;
+		for (;;)
+		{
+			const std::function<void(int)> *job;
+			{
+				std::unique_lock<std::mutex> lk (mutex);
+				wake.wait (lk, [&]() { return quit || generation != lastgen; });
+				if (quit) return;
+				lastgen = generation;
+				job = curjob;
+			}
+			(*job) (index);
+			std::lock_guard<std::mutex> lk (mutex);
+			if (--pending == 0) done.notify_one ();
+		}
+	}
+
+	std::vector<std::thread> threads;
+	std::mutex mutex;
+	std::condition_variable wake;
+	std::condition_variable done;
+	const std::function<void(int)> *curjob = nullptr;
+	unsigned generation = 0;
+	int pending = 0;
+	bool quit = false;
+};
+
+// Maximal number of threads used for rendering, including the caller's one
+#define MAX_RENDER_THREADS 8
+// Number of adjacent columns handed to a thread at once; kept wide so that
+// threads rarely write into the same cache line of a surface row
+#define COLUMN_CHUNK 32
+
+ColumnWorkers *columnworkers = nullptr;
+bool columnworkers_init = false;
+
+void Raycast_StopWorkers ()
+{
+	delete columnworkers;
+	columnworkers = nullptr;
+	columnworkers_init = false;
+}
+#else
+void Raycast_StopWorkers () {}
+#endif
+
+static void Raycast_RenderColumn (int x, int w, int h, unsigned char **buffer, ColumnSlice &slice);
+
+// Renders all the screen columns, splitting them among the worker threads,
+// then merges the per-thread results in a fixed order.
+static void Raycast_RenderColumns (unsigned char **buffer, int w, int h)
+{
+	std::vector<ColumnSlice> slices (1); // value-initialized, i.e. zeroed
+#if !defined(AGS_DISABLE_THREADS)
+	if (!columnworkers_init)
+	{
+		columnworkers_init = true;
+		int numthreads = std::min ((int)std::thread::hardware_concurrency (), MAX_RENDER_THREADS);
+		if (numthreads > 1) columnworkers = new ColumnWorkers (numthreads - 1);
+	}
+	if (columnworkers && w > COLUMN_CHUNK)
+	{
+		slices.resize (columnworkers->GetCount () + 1);
+		std::atomic<int> nextcolumn (0);
+		columnworkers->Run ([&](int index)
+		{
+			ColumnSlice &slice = slices[index];
+			for (int start = nextcolumn.fetch_add (COLUMN_CHUNK); start < w; start = nextcolumn.fetch_add (COLUMN_CHUNK))
+			{
+				int end = std::min (start + COLUMN_CHUNK, w);
+				for (int x = start; x < end; x++)
+					Raycast_RenderColumn (x, w, h, buffer, slice);
+			}
+		});
+	}
+	else
+#endif
+	{
+		for (int x = 0; x < w; x++)
+			Raycast_RenderColumn (x, w, h, buffer, slices[0]);
+	}
+
+	for (const ColumnSlice &slice : slices)
+	{
+		ambientweight += slice.ambientweight;
+		for (int i = 0; i < mapWidth; i++)
+			for (int j = 0; j < mapHeight; j++)
+				seenMap[i][j] |= slice.seen[i][j];
+	}
+}
+
+// Casts the ray for a single screen column and draws the walls, floor and
+// ceiling into it. Only touches the column's own pixels and buffers, so that
+// the columns may be rendered by several threads at once; the shared results
+// (ambient weight and seen tiles) are accumulated in the given slice instead.
+static void Raycast_RenderColumn (int x, int w, int h, unsigned char **buffer, ColumnSlice &slice)
+{
+      int transwallcount = 0;
       //calculate ray position and direction 
       double cameraX = 2 * x / double(w) - 1; //x-coordinate in camera space     
       double rayPosX = posX;
@@ -946,7 +1064,7 @@ void Raycast_Render (int slot)
 		if (rayDirY < 0 && side == 1) texside = 3;
 
 		//set this tile as seen.
-		seenMap[mapX][mapY] = 1;
+		slice.seen[mapX][mapY] = 1;
         //Check if ray has hit a wall       
 		if (wallData[worldMap[mapX][mapY]].texture[texside])
 		{
@@ -1056,7 +1174,7 @@ void Raycast_Render (int slot)
 							if (wallData[worldMap[mapX][mapY]].alpha[texside] == 255 && wallData[worldMap[mapX][mapY]].mask[texside] == 0)
 							{
 							buffer[y][x] = color;
-							if (ambientpixels) ambientweight++;
+							if (ambientpixels) slice.ambientweight++;
 							//SET THE ZBUFFER FOR THE SPRITE CASTING
 							ZBuffer[x][y] = perpWallDist; //perpendicular distance is used
 							interactionmap [x*sWidth+y] = wallData[worldMap[mapX][mapY]].hotspotinteract;
@@ -1071,10 +1189,10 @@ void Raycast_Render (int slot)
 									//memset (transzbuffer[x],0,sizeof(double)*(sHeight*mapWidth));
 									transslicedrawn[x] = true;
 								}
-								transwallblendmode[transwallcount] = wallData[worldMap[mapX][mapY]].blendtype[texside];
+								transwallblendmode[x*mapWidth+transwallcount] = wallData[worldMap[mapX][mapY]].blendtype[texside];
 								int transwalloffset = transwallcount*h;
 								transcolorbuffer[x][transwalloffset+y] = color;
-								if (ambientpixels) ambientweight++;
+								if (ambientpixels) slice.ambientweight++;
 								if (wallData[worldMap[mapX][mapY]].mask[texside] == 0) transalphabuffer[x][transwalloffset+y] = wallData[worldMap[mapX][mapY]].alpha[texside];
 								else 
 								{
@@ -1227,7 +1345,7 @@ void Raycast_Render (int slot)
 			if (ceilingcolor == 0)
 			{
 				lighting = std::max (lighting,ambientlight);
-				ambientweight ++;
+				slice.ambientweight ++;
 			}
 			if (lighting < 255)
 			{
@@ -1284,7 +1402,7 @@ void Raycast_Render (int slot)
 			if (ceilingcolor == 0) 
 			{
 				lighting = std::max (lighting,ambientlight);
-				ambientweight++;
+				slice.ambientweight++;
 			}
 			if (lighting < 255)
 			{
@@ -1359,15 +1477,49 @@ void Raycast_Render (int slot)
 				int color = transcolorbuffer[x][transwalloffset+y];
 				if (color !=0) 
 				{
-					  if (transwallblendmode[transwalldrawn] == 0) buffer[y][x] = Mix::MixColorAlpha (color,buffer[y][x],transalphabuffer[x][transwalloffset+y]); //paint pixel if it isn't black, black is the invisible color
-					  else if (transwallblendmode[transwalldrawn] == 1) buffer[y][x] = Mix::MixColorAdditive (color,buffer[y][x],transalphabuffer[x][transwalloffset+y]);
+					  if (transwallblendmode[x*mapWidth+transwalldrawn] == 0) buffer[y][x] = Mix::MixColorAlpha (color,buffer[y][x],transalphabuffer[x][transwalloffset+y]); //paint pixel if it isn't black, black is the invisible color
+					  else if (transwallblendmode[x*mapWidth+transwalldrawn] == 1) buffer[y][x] = Mix::MixColorAdditive (color,buffer[y][x],transalphabuffer[x][transwalloffset+y]);
 					  //if (ZBuffer[x][y] > transzbuffer[transwalldrawn*h+y]) ZBuffer[x][y] = transzbuffer[transwalldrawn*h+y]; //put the sprite on the zbuffer so we can draw around it.
 			    }
 		    }
 		}
 	  }
-		//End of wall loop.
-    }
+	  transwallcounts[x] = transwallcount;
+}
+
+bool rendering;
+void Raycast_Render (int slot)
+{
+	ambientweight = 0;
+	raycastOn = true;
+	double playerrad = atan2 (dirY,dirX)+(2.0 * PI);
+	rendering=true;
+	int32 w=sWidth,h=sHeight;
+	BITMAP *screen = engine->GetSpriteGraphic (slot);
+	if (!screen) engine->AbortGame ("Raycast_Render: No valid sprite to draw on.");
+	engine->GetBitmapDimensions (screen,&w,&h,nullptr);
+	BITMAP *sbBm = engine->GetSpriteGraphic (skybox);
+	if (!sbBm) engine->AbortGame ("Raycast_Render: No valid skybox sprite.");
+	if (skybox > 0)
+	{
+		int bgdeg = (int)((playerrad / PI) * 180.0)+180;
+		int xoffset = (int)(playerrad*320.0);
+		BITMAP *virtsc = engine->GetVirtualScreen ();
+		engine->SetVirtualScreen (screen);
+		xoffset = abs(xoffset % w);
+		if (xoffset > 0)
+		{
+			engine->BlitBitmap (xoffset-320,1,sbBm,false);
+		}
+		engine->BlitBitmap (xoffset,1,sbBm,false);
+		engine->SetVirtualScreen (virtsc);
+	}
+	unsigned char** buffer = engine->GetRawBitmapSurface (screen);
+	memset (transslicedrawn,0,sizeof(bool)*sWidth);
+	memset (transwallcounts,0,sizeof(int)*sWidth);
+	memset (ZBuffer[0],0,sizeof(double)*(sWidth*sHeight));
+	memset (interactionmap,0,sizeof(short)*(sHeight*sWidth));
+	Raycast_RenderColumns (buffer,w,h);
     
 	
     //SPRITE CASTING
@@ -1491,7 +1643,7 @@ void Raycast_Render (int slot)
         {
 		  if (spriteTransformY[i] < ZBuffer[stripe][y])
 		  {
-			  if (transslicedrawn[stripe]) while ((transzbuffer[stripe][transwalldraw*h+y] > spriteTransformY[i] && transzbuffer[stripe][transwalldraw*h+y] != 0) && (transwalldraw < transwallcount)) transwalldraw++;
+			  if (transslicedrawn[stripe]) while ((transzbuffer[stripe][transwalldraw*h+y] > spriteTransformY[i] && transzbuffer[stripe][transwalldraw*h+y] != 0) && (transwalldraw < transwallcounts[stripe])) transwalldraw++;
 			int d = (y-vMoveScreen) * 256 - h * 128 + spriteHeight * 128; //256 and 128 factors to avoid floats
 			//int texY = ((d * texHeight) / spriteHeight) / 256;
 			int texY = ((d * sprh) / spriteHeight) / 256;
@@ -1508,8 +1660,8 @@ void Raycast_Render (int slot)
 				  color = Mix::MixColorLightLevel (color,spr_light);
 				  if (transzbuffer[stripe][transwalldraw*h+y] < spriteTransformY[i] && transzbuffer[stripe][transwalldraw*h+y] != 0 && transslicedrawn[stripe] && transcolorbuffer[stripe][transwalldraw*h+y] > 0 && transalphabuffer[stripe][transwalldraw*h+y]>0) 
 				  {
-					  if (transwallblendmode[transwalldraw] == 0) color = Mix::MixColorAlpha (color,transcolorbuffer[stripe][transwalldraw*h+y],transalphabuffer[stripe][transwalldraw*h+y]);
-					  else if (transwallblendmode[transwalldraw] == 1) color = Mix::MixColorAdditive (color,transcolorbuffer[stripe][transwalldraw*h+y],transalphabuffer[stripe][transwalldraw*h+y]);
+					  if (transwallblendmode[stripe*mapWidth+transwalldraw] == 0) color = Mix::MixColorAlpha (color,transcolorbuffer[stripe][transwalldraw*h+y],transalphabuffer[stripe][transwalldraw*h+y]);
+					  else if (transwallblendmode[stripe*mapWidth+transwalldraw] == 1) color = Mix::MixColorAdditive (color,transcolorbuffer[stripe][transwalldraw*h+y],transalphabuffer[stripe][transwalldraw*h+y]);
 					  buffer[y][stripe] = color;
 					  ZBuffer[stripe][y] = transzbuffer[stripe][transwalldraw*h+y];
 				  }
@@ -1535,17 +1687,19 @@ void QuitCleanup ()
 {
 		if (!rendering)
 		{
+			Raycast_StopWorkers ();
 			for(int i = 0; i < sWidth; ++i) 
 			{
 				if (transcolorbuffer[i])delete [] transcolorbuffer[i];
 				if (transalphabuffer[i])delete [] transalphabuffer[i];
 				if (transzbuffer[i])delete [] transzbuffer[i];
-				if (ZBuffer[i]) delete [] ZBuffer[i];
 			}	
+			if (ZBuffer) delete [] ZBuffer[0];
 			if (transcolorbuffer) delete [] transcolorbuffer;
 			if (transalphabuffer) delete [] transalphabuffer;
 			if (transzbuffer) delete [] transzbuffer;
 			if (ZBuffer) delete [] ZBuffer;
+			if (transwallcounts) delete [] transwallcounts;
 			if (transwallblendmode) delete [] transwallblendmode;
 			if (interactionmap) delete [] interactionmap;
 		}
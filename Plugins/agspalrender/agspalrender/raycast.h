@@ -78,6 +78,7 @@ struct Sprite
  extern unsigned char **transalphabuffer;
  extern double **transzbuffer;
  extern bool *transslicedrawn;
+ extern int *transwallcounts;
  extern int *transwallblendmode;
  extern double **ZBuffer;
  extern double *distTable;
@@ -94,6 +95,7 @@ void RotateLeft ();
 void RotateRight ();
 void Init_Raycaster ();
 void QuitCleanup ();
+void Raycast_StopWorkers ();
 void LoadMap (int worldmapSlot,int lightmapSlot,int ceilingmapSlot,int floormapSlot);
 void Ray_InitSprite (int id, SCRIPT_FLOAT(x), SCRIPT_FLOAT(y), int slot, unsigned char alpha, int blendmode, SCRIPT_FLOAT(scale_x), SCRIPT_FLOAT(scale_y), SCRIPT_FLOAT(vMove));
 void Ray_SetPlayerPosition (SCRIPT_FLOAT(x),SCRIPT_FLOAT(y));
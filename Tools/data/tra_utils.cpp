@@ -541,7 +541,7 @@ HError WriteTRS(const Translation &tra, std::unique_ptr<Stream> &&out)
 // TRA - compiled translation in a binary format
 //-----------------------------------------------------------------------------
 
-HError WriteTRA(const Translation &tra, std::unique_ptr<Stream> &&out)
+HError WriteTRA(const Translation &tra, std::unique_ptr<Stream> &&out, bool write_dict_index)
 {
     // Check if translation object is meaningful
     bool has_translation = false;
@@ -553,7 +553,7 @@ HError WriteTRA(const Translation &tra, std::unique_ptr<Stream> &&out)
         printf("WARNING: input translation did not appear to have any translated lines.\n");
 
     // Write translation
-    WriteTraData(tra, std::move(out));
+    WriteTraData(tra, std::move(out), write_dict_index);
     return HError::None();
 }
 
@@ -35,8 +35,9 @@ using AGS::Common::Translation;
 HError ReadTRS(Translation &tra, std::unique_ptr<Stream> &&in);
 // Generates a translation source file based on compiled Translation object.
 HError WriteTRS(const Translation &tra, std::unique_ptr<Stream> &&out);
-// Write a compiled translation file from Translation object.
-HError WriteTRA(const Translation &tra, std::unique_ptr<Stream> &&out);
+// Write a compiled translation file from Translation object;
+// optionally includes a precomputed dictionary index.
+HError WriteTRA(const Translation &tra, std::unique_ptr<Stream> &&out, bool write_dict_index = false);
 
 } // namespace DataUtil
 } // namespace AGS
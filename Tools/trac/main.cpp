@@ -11,10 +11,15 @@ using namespace AGS::DataUtil;
 
 //------------------------------------------------------------------------------|
 const char *HELP_STRING = "Usage:\n"
-"  trac <input.trs> [<output.tra>] [--gamename <name>][--uniqueid <idnum>]\n"
-"  trac -u <input.tra> [<output.trs>]\n";
-
-int Command_Compile(const String &src, const String &dst, const String *game_name, const int *game_uid)
+"  trac <input.trs> [<output.tra>] [--gamename <name>][--uniqueid <idnum>][--dict-index]\n"
+"  trac -u <input.tra> [<output.trs>]\n"
+"\n"
+"  --dict-index    write a precomputed dictionary index, which speeds up\n"
+"                  loading and lookups of large translations;\n"
+"                  such file may not be read by older engines\n";
+
+int Command_Compile(const String &src, const String &dst, const String *game_name, const int *game_uid,
+    bool dict_index)
 {
     printf("Input translation source: %s\n", src.GetCStr());
     printf("Output compiled translation: %s\n", dst.GetCStr());
@@ -22,6 +27,8 @@ int Command_Compile(const String &src, const String &dst, const String *game_nam
         printf("Game name: %s\n", game_name->GetCStr());
     if (game_uid)
         printf("Game uniqueid: %d\n", *game_uid);
+    if (dict_index)
+        printf("Write dictionary index: yes\n");
 
     //-----------------------------------------------------------------------//
     // Read TRS
@@ -56,7 +63,7 @@ int Command_Compile(const String &src, const String &dst, const String *game_nam
         printf("Error: failed to open output TRA for writing.\n");
         return -1;
     }
-    err = WriteTRA(tra, std::move(out));
+    err = WriteTRA(tra, std::move(out), dict_index);
     if (!err)
     {
         printf("Error: failed to compile TRA:\n");
@@ -90,6 +97,10 @@ int Command_Decompile(const String &src, const String &dst)
         printf("%s\n", err->FullMessage().GetCStr());
         return -1;
     }
+    // If the file had a dictionary index, then the regular dictionary was skipped
+    const TraDictIndex &dict_index = tra.DictIndex;
+    for (size_t i = 0; i < dict_index.GetCount(); ++i)
+        tra.Dict.insert(std::make_pair(String(dict_index.GetKey(i)), String(dict_index.GetValue(i))));
 
     //-----------------------------------------------------------------------//
     // Write TRS
@@ -142,6 +153,7 @@ int main(int argc, char *argv[])
         int game_uid = 0;
         bool use_game_uid = false;
         bool use_game_name = false;
+        bool dict_index = false;
         for (int i = 2; i < argc; ++i)
         {
             const char *arg = argv[i];
@@ -159,12 +171,16 @@ int main(int argc, char *argv[])
                 game_uid = StrUtil::StringToInt(argv[++i]);
                 use_game_uid = true;
             }
+            else if (ags_stricmp(arg, "--dict-index") == 0)
+            {
+                dict_index = true;
+            }
         }
 
         if (dst.IsEmpty())
             dst = Path::ReplaceExtension(src, "tra");
 
-        return Command_Compile(src, dst, use_game_name ? &game_name : nullptr, use_game_uid ? &game_uid : nullptr);
+        return Command_Compile(src, dst, use_game_name ? &game_name : nullptr, use_game_uid ? &game_uid : nullptr, dict_index);
     }
     else if (ags_stricmp(argv[1], "-u") == 0)
     {